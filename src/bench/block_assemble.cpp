@@ -3,11 +3,13 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <consensus/amount.h>
 #include <consensus/consensus.h>
 #include <node/miner.h>
 #include <primitives/transaction.h>
 #include <random.h>
 #include <script/script.h>
+#include <streams.h>
 #include <sync.h>
 #include <test/util/mining.h>
 #include <test/util/script.h>
@@ -21,6 +23,10 @@
 #include <vector>
 
 using node::BlockAssembler;
+using node::BlockTemplateCache;
+using node::BlockTemplateDelta;
+using node::CBlockTemplate;
+using node::GetBlockTemplateDelta;
 
 static void AssembleBlock(benchmark::Bench& bench)
 {
@@ -70,5 +76,69 @@ static void BlockAssemblerAddPackageTxns(benchmark::Bench& bench)
     });
 }
 
+static void BlockTemplateCacheUpdate(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{true};
+    auto testing_setup{MakeNoLogFileContext<TestChain100Setup>()};
+    const auto txs{testing_setup->PopulateMempool(det_rand, /*num_transactions=*/1000, /*submit=*/true)};
+    BlockAssembler::Options assembler_options;
+    assembler_options.test_block_validity = false;
+    assembler_options.coinbase_output_script = P2WSH_OP_TRUE;
+    BlockTemplateCache cache{testing_setup->m_node.chainman->ActiveChainstate(), testing_setup->m_node.mempool.get(), assembler_options};
+    assert(cache.GetBlockTemplate());
+
+    // Every iteration changes the fee of one transaction, and updates the
+    // template for it (compare with the cold build of BlockAssemblerAddPackageTxns)
+    CAmount delta{1000};
+    bench.run([&] {
+        testing_setup->m_node.mempool->PrioritiseTransaction(txs[det_rand.randrange(txs.size())]->GetHash(), delta);
+        delta = -delta;
+        assert(cache.GetBlockTemplate());
+    });
+}
+
+// Hand a template that differs from the previous one by a few transactions to
+// a client, either as the whole block or as a delta (see BlockTemplate::getDelta()).
+static void BlockTemplateTransfer(benchmark::Bench& bench, bool use_delta)
+{
+    FastRandomContext det_rand{true};
+    auto testing_setup{MakeNoLogFileContext<TestChain100Setup>()};
+    testing_setup->PopulateMempool(det_rand, /*num_transactions=*/1000, /*submit=*/true);
+    BlockAssembler::Options assembler_options;
+    assembler_options.test_block_validity = false;
+    assembler_options.coinbase_output_script = P2WSH_OP_TRUE;
+    const auto block_template{BlockAssembler{testing_setup->m_node.chainman->ActiveChainstate(), testing_setup->m_node.mempool.get(), assembler_options}.CreateNewBlock()};
+
+    // The previous template lacks the last few transactions
+    constexpr size_t NUM_CHANGED{10};
+    assert(block_template->vTxFees.size() > NUM_CHANGED);
+    CBlockTemplate previous{*block_template};
+    previous.block.vtx.resize(previous.block.vtx.size() - NUM_CHANGED);
+    previous.vTxFees.resize(previous.vTxFees.size() - NUM_CHANGED);
+    previous.vTxSigOpsCost.resize(previous.vTxSigOpsCost.size() - NUM_CHANGED);
+
+    bench.run([&] {
+        DataStream stream;
+        if (use_delta) {
+            const auto delta{GetBlockTemplateDelta(previous, *block_template)};
+            stream << delta.removed << TX_WITH_WITNESS(delta.added) << delta.added_fees << delta.added_sigops << delta.tx_order << delta.coinbase_merkle_path;
+            BlockTemplateDelta received;
+            stream >> received.removed >> TX_WITH_WITNESS(received.added) >> received.added_fees >> received.added_sigops >> received.tx_order >> received.coinbase_merkle_path;
+            assert(received.added.size() == NUM_CHANGED);
+        } else {
+            stream << TX_WITH_WITNESS(block_template->block) << block_template->vTxFees << block_template->vTxSigOpsCost;
+            CBlockTemplate received;
+            stream >> TX_WITH_WITNESS(received.block) >> received.vTxFees >> received.vTxSigOpsCost;
+            assert(received.block.vtx.size() == block_template->block.vtx.size());
+        }
+    });
+}
+
+static void BlockTemplateTransferFull(benchmark::Bench& bench) { BlockTemplateTransfer(bench, /*use_delta=*/false); }
+static void BlockTemplateTransferDelta(benchmark::Bench& bench) { BlockTemplateTransfer(bench, /*use_delta=*/true); }
+
 BENCHMARK(AssembleBlock);
 BENCHMARK(BlockAssemblerAddPackageTxns);
+BENCHMARK(BlockTemplateCacheUpdate);
+BENCHMARK(BlockTemplateTransferFull);
+BENCHMARK(BlockTemplateTransferDelta);
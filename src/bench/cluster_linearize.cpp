@@ -44,11 +44,12 @@ void BenchPostLinearizeWorstCase(DepGraphIndex ntx, benchmark::Bench& bench)
     });
 }
 
+template<typename SetType>
 void BenchLinearizeOptimallyTotal(benchmark::Bench& bench, const std::string& name, const std::vector<std::vector<uint8_t>>& serializeds)
 {
     for (const auto& serialized : serializeds) {
         SpanReader reader{serialized};
-        DepGraph<BitSet<64>> depgraph;
+        DepGraph<SetType> depgraph;
         reader >> Using<DepGraphFormatter>(depgraph);
         auto bench_name = strprintf("%s_%utx_%udep", name, depgraph.TxCount(), depgraph.CountDependencies());
 
@@ -97,6 +98,8 @@ static void PostLinearize48TxWorstCase(benchmark::Bench& bench) { BenchPostLinea
 static void PostLinearize64TxWorstCase(benchmark::Bench& bench) { BenchPostLinearizeWorstCase<BitSet<64>>(64, bench); }
 static void PostLinearize75TxWorstCase(benchmark::Bench& bench) { BenchPostLinearizeWorstCase<BitSet<75>>(75, bench); }
 static void PostLinearize99TxWorstCase(benchmark::Bench& bench) { BenchPostLinearizeWorstCase<BitSet<99>>(99, bench); }
+static void PostLinearize128TxWorstCase(benchmark::Bench& bench) { BenchPostLinearizeWorstCase<BitSet<128>>(128, bench); }
+static void PostLinearize256TxWorstCase(benchmark::Bench& bench) { BenchPostLinearizeWorstCase<BitSet<256>>(256, bench); }
 
 // Constructed from replayed historical mempool activity, selecting for clusters that are slow
 // to linearize from scratch, with increasing number of transactions (9 to 63).
@@ -140,8 +143,15 @@ static const std::vector<std::vector<uint8_t>> CLUSTERS_SYNTHETIC = {
 
 static void LinearizeOptimallyTotal(benchmark::Bench& bench)
 {
-    BenchLinearizeOptimallyTotal(bench, "LinearizeOptimallyHistoricalTotal", CLUSTERS_HISTORICAL);
-    BenchLinearizeOptimallyTotal(bench, "LinearizeOptimallySyntheticTotal", CLUSTERS_SYNTHETIC);
+    BenchLinearizeOptimallyTotal<BitSet<64>>(bench, "LinearizeOptimallyHistoricalTotal", CLUSTERS_HISTORICAL);
+    BenchLinearizeOptimallyTotal<BitSet<64>>(bench, "LinearizeOptimallySyntheticTotal", CLUSTERS_SYNTHETIC);
+}
+
+static void LinearizeOptimallyWideSetTotal(benchmark::Bench& bench)
+{
+    // The same clusters, with set types as used for larger cluster count limits.
+    BenchLinearizeOptimallyTotal<BitSet<128>>(bench, "LinearizeOptimallySyntheticTotal128", CLUSTERS_SYNTHETIC);
+    BenchLinearizeOptimallyTotal<BitSet<256>>(bench, "LinearizeOptimallySyntheticTotal256", CLUSTERS_SYNTHETIC);
 }
 
 static void LinearizeOptimallyPerCost(benchmark::Bench& bench)
@@ -156,6 +166,9 @@ BENCHMARK(PostLinearize48TxWorstCase);
 BENCHMARK(PostLinearize64TxWorstCase);
 BENCHMARK(PostLinearize75TxWorstCase);
 BENCHMARK(PostLinearize99TxWorstCase);
+BENCHMARK(PostLinearize128TxWorstCase);
+BENCHMARK(PostLinearize256TxWorstCase);
 
 BENCHMARK(LinearizeOptimallyTotal);
+BENCHMARK(LinearizeOptimallyWideSetTotal);
 BENCHMARK(LinearizeOptimallyPerCost);
@@ -88,6 +88,52 @@ static void CoinSelection(benchmark::Bench& bench)
     });
 }
 
+// Selection among many UTXOs at a feerate high enough for all algorithms to
+// run, where the knapsack solver and CoinGrinder dominate the running time.
+static void CoinSelectionManyUtxos(benchmark::Bench& bench, int threads)
+{
+    const auto test_setup = MakeNoLogFileContext<TestingSetup>();
+    CWallet wallet(test_setup->m_node.chain.get(), "", CreateMockableWalletDatabase());
+    std::vector<std::unique_ptr<CWalletTx>> wtxs;
+    LOCK(wallet.cs_wallet);
+
+    FastRandomContext rand{/*fDeterministic=*/true};
+    for (int i = 0; i < 20'000; ++i) {
+        addCoin(rand.randrange(COIN) + 10'000, wallet, wtxs);
+    }
+
+    wallet::CoinsResult available_coins;
+    for (const auto& wtx : wtxs) {
+        const auto txout = wtx->tx->vout.at(0);
+        available_coins.coins[OutputType::BECH32].emplace_back(COutPoint(wtx->GetHash(), 0), txout, /*depth=*/6 * 24, CalculateMaximumSignedInputSize(txout, &wallet, /*coin_control=*/nullptr), /*solvable=*/true, /*safe=*/true, wtx->GetTxTime(), /*from_me=*/true, /*fees=*/ 0);
+    }
+
+    const CoinEligibilityFilter filter_standard(1, 6, 0);
+    CoinSelectionParams coin_selection_params{
+        rand,
+        /*change_output_size=*/ 31,
+        /*change_spend_size=*/ 68,
+        /*min_change_target=*/ CHANGE_LOWER,
+        /*effective_feerate=*/ CFeeRate(40'000),
+        /*long_term_feerate=*/ CFeeRate(10'000),
+        /*discard_feerate=*/ CFeeRate(3000),
+        /*tx_noinputs_size=*/ 72,
+        /*avoid_partial=*/ false,
+    };
+    coin_selection_params.m_change_fee = coin_selection_params.m_effective_feerate.GetFee(coin_selection_params.change_output_size);
+    coin_selection_params.m_cost_of_change = coin_selection_params.m_discard_feerate.GetFee(coin_selection_params.change_spend_size) + coin_selection_params.m_change_fee;
+    wallet.m_coin_selection_threads = threads;
+    coin_selection_params.m_selection_pool = wallet.GetCoinSelectionPool();
+    auto group = wallet::GroupOutputs(wallet, available_coins, coin_selection_params, {{filter_standard}})[filter_standard];
+    bench.run([&] {
+        auto result = AttemptSelection(wallet.chain(), 10 * COIN, group, coin_selection_params, /*allow_mixed_output_types=*/true);
+        assert(result);
+    });
+}
+
+static void CoinSelectionManyUtxosSequential(benchmark::Bench& bench) { CoinSelectionManyUtxos(bench, /*threads=*/1); }
+static void CoinSelectionManyUtxosConcurrent(benchmark::Bench& bench) { CoinSelectionManyUtxos(bench, /*threads=*/4); }
+
 // Copied from src/wallet/test/coinselector_tests.cpp
 static void add_coin(const CAmount& nValue, int nInput, std::vector<OutputGroup>& set)
 {
@@ -123,5 +169,7 @@ static void BnBExhaustion(benchmark::Bench& bench)
 }
 
 BENCHMARK(CoinSelection);
+BENCHMARK(CoinSelectionManyUtxosSequential);
+BENCHMARK(CoinSelectionManyUtxosConcurrent);
 BENCHMARK(BnBExhaustion);
 }; // namespace wallet
@@ -0,0 +1,59 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <index/scriptindex.h>
+#include <interfaces/chain.h>
+#include <key.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+// Script index sync benchmark, over blocks that each spend a coinbase output
+// to several outputs besides their own coinbase output.
+static void ScriptIndexSync(benchmark::Bench& bench)
+{
+    const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+
+    constexpr int CHAIN_SIZE{200};
+    constexpr int OUTPUTS_PER_TX{10};
+    const CScript coinbase_script{test_setup->m_coinbase_txns[0]->vout[0].scriptPubKey};
+    const CKey key{GenerateRandomKey()};
+    // Every block spends one of the mature coinbase outputs of the setup chain
+    for (int i = 0; i < CHAIN_SIZE - 100; i++) {
+        const CTransactionRef input{test_setup->m_coinbase_txns[i]};
+        std::vector<CTxOut> outputs(OUTPUTS_PER_TX, CTxOut{COIN, GetScriptForDestination(WitnessV0KeyHash(key.GetPubKey()))});
+        const CMutableTransaction tx{test_setup->CreateValidMempoolTransaction({input}, {COutPoint{input->GetHash(), 0}}, /*input_height=*/i + 1,
+                                                                               {test_setup->coinbaseKey}, outputs, /*submit=*/false)};
+        test_setup->CreateAndProcessBlock({tx}, coinbase_script);
+        SetMockTime(GetTime() + 1);
+    }
+    assert(WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveHeight() == CHAIN_SIZE));
+
+    bench.minEpochIterations(5).run([&] {
+        ScriptIndex index(interfaces::MakeChain(test_setup->m_node), /*n_cache_size=*/0, /*f_memory=*/false, /*f_wipe=*/true);
+        assert(index.Init());
+        assert(!index.BlockUntilSyncedToCurrentChain());
+        index.Sync();
+
+        IndexSummary summary = index.GetSummary();
+        assert(summary.synced);
+        assert(summary.best_block_hash == WITH_LOCK(::cs_main, return test_setup->m_node.chainman->ActiveTip()->GetBlockHash()));
+
+        // Shutdown sequence (c.f. Shutdown() in init.cpp)
+        index.Stop();
+    });
+}
+
+BENCHMARK(ScriptIndexSync);
@@ -4,6 +4,8 @@
 
 #include <bench/bench.h>
 #include <consensus/amount.h>
+#include <consensus/validation.h>
+#include <policy/packages.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -14,9 +16,11 @@
 #include <txmempool.h>
 #include <validation.h>
 
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <vector>
 
 class CCoinsViewCache;
@@ -208,7 +212,71 @@ static void MempoolCheck(benchmark::Bench& bench)
     });
 }
 
+static constexpr CAmount FAN_OUT_VALUE{COIN / 10};
+
+// Mine a transaction paying num_outputs P2PK outputs of FAN_OUT_VALUE each, and return it.
+static CTransactionRef CreateConfirmedFanOut(TestChain100Setup& setup, size_t num_outputs)
+{
+    const CScript p2pk_script{CScript() << ToByteVector(setup.coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const CTransactionRef coinbase{setup.m_coinbase_txns[0]};
+    const CTransactionRef fan_out{MakeTransactionRef(setup.CreateValidMempoolTransaction({coinbase}, {COutPoint{coinbase->GetHash(), 0}}, /*input_height=*/1,
+                                                                                         {setup.coinbaseKey}, std::vector<CTxOut>(num_outputs, CTxOut{FAN_OUT_VALUE, p2pk_script}),
+                                                                                         /*submit=*/false))};
+    setup.CreateAndProcessBlock({CMutableTransaction{*fan_out}}, p2pk_script);
+    return fan_out;
+}
+
+// Test acceptance of a consolidation transaction with many inputs, whose
+// script checks are spread over the script check queue. The validation
+// caches are kept minimal, so that every iteration verifies the signatures.
+static void MempoolAcceptConsolidation(benchmark::Bench& bench)
+{
+    constexpr size_t NUM_INPUTS{400};
+    const auto testing_setup = MakeNoLogFileContext<TestChain100Setup>(ChainType::REGTEST, {.min_validation_cache = true});
+    const CTransactionRef fan_out{CreateConfirmedFanOut(*testing_setup, NUM_INPUTS)};
+    std::vector<COutPoint> inputs;
+    for (uint32_t i{0}; i < NUM_INPUTS; ++i) inputs.emplace_back(fan_out->GetHash(), i);
+    const CTransactionRef tx{MakeTransactionRef(testing_setup->CreateValidMempoolTransaction({fan_out}, inputs, /*input_height=*/101, {testing_setup->coinbaseKey},
+                                                                                             {CTxOut{(NUM_INPUTS - 1) * FAN_OUT_VALUE, fan_out->vout[0].scriptPubKey}},
+                                                                                             /*submit=*/false))};
+
+    LOCK(cs_main);
+    bench.unit("tx").run([&] {
+        const auto result{testing_setup->m_node.chainman->ProcessTransaction(tx, /*test_accept=*/true)};
+        assert(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+    });
+}
+
+// Test acceptance of a package of 24 parents and their child, whose script
+// checks are run on the script check queue together.
+static void MempoolAcceptPackage(benchmark::Bench& bench)
+{
+    constexpr size_t NUM_PARENTS{24};
+    const auto testing_setup = MakeNoLogFileContext<TestChain100Setup>(ChainType::REGTEST, {.min_validation_cache = true});
+    const CTransactionRef fan_out{CreateConfirmedFanOut(*testing_setup, NUM_PARENTS)};
+    const CScript& p2pk_script{fan_out->vout[0].scriptPubKey};
+    Package package;
+    std::vector<COutPoint> child_inputs;
+    for (uint32_t i{0}; i < NUM_PARENTS; ++i) {
+        package.push_back(MakeTransactionRef(testing_setup->CreateValidMempoolTransaction({fan_out}, {COutPoint{fan_out->GetHash(), i}}, /*input_height=*/101,
+                                                                                          {testing_setup->coinbaseKey}, {CTxOut{FAN_OUT_VALUE - 10'000, p2pk_script}},
+                                                                                          /*submit=*/false)));
+        child_inputs.emplace_back(package.back()->GetHash(), 0);
+    }
+    package.push_back(MakeTransactionRef(testing_setup->CreateValidMempoolTransaction({package}, child_inputs, /*input_height=*/102, {testing_setup->coinbaseKey},
+                                                                                      {CTxOut{(NUM_PARENTS - 1) * FAN_OUT_VALUE, p2pk_script}}, /*submit=*/false)));
+
+    Chainstate& chainstate{testing_setup->m_node.chainman->ActiveChainstate()};
+    LOCK(cs_main);
+    bench.unit("package").run([&] {
+        const auto result{ProcessNewPackage(chainstate, *testing_setup->m_node.mempool, package, /*test_accept=*/true, /*client_maxfeerate=*/std::nullopt)};
+        assert(result.m_state.IsValid());
+    });
+}
+
 BENCHMARK(MemPoolAncestorsDescendants);
 BENCHMARK(MemPoolAddTransactions);
 BENCHMARK(ComplexMemPool);
 BENCHMARK(MempoolCheck);
+BENCHMARK(MempoolAcceptConsolidation);
+BENCHMARK(MempoolAcceptPackage);
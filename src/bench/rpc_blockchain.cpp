@@ -5,6 +5,7 @@
 #include <bench/bench.h>
 #include <bench/data/block413567.raw.h>
 #include <chain.h>
+#include <common/json_writer.h>
 #include <core_io.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
@@ -18,7 +19,9 @@
 #include <validation.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 namespace {
@@ -83,3 +86,50 @@ static void BlockToJsonVerboseWrite(benchmark::Bench& bench)
 }
 
 BENCHMARK(BlockToJsonVerboseWrite);
+
+// The benchmarks below compare the time until the first byte of a verbosity 3
+// block can be sent. Building the DOM keeps the whole UniValue tree and its
+// string in memory at once, while streaming holds at most one flush threshold
+// of output plus the tree of a single transaction.
+
+static void BlockToJsonDomFirstByte(benchmark::Bench& bench)
+{
+    TestBlockAndIndex data;
+    const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    bench.run([&] {
+        auto str = blockToJSON(data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit).write();
+        ankerl::nanobench::doNotOptimizeAway(str);
+    });
+}
+
+static void BlockToJsonStreamFirstByte(benchmark::Bench& bench)
+{
+    struct FirstChunk {};
+    TestBlockAndIndex data;
+    const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    bench.run([&] {
+        JsonWriter writer{[](std::string_view) { throw FirstChunk{}; }};
+        try {
+            blockToJSON(writer, data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit);
+            writer.Flush();
+        } catch (const FirstChunk&) {
+        }
+    });
+}
+
+static void BlockToJsonStream(benchmark::Bench& bench)
+{
+    TestBlockAndIndex data;
+    const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    bench.run([&] {
+        uint64_t bytes{0};
+        JsonWriter writer{[&](std::string_view chunk) { bytes += chunk.size(); }};
+        blockToJSON(writer, data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit);
+        writer.Flush();
+        ankerl::nanobench::doNotOptimizeAway(bytes);
+    });
+}
+
+BENCHMARK(BlockToJsonDomFirstByte);
+BENCHMARK(BlockToJsonStreamFirstByte);
+BENCHMARK(BlockToJsonStream);
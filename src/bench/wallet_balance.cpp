@@ -3,10 +3,14 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <consensus/amount.h>
+#include <consensus/consensus.h>
 #include <interfaces/chain.h>
 #include <kernel/chainparams.h>
+#include <key_io.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
+#include <script/script.h>
 #include <sync.h>
 #include <test/util/mining.h>
 #include <test/util/setup_common.h>
@@ -16,6 +20,7 @@
 #include <validation.h>
 #include <wallet/receive.h>
 #include <wallet/test/util.h>
+#include <wallet/transaction.h>
 #include <wallet/wallet.h>
 #include <wallet/walletutil.h>
 
@@ -63,11 +68,52 @@ static void WalletBalance(benchmark::Bench& bench, const bool set_dirty, const b
         });
 }
 
+static void WalletBalanceManyTxs(benchmark::Bench& bench, const bool set_dirty)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+
+    CWallet wallet{test_setup->m_node.chain.get(), "", CreateMockableWalletDatabase()};
+    {
+        LOCK(wallet.cs_wallet);
+        wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+        wallet.SetupDescriptorScriptPubKeyMans();
+    }
+    const CScript script_mine{GetScriptForDestination(DecodeDestination(getnewaddress(wallet)))};
+
+    // Fill the wallet with a million confirmed payments, without mining the blocks
+    // for them; only the wallet's view of the chain matters for its balance.
+    constexpr int NUM_TXS{1'000'000};
+    const uint256 block_hash{test_setup->m_node.chainman->GetParams().GenesisBlock().GetHash()};
+    {
+        LOCK(wallet.cs_wallet);
+        wallet.SetLastBlockProcessed(/*block_height=*/COINBASE_MATURITY, block_hash);
+        for (int i = 0; i < NUM_TXS; ++i) {
+            CMutableTransaction mtx;
+            mtx.vin.emplace_back(Txid{}, static_cast<uint32_t>(i));
+            mtx.vout.emplace_back(COIN, script_mine);
+            wallet.AddToWallet(MakeTransactionRef(std::move(mtx)), TxStateConfirmed{block_hash, /*height=*/0, /*index=*/i});
+        }
+    }
+
+    bench.setup([&] {
+            if (set_dirty) wallet.MarkDirty();
+        })
+        .run([&] {
+            const auto bal{GetBalance(wallet)};
+            ankerl::nanobench::doNotOptimizeAway(bal);
+            assert(bal.m_mine_trusted == NUM_TXS * COIN);
+        });
+}
+
 static void WalletBalanceDirty(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/true, /*add_mine=*/true); }
 static void WalletBalanceClean(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/true); }
 static void WalletBalanceWatch(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/false); }
+static void WalletBalanceManyTxsDirty(benchmark::Bench& bench) { WalletBalanceManyTxs(bench, /*set_dirty=*/true); }
+static void WalletBalanceManyTxsClean(benchmark::Bench& bench) { WalletBalanceManyTxs(bench, /*set_dirty=*/false); }
 
 BENCHMARK(WalletBalanceDirty);
 BENCHMARK(WalletBalanceClean);
 BENCHMARK(WalletBalanceWatch);
+BENCHMARK(WalletBalanceManyTxsDirty);
+BENCHMARK(WalletBalanceManyTxsClean);
 } // namespace wallet
@@ -0,0 +1,44 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/check.h>
+#include <util/time.h>
+#include <util/translation.h>
+#include <wallet/db.h>
+#include <wallet/sqlite.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace wallet {
+static void WalletDatabaseWrites(benchmark::Bench& bench, std::chrono::milliseconds group_commit_window)
+{
+    const auto test_setup = MakeNoLogFileContext<BasicTestingSetup>();
+
+    DatabaseOptions options;
+    options.group_commit_window = group_commit_window;
+    DatabaseStatus status;
+    bilingual_str error;
+    const auto database{MakeSQLiteDatabase(test_setup->m_path_root / "wallet", options, status, error)};
+    Assert(database);
+
+    uint32_t i{0};
+    bench.run([&] {
+        // Like most wallet updates, every write uses a batch of its own
+        Assert(database->MakeBatch()->Write(std::make_pair(std::string{"key"}, i++), uint256::ONE));
+    });
+}
+
+static void WalletDatabaseWritesAutocommit(benchmark::Bench& bench) { WalletDatabaseWrites(bench, /*group_commit_window=*/0ms); }
+static void WalletDatabaseWritesGroupCommit(benchmark::Bench& bench) { WalletDatabaseWrites(bench, /*group_commit_window=*/100ms); }
+
+BENCHMARK(WalletDatabaseWritesAutocommit);
+BENCHMARK(WalletDatabaseWritesGroupCommit);
+} // namespace wallet
@@ -6,11 +6,14 @@
 #include <bench/bench.h>
 #include <key.h>
 #include <key_io.h>
+#include <random.h>
 #include <script/descriptor.h>
 #include <script/script.h>
 #include <script/signingprovider.h>
 #include <sync.h>
 #include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/string.h>
 #include <wallet/context.h>
 #include <wallet/db.h>
 #include <wallet/test/util.h>
@@ -22,11 +25,13 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace wallet {
-static void WalletIsMine(benchmark::Bench& bench, int num_combo = 0)
+static void WalletIsMine(benchmark::Bench& bench, int num_combo = 0, int keypool_size = DEFAULT_KEYPOOL_SIZE)
 {
     const auto test_setup = MakeNoLogFileContext<TestingSetup>();
+    test_setup->m_args.ForceSetArg("-keypool", util::ToString(keypool_size));
 
     WalletContext context;
     context.args = &test_setup->m_args;
@@ -53,11 +58,18 @@ static void WalletIsMine(benchmark::Bench& bench, int num_combo = 0)
         }
     }
 
-    const CScript script = GetScriptForDestination(DecodeDestination(ADDRESS_BCRT1_UNSPENDABLE));
+    // Cycle through many foreign scripts, like the outputs of relayed transactions, rather
+    // than querying one script whose cache lines stay hot
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<CScript> scripts{GetScriptForDestination(DecodeDestination(ADDRESS_BCRT1_UNSPENDABLE))};
+    while (scripts.size() < 4096) {
+        scripts.push_back(GetScriptForDestination(WitnessV0KeyHash{uint160{rng.randbytes(uint160::size())}}));
+    }
+    size_t i{0};
 
     bench.run([&] {
         LOCK(wallet->cs_wallet);
-        bool mine = wallet->IsMine(script);
+        bool mine = wallet->IsMine(scripts[i++ % scripts.size()]);
         assert(!mine);
     });
 
@@ -66,6 +78,8 @@ static void WalletIsMine(benchmark::Bench& bench, int num_combo = 0)
 
 static void WalletIsMineDescriptors(benchmark::Bench& bench) { WalletIsMine(bench); }
 static void WalletIsMineMigratedDescriptors(benchmark::Bench& bench) { WalletIsMine(bench, /*num_combo=*/2000); }
+static void WalletIsMineLargeKeypool(benchmark::Bench& bench) { WalletIsMine(bench, /*num_combo=*/0, /*keypool_size=*/10000); }
 BENCHMARK(WalletIsMineDescriptors);
 BENCHMARK(WalletIsMineMigratedDescriptors);
+BENCHMARK(WalletIsMineLargeKeypool);
 } // namespace wallet
@@ -0,0 +1,80 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <bench/bench.h>
+#include <kernel/chain.h>
+#include <kernel/types.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <wallet/chainnotifications.h>
+#include <wallet/context.h>
+#include <wallet/test/util.h>
+#include <wallet/wallet.h>
+#include <wallet/walletutil.h>
+
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace wallet {
+static void WalletNotifyBlock(benchmark::Bench& bench, bool shared)
+{
+    const auto test_setup = MakeNoLogFileContext<TestingSetup>();
+    test_setup->m_args.ForceSetArg("-keypool", "10");
+
+    WalletContext context;
+    context.args = &test_setup->m_args;
+    context.chain = test_setup->m_node.chain.get();
+
+    // A node serving many users, each with their own wallet
+    constexpr int NUM_WALLETS{500};
+    std::vector<std::shared_ptr<CWallet>> wallets;
+    for (int i = 0; i < NUM_WALLETS; ++i) {
+        wallets.push_back(TestCreateWallet(CreateMockableWalletDatabase(), context, WALLET_FLAG_DESCRIPTORS));
+    }
+    const auto dispatcher{WITH_LOCK(context.wallets_mutex, return context.notification_dispatcher)};
+
+    // A full block of transactions paying to none of the wallets
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CBlock block;
+    for (int i = 0; i < 2000; ++i) {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(COutPoint{Txid::FromUint256(rng.rand256()), 0});
+        mtx.vout.emplace_back(COIN, GetScriptForDestination(WitnessV0KeyHash{uint160{rng.randbytes(uint160::size())}}));
+        mtx.vout.emplace_back(COIN, GetScriptForDestination(WitnessV1Taproot{XOnlyPubKey{rng.rand256()}}));
+        block.vtx.push_back(MakeTransactionRef(std::move(mtx)));
+    }
+    const uint256 hash{rng.rand256()};
+    interfaces::BlockInfo info{hash};
+    info.prev_hash = &hash;
+    info.height = 1;
+    info.data = &block;
+    info.chain_time_max = std::numeric_limits<unsigned int>::max();
+    const kernel::ChainstateRole role{.validated = true, .historical = false};
+
+    bench.run([&] {
+        if (shared) {
+            dispatcher->blockConnected(role, info);
+        } else {
+            // What registering every wallet separately does
+            for (const auto& wallet : wallets) wallet->blockConnected(role, info);
+        }
+    });
+
+    for (auto& wallet : wallets) TestUnloadWallet(std::move(wallet));
+}
+
+static void WalletNotifyBlockShared(benchmark::Bench& bench) { WalletNotifyBlock(bench, /*shared=*/true); }
+static void WalletNotifyBlockPerWallet(benchmark::Bench& bench) { WalletNotifyBlock(bench, /*shared=*/false); }
+
+BENCHMARK(WalletNotifyBlockShared);
+BENCHMARK(WalletNotifyBlockPerWallet);
+} // namespace wallet
@@ -0,0 +1,66 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <interfaces/chain.h>
+#include <kernel/chainparams.h>
+#include <primitives/block.h>
+#include <sync.h>
+#include <test/util/mining.h>
+#include <test/util/setup_common.h>
+#include <test/util/time.h>
+#include <uint256.h>
+#include <validation.h>
+#include <wallet/test/util.h>
+#include <wallet/wallet.h>
+#include <wallet/walletutil.h>
+
+#include <cassert>
+#include <string>
+
+namespace wallet {
+static void WalletRescan(benchmark::Bench& bench, const int rescan_threads)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+
+    // Set clock to genesis block, so the descriptors creation time doesn't make the scan skip blocks.
+    NodeClockContext clock_ctx{test_setup->m_node.chainman->GetParams().GenesisBlock().Time()};
+    CWallet wallet{test_setup->m_node.chain.get(), "", CreateMockableWalletDatabase()};
+    {
+        LOCK(wallet.cs_wallet);
+        wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+        wallet.SetupDescriptorScriptPubKeyMans();
+    }
+    wallet.m_rescan_threads = rescan_threads;
+
+    // The wallet is not connected to the chain, so it only learns about these
+    // blocks through the rescan.
+    const std::string address_mine{getnewaddress(wallet)};
+    for (int i = 0; i < 100; ++i) {
+        generatetoaddress(test_setup->m_node, address_mine);
+        generatetoaddress(test_setup->m_node, ADDRESS_BCRT1_UNSPENDABLE);
+    }
+    const uint256 genesis_hash{test_setup->m_node.chainman->GetParams().GenesisBlock().GetHash()};
+    {
+        LOCK2(wallet.cs_wallet, ::cs_main);
+        const CChain& active_chain{test_setup->m_node.chainman->ActiveChain()};
+        wallet.SetLastBlockProcessed(active_chain.Height(), active_chain.Tip()->GetBlockHash());
+    }
+
+    bench.run([&] {
+        WalletRescanReserver reserver{wallet};
+        reserver.reserve();
+        const auto result{wallet.ScanForWalletTransactions(genesis_hash, /*start_height=*/0, /*max_height=*/{}, reserver, /*fUpdate=*/false, /*save_progress=*/false)};
+        assert(result.status == CWallet::ScanResult::SUCCESS);
+        assert(result.last_scanned_height == 200);
+    });
+}
+
+static void WalletRescanSingleThread(benchmark::Bench& bench) { WalletRescan(bench, /*rescan_threads=*/1); }
+static void WalletRescanMultiThread(benchmark::Bench& bench) { WalletRescan(bench, /*rescan_threads=*/4); }
+
+BENCHMARK(WalletRescanSingleThread);
+BENCHMARK(WalletRescanMultiThread);
+} // namespace wallet
@@ -0,0 +1,44 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <key.h>
+#include <key_io.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <wallet/scriptpubkeyman.h>
+#include <wallet/test/util.h>
+#include <wallet/wallet.h>
+
+#include <cassert>
+#include <memory>
+#include <string>
+
+namespace wallet {
+static void WalletTopUp(benchmark::Bench& bench, int threads)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+
+    CExtKey master_key;
+    master_key.SetSeed(FastRandomContext{/*fDeterministic=*/true}.randbytes<std::byte>(32));
+    const std::string desc_str{"wpkh(" + EncodeExtKey(master_key) + "/84h/1h/0h/0/*)"};
+
+    // Derive a gap limit as large as the ones used when restoring busy wallets
+    constexpr unsigned int TOPUP_SIZE{100'000};
+    bench.epochs(1).epochIterations(1).run([&] {
+        CWallet wallet(test_setup->m_node.chain.get(), "", CreateMockableWalletDatabase());
+        wallet.m_keypool_size = 1;
+        wallet.m_keypool_threads = threads;
+        auto spk_man{CreateDescriptor(wallet, desc_str, /*success=*/true)};
+        bool ok{spk_man->TopUp(TOPUP_SIZE)};
+        assert(ok);
+    });
+}
+
+static void WalletTopUpSingleThread(benchmark::Bench& bench) { WalletTopUp(bench, /*threads=*/1); }
+static void WalletTopUpMultiThread(benchmark::Bench& bench) { WalletTopUp(bench, /*threads=*/DEFAULT_KEYPOOL_THREADS); }
+
+BENCHMARK(WalletTopUpSingleThread);
+BENCHMARK(WalletTopUpMultiThread);
+} // namespace wallet
@@ -0,0 +1,159 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <common/json_writer.h>
+
+#include <univalue.h>
+#include <univalue_escapes.h>
+#include <util/check.h>
+
+#include <utility>
+
+JsonWriter::JsonWriter(Sink sink, size_t flush_threshold)
+    : m_sink{std::move(sink)}, m_flush_threshold{flush_threshold}
+{
+    m_buffer.reserve(m_flush_threshold);
+}
+
+void JsonWriter::Separator()
+{
+    if (m_after_key) {
+        m_after_key = false;
+        return;
+    }
+    if (!m_empty.empty()) {
+        if (!m_empty.back()) m_buffer += ',';
+        m_empty.back() = false;
+    }
+}
+
+void JsonWriter::Append(std::string_view str)
+{
+    m_buffer.append(str);
+}
+
+void JsonWriter::AppendEscaped(std::string_view str)
+{
+    m_buffer += '"';
+    for (const char c : str) {
+        if (const char* esc{escapes[static_cast<unsigned char>(c)]}) {
+            m_buffer += esc;
+        } else {
+            m_buffer += c;
+        }
+    }
+    m_buffer += '"';
+}
+
+void JsonWriter::MaybeFlush()
+{
+    if (m_buffer.size() >= m_flush_threshold) Flush();
+}
+
+void JsonWriter::BeginObject()
+{
+    Separator();
+    m_buffer += '{';
+    m_empty.push_back(true);
+}
+
+void JsonWriter::EndObject()
+{
+    Assume(!m_empty.empty() && !m_after_key);
+    m_empty.pop_back();
+    m_buffer += '}';
+    MaybeFlush();
+}
+
+void JsonWriter::BeginArray()
+{
+    Separator();
+    m_buffer += '[';
+    m_empty.push_back(true);
+}
+
+void JsonWriter::EndArray()
+{
+    Assume(!m_empty.empty() && !m_after_key);
+    m_empty.pop_back();
+    m_buffer += ']';
+    MaybeFlush();
+}
+
+void JsonWriter::Key(std::string_view key)
+{
+    Assume(!m_empty.empty() && !m_after_key);
+    Separator();
+    AppendEscaped(key);
+    m_buffer += ':';
+    m_after_key = true;
+}
+
+void JsonWriter::String(std::string_view str)
+{
+    Separator();
+    AppendEscaped(str);
+    MaybeFlush();
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void JsonWriter::Value(const UniValue& value)
+{
+    switch (value.getType()) {
+    case UniValue::VNULL:
+        Separator();
+        Append("null");
+        break;
+    case UniValue::VBOOL:
+        Separator();
+        Append(value.get_bool() ? "true" : "false");
+        break;
+    case UniValue::VNUM:
+        Separator();
+        Append(value.getValStr());
+        break;
+    case UniValue::VSTR:
+        String(value.get_str());
+        return;
+    case UniValue::VARR:
+        BeginArray();
+        for (const UniValue& v : value.getValues()) {
+            Value(v);
+        }
+        EndArray();
+        return;
+    case UniValue::VOBJ:
+        BeginObject();
+        Members(value);
+        EndObject();
+        return;
+    } // no default case, so the compiler can warn about missing cases
+    MaybeFlush();
+}
+
+// NOLINTNEXTLINE(misc-no-recursion)
+void JsonWriter::Members(const UniValue& object)
+{
+    const auto& keys{object.getKeys()};
+    const auto& values{object.getValues()};
+    for (size_t i{0}; i < keys.size(); ++i) {
+        Key(keys[i]);
+        Value(values[i]);
+    }
+}
+
+void JsonWriter::Flush()
+{
+    if (m_buffer.empty()) return;
+    m_sink(m_buffer);
+    m_bytes_written += m_buffer.size();
+    m_buffer.clear();
+}
+
+void JsonWriter::Finish()
+{
+    Assume(m_empty.empty() && !m_after_key);
+    m_buffer += '\n';
+    Flush();
+}
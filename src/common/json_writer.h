@@ -0,0 +1,80 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_COMMON_JSON_WRITER_H
+#define BITCOIN_COMMON_JSON_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class UniValue;
+
+/**
+ * Incremental JSON emitter.
+ *
+ * Produces the same compact output as UniValue::write(), but hands it to a
+ * sink in chunks of roughly flush_threshold bytes while the document is being
+ * generated. Large documents therefore never need to be held in memory as a
+ * whole, neither as a UniValue tree nor as a string, and the first bytes can
+ * be sent before the last ones are produced.
+ *
+ * Callers are responsible for emitting a well-formed sequence of calls: keys
+ * only inside objects, and every Begin matched by an End.
+ */
+class JsonWriter
+{
+public:
+    using Sink = std::function<void(std::string_view chunk)>;
+
+    static constexpr size_t DEFAULT_FLUSH_THRESHOLD{64 * 1024};
+
+    explicit JsonWriter(Sink sink, size_t flush_threshold = DEFAULT_FLUSH_THRESHOLD);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    /** Write an object key. Must be followed by exactly one value. */
+    void Key(std::string_view key);
+
+    /** Write a string value without materializing a UniValue for it. */
+    void String(std::string_view str);
+
+    /** Write a value, recursing into arrays and objects. */
+    void Value(const UniValue& value);
+
+    /** Write the key/value pairs of object into the currently open object. */
+    void Members(const UniValue& object);
+
+    /** Hand everything buffered so far to the sink. */
+    void Flush();
+
+    /** Terminate the document with a newline and flush it. */
+    void Finish();
+
+    /** Number of bytes handed to the sink so far. */
+    uint64_t BytesWritten() const { return m_bytes_written; }
+
+private:
+    void Separator();
+    void Append(std::string_view str);
+    void AppendEscaped(std::string_view str);
+    void MaybeFlush();
+
+    const Sink m_sink;
+    const size_t m_flush_threshold;
+    std::string m_buffer;
+    //! For every open array or object, whether it is still empty.
+    std::vector<bool> m_empty;
+    //! Whether a key was just written and its value is pending.
+    bool m_after_key{false};
+    uint64_t m_bytes_written{0};
+};
+
+#endif // BITCOIN_COMMON_JSON_WRITER_H
@@ -5,6 +5,7 @@
 #include <core_io.h>
 
 #include <addresstype.h>
+#include <common/json_writer.h>
 #include <coins.h>
 #include <consensus/amount.h>
 #include <consensus/consensus.h>
@@ -424,6 +425,79 @@ void ScriptToUniv(const CScript& script, UniValue& out, bool include_hex, bool i
     out.pushKV("type", GetTxnOutputType(type));
 }
 
+static UniValue TxInToUniv(const CTransaction& tx, size_t i, const CTxUndo* txundo, TxVerbosity verbosity)
+{
+    const CTxIn& txin = tx.vin[i];
+    UniValue in(UniValue::VOBJ);
+    if (tx.IsCoinBase()) {
+        in.pushKV("coinbase", HexStr(txin.scriptSig));
+    } else {
+        in.pushKV("txid", txin.prevout.hash.GetHex());
+        in.pushKV("vout", txin.prevout.n);
+        UniValue o(UniValue::VOBJ);
+        o.pushKV("asm", ScriptToAsmStr(txin.scriptSig, true));
+        o.pushKV("hex", HexStr(txin.scriptSig));
+        in.pushKV("scriptSig", std::move(o));
+    }
+    if (!txin.scriptWitness.IsNull()) {
+        UniValue txinwitness(UniValue::VARR);
+        txinwitness.reserve(txin.scriptWitness.stack.size());
+        for (const auto& item : txin.scriptWitness.stack) {
+            txinwitness.push_back(HexStr(item));
+        }
+        in.pushKV("txinwitness", std::move(txinwitness));
+    }
+    if (txundo != nullptr && verbosity == TxVerbosity::SHOW_DETAILS_AND_PREVOUT) {
+        const Coin& prev_coin = txundo->vprevout[i];
+        const CTxOut& prev_txout = prev_coin.out;
+
+        UniValue o_script_pub_key(UniValue::VOBJ);
+        ScriptToUniv(prev_txout.scriptPubKey, /*out=*/o_script_pub_key, /*include_hex=*/true, /*include_address=*/true);
+
+        UniValue p(UniValue::VOBJ);
+        p.pushKV("generated", prev_coin.IsCoinBase());
+        p.pushKV("height", prev_coin.nHeight);
+        p.pushKV("value", ValueFromAmount(prev_txout.nValue));
+        p.pushKV("scriptPubKey", std::move(o_script_pub_key));
+        in.pushKV("prevout", std::move(p));
+    }
+    in.pushKV("sequence", txin.nSequence);
+    return in;
+}
+
+static UniValue TxOutToUniv(const CTxOut& txout, unsigned int n, const std::function<bool(const CTxOut&)>& is_change_func)
+{
+    UniValue out(UniValue::VOBJ);
+
+    out.pushKV("value", ValueFromAmount(txout.nValue));
+    out.pushKV("n", n);
+
+    UniValue o(UniValue::VOBJ);
+    ScriptToUniv(txout.scriptPubKey, /*out=*/o, /*include_hex=*/true, /*include_address=*/true);
+    out.pushKV("scriptPubKey", std::move(o));
+
+    if (is_change_func && is_change_func(txout)) {
+        out.pushKV("ischange", true);
+    }
+    return out;
+}
+
+/** Fee paid by tx, computed from its undo data. */
+static CAmount TxFeeFromUndo(const CTransaction& tx, const CTxUndo& txundo)
+{
+    CAmount amt_total_in = 0;
+    CAmount amt_total_out = 0;
+    for (const Coin& prev_coin : txundo.vprevout) {
+        amt_total_in += prev_coin.out.nValue;
+    }
+    for (const CTxOut& txout : tx.vout) {
+        amt_total_out += txout.nValue;
+    }
+    const CAmount fee = amt_total_in - amt_total_out;
+    CHECK_NONFATAL(MoneyRange(fee));
+    return fee;
+}
+
 void TxToUniv(const CTransaction& tx, const uint256& block_hash, UniValue& entry, bool include_hex, const CTxUndo* txundo, TxVerbosity verbosity, std::function<bool(const CTxOut&)> is_change_func)
 {
     CHECK_NONFATAL(verbosity >= TxVerbosity::SHOW_DETAILS);
@@ -438,94 +512,80 @@ void TxToUniv(const CTransaction& tx, const uint256& block_hash, UniValue& entry
 
     UniValue vin{UniValue::VARR};
     vin.reserve(tx.vin.size());
-
-    // If available, use Undo data to calculate the fee. Note that txundo == nullptr
-    // for coinbase transactions and for transactions where undo data is unavailable.
-    const bool have_undo = txundo != nullptr;
-    CAmount amt_total_in = 0;
-    CAmount amt_total_out = 0;
-
-    for (unsigned int i = 0; i < tx.vin.size(); i++) {
-        const CTxIn& txin = tx.vin[i];
-        UniValue in(UniValue::VOBJ);
-        if (tx.IsCoinBase()) {
-            in.pushKV("coinbase", HexStr(txin.scriptSig));
-        } else {
-            in.pushKV("txid", txin.prevout.hash.GetHex());
-            in.pushKV("vout", txin.prevout.n);
-            UniValue o(UniValue::VOBJ);
-            o.pushKV("asm", ScriptToAsmStr(txin.scriptSig, true));
-            o.pushKV("hex", HexStr(txin.scriptSig));
-            in.pushKV("scriptSig", std::move(o));
-        }
-        if (!tx.vin[i].scriptWitness.IsNull()) {
-            UniValue txinwitness(UniValue::VARR);
-            txinwitness.reserve(tx.vin[i].scriptWitness.stack.size());
-            for (const auto& item : tx.vin[i].scriptWitness.stack) {
-                txinwitness.push_back(HexStr(item));
-            }
-            in.pushKV("txinwitness", std::move(txinwitness));
-        }
-        if (have_undo) {
-            const Coin& prev_coin = txundo->vprevout[i];
-            const CTxOut& prev_txout = prev_coin.out;
-
-            amt_total_in += prev_txout.nValue;
-
-            if (verbosity == TxVerbosity::SHOW_DETAILS_AND_PREVOUT) {
-                UniValue o_script_pub_key(UniValue::VOBJ);
-                ScriptToUniv(prev_txout.scriptPubKey, /*out=*/o_script_pub_key, /*include_hex=*/true, /*include_address=*/true);
-
-                UniValue p(UniValue::VOBJ);
-                p.pushKV("generated", prev_coin.IsCoinBase());
-                p.pushKV("height", prev_coin.nHeight);
-                p.pushKV("value", ValueFromAmount(prev_txout.nValue));
-                p.pushKV("scriptPubKey", std::move(o_script_pub_key));
-                in.pushKV("prevout", std::move(p));
-            }
-        }
-        in.pushKV("sequence", txin.nSequence);
-        vin.push_back(std::move(in));
+    for (size_t i = 0; i < tx.vin.size(); i++) {
+        vin.push_back(TxInToUniv(tx, i, txundo, verbosity));
     }
     entry.pushKV("vin", std::move(vin));
 
     UniValue vout(UniValue::VARR);
     vout.reserve(tx.vout.size());
     for (unsigned int i = 0; i < tx.vout.size(); i++) {
-        const CTxOut& txout = tx.vout[i];
+        vout.push_back(TxOutToUniv(tx.vout[i], i, is_change_func));
+    }
+    entry.pushKV("vout", std::move(vout));
 
-        UniValue out(UniValue::VOBJ);
+    // If available, use Undo data to calculate the fee. Note that txundo == nullptr
+    // for coinbase transactions and for transactions where undo data is unavailable.
+    if (txundo != nullptr) {
+        entry.pushKV("fee", ValueFromAmount(TxFeeFromUndo(tx, *txundo)));
+    }
 
-        out.pushKV("value", ValueFromAmount(txout.nValue));
-        out.pushKV("n", i);
+    if (!block_hash.IsNull()) {
+        entry.pushKV("blockhash", block_hash.GetHex());
+    }
 
-        UniValue o(UniValue::VOBJ);
-        ScriptToUniv(txout.scriptPubKey, /*out=*/o, /*include_hex=*/true, /*include_address=*/true);
-        out.pushKV("scriptPubKey", std::move(o));
+    if (include_hex) {
+        entry.pushKV("hex", EncodeHexTx(tx)); // The hex-encoded transaction. Used the name "hex" to be consistent with the verbose output of "getrawtransaction".
+    }
+}
 
-        if (is_change_func && is_change_func(txout)) {
-            out.pushKV("ischange", true);
-        }
+void TxToJSON(JsonWriter& writer, const CTransaction& tx, const uint256& block_hash, bool include_hex, const CTxUndo* txundo, TxVerbosity verbosity)
+{
+    CHECK_NONFATAL(verbosity >= TxVerbosity::SHOW_DETAILS);
 
-        vout.push_back(std::move(out));
+    writer.BeginObject();
+    writer.Key("txid");
+    writer.String(tx.GetHash().GetHex());
+    writer.Key("hash");
+    writer.String(tx.GetWitnessHash().GetHex());
+    writer.Key("version");
+    writer.Value(tx.version);
+    writer.Key("size");
+    writer.Value(tx.ComputeTotalSize());
+    writer.Key("vsize");
+    writer.Value((GetTransactionWeight(tx) + WITNESS_SCALE_FACTOR - 1) / WITNESS_SCALE_FACTOR);
+    writer.Key("weight");
+    writer.Value(GetTransactionWeight(tx));
+    writer.Key("locktime");
+    writer.Value(tx.nLockTime);
+
+    writer.Key("vin");
+    writer.BeginArray();
+    for (size_t i = 0; i < tx.vin.size(); i++) {
+        writer.Value(TxInToUniv(tx, i, txundo, verbosity));
+    }
+    writer.EndArray();
 
-        if (have_undo) {
-            amt_total_out += txout.nValue;
-        }
+    writer.Key("vout");
+    writer.BeginArray();
+    for (unsigned int i = 0; i < tx.vout.size(); i++) {
+        writer.Value(TxOutToUniv(tx.vout[i], i, /*is_change_func=*/{}));
     }
-    entry.pushKV("vout", std::move(vout));
+    writer.EndArray();
 
-    if (have_undo) {
-        const CAmount fee = amt_total_in - amt_total_out;
-        CHECK_NONFATAL(MoneyRange(fee));
-        entry.pushKV("fee", ValueFromAmount(fee));
+    if (txundo != nullptr) {
+        writer.Key("fee");
+        writer.Value(ValueFromAmount(TxFeeFromUndo(tx, *txundo)));
     }
 
     if (!block_hash.IsNull()) {
-        entry.pushKV("blockhash", block_hash.GetHex());
+        writer.Key("blockhash");
+        writer.String(block_hash.GetHex());
     }
 
     if (include_hex) {
-        entry.pushKV("hex", EncodeHexTx(tx)); // The hex-encoded transaction. Used the name "hex" to be consistent with the verbose output of "getrawtransaction".
+        writer.Key("hex");
+        writer.String(EncodeHexTx(tx));
     }
+    writer.EndObject();
 }
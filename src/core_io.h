@@ -21,6 +21,7 @@ class uint256;
 class UniValue;
 class CTxUndo;
 class CTxOut;
+class JsonWriter;
 
 /**
  * Verbose level for block's transaction
@@ -45,5 +46,7 @@ std::string EncodeHexTx(const CTransaction& tx);
 std::string SighashToStr(unsigned char sighash_type);
 void ScriptToUniv(const CScript& script, UniValue& out, bool include_hex = true, bool include_address = false, const SigningProvider* provider = nullptr);
 void TxToUniv(const CTransaction& tx, const uint256& block_hash, UniValue& entry, bool include_hex = true, const CTxUndo* txundo = nullptr, TxVerbosity verbosity = TxVerbosity::SHOW_DETAILS, std::function<bool(const CTxOut&)> is_change_func = {});
+/** Stream the same JSON as TxToUniv into writer, without building the whole object in memory. */
+void TxToJSON(JsonWriter& writer, const CTransaction& tx, const uint256& block_hash, bool include_hex = true, const CTxUndo* txundo = nullptr, TxVerbosity verbosity = TxVerbosity::SHOW_DETAILS);
 
 #endif // BITCOIN_CORE_IO_H
@@ -30,19 +30,24 @@ void DummyWalletInit::AddWalletOptions(ArgsManager& argsman) const
         "-addresstype",
         "-avoidpartialspends",
         "-changetype",
+        "-coinselectionthreads=<n>",
+        "-coinselectiontimeout=<n>",
         "-consolidatefeerate=<amt>",
         "-disablewallet",
         "-discardfee=<amt>",
         "-fallbackfee=<amt>",
         "-keypool=<n>",
+        "-keypoolthreads=<n>",
         "-maxapsfee=<n>",
         "-maxtxfee=<amt>",
         "-mintxfee=<amt>",
+        "-rescanthreads=<n>",
         "-signer=<cmd>",
         "-spendzeroconfchange",
         "-txconfirmtarget=<n>",
         "-wallet=<path>",
         "-walletbroadcast",
+        "-walletgroupcommit=<ms>",
         "-walletdir=<dir>",
         "-walletnotify=<cmd>",
         "-walletrbf",
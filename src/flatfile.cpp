@@ -56,16 +56,23 @@ FILE* FlatFileSeq::Open(const FlatFilePos& pos, bool read_only) const
     return file;
 }
 
-size_t FlatFileSeq::Allocate(const FlatFilePos& pos, size_t add_size, bool& out_of_space) const
+size_t FlatFileSeq::AllocationSize(const FlatFilePos& pos, size_t add_size) const
 {
-    out_of_space = false;
-
     unsigned int n_old_chunks = CeilDiv(pos.nPos, m_chunk_size);
     unsigned int n_new_chunks = CeilDiv(pos.nPos + add_size, m_chunk_size);
     if (n_new_chunks > n_old_chunks) {
-        size_t old_size = pos.nPos;
-        size_t new_size = n_new_chunks * m_chunk_size;
-        size_t inc_size = new_size - old_size;
+        return n_new_chunks * m_chunk_size - pos.nPos;
+    }
+    return 0;
+}
+
+size_t FlatFileSeq::Allocate(const FlatFilePos& pos, size_t add_size, bool& out_of_space) const
+{
+    out_of_space = false;
+
+    size_t inc_size = AllocationSize(pos, add_size);
+    if (inc_size > 0) {
+        size_t new_size = pos.nPos + inc_size;
 
         if (CheckDiskSpace(m_dir, inc_size)) {
             FILE *file = Open(pos);
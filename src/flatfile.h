@@ -61,6 +61,12 @@ public:
     /** Open a handle to the file at the given position. */
     FILE* Open(const FlatFilePos& pos, bool read_only = false) const;
 
+    /**
+     * Return the number of bytes Allocate() would pre-allocate after the given starting position
+     * for add_size bytes, or 0 if the space is already allocated.
+     */
+    size_t AllocationSize(const FlatFilePos& pos, size_t add_size) const;
+
     /**
      * Allocate additional space in a file after the given starting position. The amount allocated
      * will be the minimum multiple of the sequence chunk size greater than add_size.
@@ -5,12 +5,15 @@
 #include <httprpc.h>
 
 #include <common/args.h>
+#include <common/json_writer.h>
 #include <crypto/hmac_sha256.h>
 #include <httpserver.h>
 #include <logging.h>
 #include <netaddress.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
+#include <sync.h>
+#include <tinyformat.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/strencodings.h>
@@ -18,12 +21,15 @@
 #include <walletinitinterface.h>
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <optional>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 using util::SplitString;
@@ -37,6 +43,8 @@ static std::vector<std::vector<std::string>> g_rpcauth;
 /* RPC Auth Whitelist */
 static std::map<std::string, std::set<std::string>> g_rpc_whitelist;
 static bool g_rpc_whitelist_default = false;
+/* Maximum number of threads executing the elements of one batch request */
+static int g_rpc_batch_threads{DEFAULT_RPC_BATCH_THREADS};
 
 static UniValue JSONErrorReply(UniValue objError, const JSONRPCRequest& jreq, HTTPStatusCode& nStatus)
 {
@@ -100,6 +108,70 @@ static bool RPCAuthorized(const std::string& strAuth, std::string& strAuthUserna
     return CheckUserAuthorized(user, pass);
 }
 
+/** Execute one element of a batch. Notifications get no response and return std::nullopt. */
+static std::optional<UniValue> ExecuteBatchElement(const UniValue& request, JSONRPCRequest jreq)
+{
+    // Batches never throw HTTP errors, they are always just included
+    // in "HTTP OK" responses. Notifications never get any response.
+    UniValue response;
+    try {
+        jreq.parse(request);
+        response = JSONRPCExec(jreq, /*catch_errors=*/true);
+    } catch (UniValue& e) {
+        response = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
+    } catch (const std::exception& e) {
+        response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id, jreq.m_json_version);
+    } catch (...) {
+        // Helpers run on HTTP worker threads, which must not see the exception, and
+        // the batch waits for a response to every element
+        response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_MISC_ERROR, "unknown error"), jreq.id, jreq.m_json_version);
+    }
+    if (jreq.IsNotification()) return std::nullopt;
+    return response;
+}
+
+/**
+ * Execute the elements of a batch on up to -rpcbatchthreads threads: the
+ * calling one and helpers queued on the HTTP worker threads. Elements are
+ * claimed in order from a shared counter, so the calling thread can finish the
+ * batch on its own if no helper gets to run, e.g. because all HTTP workers are
+ * busy. Responses are returned in request order. With more than one thread,
+ * elements may run concurrently and out of order, so this is only enabled on
+ * request.
+ */
+static std::vector<std::optional<UniValue>> ExecuteBatch(const UniValue& batch, const JSONRPCRequest& jreq)
+{
+    struct BatchState {
+        std::atomic<size_t> next{0};
+        std::vector<std::optional<UniValue>> responses;
+        Mutex mutex;
+        std::condition_variable cv;
+        size_t done GUARDED_BY(mutex){0};
+    };
+    auto state{std::make_shared<BatchState>()};
+    state->responses.resize(batch.size());
+
+    // Helpers that only start after the batch is complete find no element
+    // left to claim and never touch batch or jreq.
+    auto run{[state, &batch, &jreq] {
+        for (size_t i{state->next++}; i < state->responses.size(); i = state->next++) {
+            state->responses[i] = ExecuteBatchElement(batch[i], jreq);
+            LOCK(state->mutex);
+            if (++state->done == state->responses.size()) state->cv.notify_all();
+        }
+    }};
+
+    const size_t threads{std::min<size_t>(g_rpc_batch_threads, batch.size())};
+    for (size_t i{1}; i < threads; ++i) {
+        if (!SubmitHTTPWork(run)) break;
+    }
+    run();
+
+    WAIT_LOCK(state->mutex, lock);
+    state->cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(state->mutex) { return state->done == state->responses.size(); });
+    return std::move(state->responses);
+}
+
 UniValue ExecuteHTTPRPC(const UniValue& valRequest, JSONRPCRequest& jreq, HTTPStatusCode& status)
 {
     status = HTTP_OK;
@@ -153,20 +225,9 @@ UniValue ExecuteHTTPRPC(const UniValue& valRequest, JSONRPCRequest& jreq, HTTPSt
 
             // Execute each request
             UniValue reply = UniValue::VARR;
-            for (size_t i{0}; i < valRequest.size(); ++i) {
-                // Batches never throw HTTP errors, they are always just included
-                // in "HTTP OK" responses. Notifications never get any response.
-                UniValue response;
-                try {
-                    jreq.parse(valRequest[i]);
-                    response = JSONRPCExec(jreq, /*catch_errors=*/true);
-                } catch (UniValue& e) {
-                    response = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
-                } catch (const std::exception& e) {
-                    response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id, jreq.m_json_version);
-                }
-                if (!jreq.IsNotification()) {
-                    reply.push_back(std::move(response));
+            for (std::optional<UniValue>& response : ExecuteBatch(valRequest, jreq)) {
+                if (response) {
+                    reply.push_back(std::move(*response));
                 }
             }
             // Return no response for an all-notification batch, but only if the
@@ -193,27 +254,18 @@ UniValue ExecuteHTTPRPC(const UniValue& valRequest, JSONRPCRequest& jreq, HTTPSt
     }
 }
 
-static void HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
+/** Check the credentials of req, replying to it if they are missing or wrong. */
+static bool CheckAuthorization(HTTPRequest* req, const std::string& peer_addr, std::string& user)
 {
-    // JSONRPC handles only POST
-    if (req->GetRequestMethod() != HTTPRequest::POST) {
-        req->WriteReply(HTTP_BAD_METHOD, "JSONRPC server handles only POST requests");
-        return;
-    }
-    // Check authorization
     std::pair<bool, std::string> authHeader = req->GetHeader("authorization");
     if (!authHeader.first) {
         req->WriteHeader("WWW-Authenticate", WWW_AUTH_HEADER_DATA);
         req->WriteReply(HTTP_UNAUTHORIZED);
-        return;
+        return false;
     }
 
-    JSONRPCRequest jreq;
-    jreq.context = context;
-    jreq.peerAddr = req->GetPeer().ToStringAddrPort();
-    jreq.URI = req->GetURI();
-    if (!RPCAuthorized(authHeader.second, jreq.authUser)) {
-        LogWarning("ThreadRPCServer incorrect password attempt from %s", jreq.peerAddr);
+    if (!RPCAuthorized(authHeader.second, user)) {
+        LogWarning("ThreadRPCServer incorrect password attempt from %s", peer_addr);
 
         /* Deter brute-forcing
            If this results in a DoS the user really
@@ -222,27 +274,98 @@ static void HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
 
         req->WriteHeader("WWW-Authenticate", WWW_AUTH_HEADER_DATA);
         req->WriteReply(HTTP_UNAUTHORIZED);
+        return false;
+    }
+    return true;
+}
+
+static void HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
+{
+    // JSONRPC handles only POST
+    if (req->GetRequestMethod() != HTTPRequest::POST) {
+        req->WriteReply(HTTP_BAD_METHOD, "JSONRPC server handles only POST requests");
         return;
     }
 
+    JSONRPCRequest jreq;
+    jreq.context = context;
+    jreq.peerAddr = req->GetPeer().ToStringAddrPort();
+    jreq.URI = req->GetURI();
+    if (!CheckAuthorization(req, jreq.peerAddr, jreq.authUser)) return;
+
     // Generate reply
     HTTPStatusCode status;
     UniValue reply;
     UniValue request;
-    if (request.read(req->ReadBody())) {
+    const std::string body{req->ReadBody()};
+    if (request.read(body)) {
         reply = ExecuteHTTPRPC(request, jreq, status);
     } else {
         reply = JSONErrorReply(JSONRPCError(RPC_PARSE_ERROR, "Parse error"), jreq, status);
     }
 
     // Write reply
+    uint64_t bytes_out{0};
     if (reply.isNull()) {
         // Error case or no-content notification reply.
         req->WriteReply(status);
     } else {
-        req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(status, reply.write() + "\n");
+        // Stream the reply instead of stringifying it as a whole first.
+        bytes_out = WriteJSONReply(*req, status, [&](JsonWriter& writer) { writer.Value(reply); });
+    }
+    // Only single requests name a method, the elements of a batch are parsed into copies of jreq
+    if (!jreq.strMethod.empty()) tableRPC.RecordTraffic(jreq.strMethod, body.size(), bytes_out);
+}
+
+/** Render the RPC method statistics in the Prometheus text exposition format. */
+static std::string FormatRPCMetrics(const std::map<std::string, RPCMethodStats>& method_stats)
+{
+    std::string out;
+    const auto counter{[&](std::string_view name, std::string_view type, std::string_view help, uint64_t RPCMethodStats::* field) {
+        out += strprintf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+        for (const auto& [method, stats] : method_stats) {
+            out += strprintf("%s{method=\"%s\"} %u\n", name, method, stats.*field);
+        }
+    }};
+    counter("bitcoin_rpc_calls_total", "counter", "Completed RPC calls.", &RPCMethodStats::calls);
+    counter("bitcoin_rpc_errors_total", "counter", "Completed RPC calls that returned an error.", &RPCMethodStats::errors);
+    counter("bitcoin_rpc_in_flight", "gauge", "RPC calls currently executing.", &RPCMethodStats::in_flight);
+    counter("bitcoin_rpc_request_bytes_total", "counter", "Size of RPC requests outside of batches.", &RPCMethodStats::bytes_in);
+    counter("bitcoin_rpc_response_bytes_total", "counter", "Size of RPC replies outside of batches.", &RPCMethodStats::bytes_out);
+
+    out += "# HELP bitcoin_rpc_latency_seconds Time spent executing RPC calls.\n# TYPE bitcoin_rpc_latency_seconds histogram\n";
+    for (const auto& [method, stats] : method_stats) {
+        // Prometheus buckets are cumulative
+        uint64_t cumulative{0};
+        for (size_t i{0}; i < RPC_LATENCY_BUCKETS_US.size(); ++i) {
+            cumulative += stats.latency_buckets[i];
+            out += strprintf("bitcoin_rpc_latency_seconds_bucket{method=\"%s\",le=\"%g\"} %u\n", method, RPC_LATENCY_BUCKETS_US[i] / 1e6, cumulative);
+        }
+        cumulative += stats.latency_buckets.back();
+        out += strprintf("bitcoin_rpc_latency_seconds_bucket{method=\"%s\",le=\"+Inf\"} %u\n", method, cumulative);
+        out += strprintf("bitcoin_rpc_latency_seconds_sum{method=\"%s\"} %.6f\n", method, stats.latency_sum_us / 1e6);
+        out += strprintf("bitcoin_rpc_latency_seconds_count{method=\"%s\"} %u\n", method, cumulative);
+    }
+    return out;
+}
+
+static void HTTPReq_Metrics(HTTPRequest* req)
+{
+    if (req->GetRequestMethod() != HTTPRequest::GET) {
+        req->WriteReply(HTTP_BAD_METHOD, "Metrics are only served for GET requests");
+        return;
     }
+    std::string user;
+    if (!CheckAuthorization(req, req->GetPeer().ToStringAddrPort(), user)) return;
+    // Scraping the metrics is subject to the same whitelist as the getrpcstats RPC
+    const bool user_has_whitelist{g_rpc_whitelist.contains(user)};
+    if (user_has_whitelist ? !g_rpc_whitelist[user].contains("getrpcstats") : g_rpc_whitelist_default) {
+        LogWarning("RPC User %s not allowed to call method getrpcstats", user);
+        req->WriteReply(HTTP_FORBIDDEN);
+        return;
+    }
+    req->WriteHeader("Content-Type", "text/plain; version=0.0.4");
+    req->WriteReply(HTTP_OK, FormatRPCMetrics(tableRPC.GetMethodStats()));
 }
 
 static bool InitRPCAuthentication()
@@ -341,12 +464,16 @@ bool StartHTTPRPC(const std::any& context)
     LogDebug(BCLog::RPC, "Starting HTTP RPC server\n");
     if (!InitRPCAuthentication())
         return false;
+    g_rpc_batch_threads = std::max<int>(gArgs.GetIntArg("-rpcbatchthreads", DEFAULT_RPC_BATCH_THREADS), 1);
 
     auto handle_rpc = [context](HTTPRequest* req, const std::string&) { return HTTPReq_JSONRPC(context, req); };
     RegisterHTTPHandler("/", true, handle_rpc);
     if (g_wallet_init_interface.HasWalletSupport()) {
         RegisterHTTPHandler("/wallet/", false, handle_rpc);
     }
+    if (gArgs.GetBoolArg("-rpcmetrics", DEFAULT_RPC_METRICS)) {
+        RegisterHTTPHandler("/metrics", true, [](HTTPRequest* req, const std::string&) { HTTPReq_Metrics(req); return true; });
+    }
     struct event_base* eventBase = EventBase();
     assert(eventBase);
     return true;
@@ -364,4 +491,5 @@ void StopHTTPRPC()
     if (g_wallet_init_interface.HasWalletSupport()) {
         UnregisterHTTPHandler("/wallet/", false);
     }
+    UnregisterHTTPHandler("/metrics", true);
 }
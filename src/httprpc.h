@@ -11,6 +11,12 @@ class JSONRPCRequest;
 class UniValue;
 enum HTTPStatusCode : int;
 
+/** Default for -rpcbatchthreads, the number of threads executing one batch request. Elements of a
+ *  batch may depend on earlier ones, e.g. unlocking a wallet before signing, so they run in order by default. */
+static constexpr int DEFAULT_RPC_BATCH_THREADS{1};
+/** Default for -rpcmetrics, serving RPC statistics for Prometheus at /metrics */
+static constexpr bool DEFAULT_RPC_METRICS{false};
+
 /** Start HTTP RPC subsystem.
  * Precondition; HTTP and RPC has been started.
  */
@@ -6,6 +6,7 @@
 
 #include <chainparamsbase.h>
 #include <common/args.h>
+#include <common/json_writer.h>
 #include <common/messages.h>
 #include <compat/compat.h>
 #include <logging.h>
@@ -20,6 +21,7 @@
 #include <util/threadpool.h>
 #include <util/translation.h>
 
+#include <chrono>
 #include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
@@ -270,6 +272,12 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
                 LogWarning("Unknown error while processing request for '%s'", req->GetURI());
                 err_msg = "unknown error";
             }
+            if (req->IsReplyStreaming()) {
+                // Headers and part of the body were sent already, so an error
+                // reply is not possible any more.
+                req->AbortReply();
+                return;
+            }
             // Reply so the client doesn't hang waiting for the response.
             req->WriteHeader("Connection", "close");
             // TODO: Implement specific error formatting for the REST and JSON-RPC servers responses.
@@ -529,6 +537,11 @@ HTTPRequest::HTTPRequest(struct evhttp_request* _req, const util::SignalInterrup
 
 HTTPRequest::~HTTPRequest()
 {
+    if (!replySent && m_reply_stream) {
+        // Part of the reply was sent already, don't let it look complete.
+        LogWarning("Unfinished HTTP reply");
+        AbortReply();
+    }
     if (!replySent) {
         // Keep track of whether reply was sent to avoid request leaks
         LogWarning("Unhandled HTTP request");
@@ -580,36 +593,227 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
  * Replies must be sent in the main loop in the main http thread,
  * this cannot be done from worker threads.
  */
+/** Re-enable reading from the socket. This is the second part of the libevent
+ * workaround above. */
+static void ReenableReading(evhttp_request* req)
+{
+    if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
+        evhttp_connection* conn = evhttp_request_get_connection(req);
+        if (conn) {
+            bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+            if (bev) {
+                bufferevent_enable(bev, EV_READ | EV_WRITE);
+            }
+        }
+    }
+}
+
 void HTTPRequest::WriteReply(int nStatus, std::span<const std::byte> reply)
 {
     assert(!replySent && req);
+    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
+    assert(evb);
+    if (m_reply_status) {
+        // A started reply is replaced, e.g. by an error reply. Nothing was
+        // sent yet, so drop what was held back.
+        assert(!m_reply_stream);
+        evbuffer_drain(evb, evbuffer_get_length(evb));
+        m_reply_status.reset();
+    }
     if (m_interrupt) {
         WriteHeader("Connection", "close");
     }
     // Send event to main http thread to send reply message
-    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
-    assert(evb);
     evbuffer_add(evb, reply.data(), reply.size());
     auto req_copy = req;
     HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
-        // Re-enable reading from the socket. This is the second part of the libevent
-        // workaround above.
-        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
-            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
-            if (conn) {
-                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
-                if (bev) {
-                    bufferevent_enable(bev, EV_READ | EV_WRITE);
-                }
+        ReenableReading(req_copy);
+    });
+    ev->trigger(nullptr);
+    replySent = true;
+    req = nullptr; // transferred back to main thread
+}
+
+void HTTPRequest::StartReply(int nStatus)
+{
+    assert(!replySent && req && !m_reply_status);
+    if (m_interrupt) {
+        WriteHeader("Connection", "close");
+    }
+    m_reply_status = nStatus;
+}
+
+/** Flow control of a reply sent in chunks, shared by the worker writing it and the main http thread sending it. */
+struct HTTPReplyStream {
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    //! Size of the chunks handed to the main http thread that were not written to the client yet
+    size_t m_queued GUARDED_BY(m_mutex){0};
+    //! Size of the chunks in m_queued that were added to the connection's output buffer
+    size_t m_buffered GUARDED_BY(m_mutex){0};
+    //! The rest of the body is dropped, because the client is gone or the node is shutting down
+    bool m_dropped GUARDED_BY(m_mutex){false};
+};
+
+/** Maximum size of the chunks of a reply waiting to be written to the client before the writer blocks. */
+static constexpr size_t MAX_QUEUED_REPLY_BYTES{1 << 20};
+
+/** Called by libevent in the main http thread when the connection's output buffer was written out. */
+static void ReplyChunksWritten(evhttp_connection*, void* arg)
+{
+    HTTPReplyStream& stream{*static_cast<HTTPReplyStream*>(arg)};
+    LOCK(stream.m_mutex);
+    stream.m_queued -= stream.m_buffered;
+    stream.m_buffered = 0;
+    stream.m_cv.notify_all();
+}
+
+/** Hand a chunk to libevent in the main http thread, to be written to the client. */
+static void SendReplyChunk(evhttp_request* req, evbuffer* chunk, HTTPReplyStream& stream)
+{
+    WITH_LOCK(stream.m_mutex, stream.m_buffered += evbuffer_get_length(chunk));
+    // This does nothing if the client is gone
+    evhttp_send_reply_chunk_with_cb(req, chunk, ReplyChunksWritten, &stream);
+}
+
+void HTTPRequest::WriteReplyChunk(std::span<const std::byte> chunk)
+{
+    assert(!replySent && req && m_reply_status);
+    if (chunk.empty()) return;
+    struct evbuffer* evb = evhttp_request_get_output_buffer(req);
+    assert(evb);
+    if (!m_reply_stream) {
+        const bool can_chunk{(req->major > 1 || (req->major == 1 && req->minor >= 1)) &&
+                             evhttp_request_get_command(req) != EVHTTP_REQ_HEAD};
+        if (evbuffer_get_length(evb) == 0 || !can_chunk) {
+            // Hold back the first chunk, it may be the only one.
+            evbuffer_add(evb, chunk.data(), chunk.size());
+            return;
+        }
+        m_reply_stream = std::make_shared<HTTPReplyStream>();
+        WITH_LOCK(m_reply_stream->m_mutex, m_reply_stream->m_queued = evbuffer_get_length(evb));
+        // Send the headers and the held back chunk from the main http thread.
+        // Events are handled in the order they are triggered. The stream is
+        // kept alive by the events until EndReply() or AbortReply() replace
+        // or remove the callback libevent was given.
+        auto req_copy = req;
+        HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus = *m_reply_status, stream = m_reply_stream]{
+            struct evbuffer* first = evbuffer_new();
+            evbuffer_add_buffer(first, evhttp_request_get_output_buffer(req_copy));
+            evhttp_send_reply_start(req_copy, nStatus, nullptr);
+            SendReplyChunk(req_copy, first, *stream);
+            evbuffer_free(first);
+        });
+        ev->trigger(nullptr);
+    }
+    {
+        HTTPReplyStream& stream{*m_reply_stream};
+        WAIT_LOCK(stream.m_mutex, lock);
+        // Wait for a slow client, instead of queueing up the whole body in memory
+        while (!stream.m_dropped && stream.m_queued >= MAX_QUEUED_REPLY_BYTES) {
+            if (m_interrupt) {
+                stream.m_dropped = true;
+            } else if (stream.m_cv.wait_for(lock, std::chrono::seconds{1}) == std::cv_status::timeout) {
+                // Nothing is reported once the client is gone, so check for that
+                auto req_copy = req;
+                HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, stream = m_reply_stream]{
+                    if (evhttp_request_get_connection(req_copy)) return;
+                    LOCK(stream->m_mutex);
+                    stream->m_dropped = true;
+                    stream->m_cv.notify_all();
+                });
+                ev->trigger(nullptr);
             }
         }
+        if (stream.m_dropped) return;
+        stream.m_queued += chunk.size();
+    }
+    struct evbuffer* buf = evbuffer_new();
+    assert(buf);
+    evbuffer_add(buf, chunk.data(), chunk.size());
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, buf, stream = m_reply_stream]{
+        SendReplyChunk(req_copy, buf, *stream);
+        evbuffer_free(buf);
     });
     ev->trigger(nullptr);
+}
+
+void HTTPRequest::EndReply()
+{
+    assert(!replySent && req && m_reply_status);
+    if (m_reply_stream && WITH_LOCK(m_reply_stream->m_mutex, return m_reply_stream->m_dropped)) {
+        // Part of the body was not sent
+        AbortReply();
+        return;
+    }
+    if (!m_reply_stream) {
+        // Everything was held back, send it as a regular reply.
+        auto req_copy = req;
+        HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus = *m_reply_status]{
+            evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
+            ReenableReading(req_copy);
+        });
+        ev->trigger(nullptr);
+    } else {
+        auto req_copy = req;
+        HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, stream = m_reply_stream]{
+            evhttp_send_reply_end(req_copy);
+            ReenableReading(req_copy);
+        });
+        ev->trigger(nullptr);
+    }
+    m_reply_status.reset();
+    m_reply_stream.reset();
     replySent = true;
     req = nullptr; // transferred back to main thread
 }
 
+void HTTPRequest::AbortReply()
+{
+    assert(!replySent && req && m_reply_stream);
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, stream = m_reply_stream]{
+        if (evhttp_connection* conn{evhttp_request_get_connection(req_copy)}) {
+            // Also frees the request
+            evhttp_connection_free(conn);
+        } else {
+            // The client is gone already, which leaves the request to us
+            evhttp_request_free(req_copy);
+        }
+    });
+    ev->trigger(nullptr);
+    m_reply_status.reset();
+    m_reply_stream.reset();
+    replySent = true;
+    req = nullptr; // transferred back to main thread
+}
+
+bool SubmitHTTPWork(std::function<void()> fn)
+{
+    if (static_cast<int>(g_threadpool_http.WorkQueueSize()) >= g_max_queue_depth) return false;
+    auto task{[fn = std::move(fn)] {
+        try {
+            fn();
+        } catch (const std::exception& e) {
+            LogWarning("Unexpected error in http work item: %s", e.what());
+        }
+    }};
+    return g_threadpool_http.Submit(std::move(task)).has_value();
+}
+
+uint64_t WriteJSONReply(HTTPRequest& req, int nStatus, const std::function<void(JsonWriter&)>& write_json)
+{
+    req.WriteHeader("Content-Type", "application/json");
+    req.StartReply(nStatus);
+    JsonWriter writer{[&](std::string_view chunk) { req.WriteReplyChunk(chunk); }};
+    write_json(writer);
+    writer.Finish();
+    req.EndReply();
+    return writer.BytesWritten();
+}
+
 CService HTTPRequest::GetPeer() const
 {
     evhttp_connection* con = evhttp_request_get_connection(req);
@@ -5,7 +5,9 @@
 #ifndef BITCOIN_HTTPSERVER_H
 #define BITCOIN_HTTPSERVER_H
 
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string>
@@ -31,6 +33,7 @@ struct evhttp_request;
 struct event_base;
 class CService;
 class HTTPRequest;
+class JsonWriter;
 
 /** Initialize HTTP server.
  * Call this before RegisterHTTPHandler or EventBase().
@@ -59,6 +62,14 @@ void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPR
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
+/**
+ * Queue fn on the HTTP worker threads, e.g. to spread the work of a single
+ * request over several threads. Returns false if it was not queued because the
+ * workers are not running or the work queue is full, in which case the caller
+ * has to do the work itself.
+ */
+bool SubmitHTTPWork(std::function<void()> fn);
+
 /** Return evhttp event base. This can be used by submodules to
  * queue timers or custom events.
  */
@@ -67,12 +78,18 @@ struct event_base* EventBase();
 /** In-flight HTTP request.
  * Thin C++ wrapper around evhttp_request.
  */
+struct HTTPReplyStream;
+
 class HTTPRequest
 {
 private:
     struct evhttp_request* req;
     const util::SignalInterrupt& m_interrupt;
     bool replySent;
+    //! Status of a reply started with StartReply() whose body is still being written.
+    std::optional<int> m_reply_status;
+    //! Flow control of the started reply once it is being sent to the client in chunks.
+    std::shared_ptr<HTTPReplyStream> m_reply_stream;
 
 public:
     explicit HTTPRequest(struct evhttp_request* req, const util::SignalInterrupt& interrupt, bool replySent = false);
@@ -143,8 +160,54 @@ public:
         WriteReply(nStatus, std::as_bytes(std::span{reply}));
     }
     void WriteReply(int nStatus, std::span<const std::byte> reply);
+
+    /**
+     * Start a reply whose body is written incrementally with WriteReplyChunk()
+     * and completed with EndReply(). Write headers before calling this.
+     *
+     * The first chunk is held back, so a body that fits into a single chunk is
+     * sent like a WriteReply() one. Larger bodies are sent to HTTP/1.1 clients
+     * with chunked transfer encoding as they are written, and buffered for
+     * others. WriteReplyChunk() blocks while too much of the body waits to be
+     * sent to the client, and drops the rest of the body once the client is
+     * gone or the node is shutting down.
+     */
+    void StartReply(int nStatus);
+    void WriteReplyChunk(std::string_view chunk)
+    {
+        WriteReplyChunk(std::as_bytes(std::span{chunk}));
+    }
+    void WriteReplyChunk(std::span<const std::byte> chunk);
+
+    /**
+     * Complete a reply started with StartReply().
+     *
+     * @note As this will give the request back to the main thread, do not call
+     * any other HTTPRequest methods after calling this.
+     */
+    void EndReply();
+
+    /**
+     * Abandon a reply that is being sent in chunks. The connection is closed
+     * without terminating the body, so the client can tell it is incomplete.
+     *
+     * @note As this will give the request back to the main thread, do not call
+     * any other HTTPRequest methods after calling this.
+     */
+    void AbortReply();
+
+    /** Whether headers and part of the body of a started reply were sent already. */
+    bool IsReplyStreaming() const { return m_reply_stream != nullptr; }
 };
 
+/**
+ * Reply to req with the JSON document produced by write_json, followed by a
+ * newline. The document is sent to the client while it is being produced.
+ * Anything that can fail with an error reply must be checked before.
+ * @returns the size of the document in bytes
+ */
+uint64_t WriteJSONReply(HTTPRequest& req, int nStatus, const std::function<void(JsonWriter&)>& write_json);
+
 /** Get the query parameter value from request uri for a specified key, or std::nullopt if the key
  * is not found.
  *
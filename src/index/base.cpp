@@ -26,6 +26,7 @@
 #include <util/string.h>
 #include <util/thread.h>
 #include <util/threadinterrupt.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <validation.h>
@@ -33,7 +34,9 @@
 
 #include <compare>
 #include <cstdint>
+#include <deque>
 #include <functional>
+#include <future>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -48,6 +51,18 @@ constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
+//! Number of blocks being prepared ahead of the last appended block per worker
+//! thread during a parallel sync. Bounds the memory used for block data.
+constexpr size_t SYNC_BLOCKS_PER_WORKER{2};
+
+struct BaseIndex::PreparedBlock {
+    std::shared_ptr<const CBlock> block{};
+    //! Only set if the index connects undo data.
+    std::shared_ptr<const CBlockUndo> undo{};
+    std::any result{};
+    //! Set if the block could not be read.
+    std::string error{};
+};
 
 template <typename... Args>
 void BaseIndex::FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args)
@@ -204,15 +219,91 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
     return true;
 }
 
+BaseIndex::PreparedBlock BaseIndex::PrepareBlock(const CBlockIndex* pindex, bool connect_undo, IndexBlockReader::Consumer* reader) const
+{
+    PreparedBlock prepared;
+    if (reader) {
+        auto [block, undo] = reader->Read(*pindex, connect_undo);
+        prepared.block = std::move(block);
+        if (connect_undo) prepared.undo = std::move(undo);
+    } else {
+        auto block{std::make_shared<CBlock>()};
+        if (m_chainstate->m_blockman.ReadBlock(*block, *pindex)) prepared.block = std::move(block);
+        if (prepared.block && connect_undo) {
+            auto undo{std::make_shared<CBlockUndo>()};
+            if (pindex->nHeight == 0 || m_chainstate->m_blockman.ReadBlockUndo(*undo, *pindex)) prepared.undo = std::move(undo);
+        }
+    }
+    if (!prepared.block) {
+        prepared.error = strprintf("Failed to read block %s from disk", pindex->GetBlockHash().ToString());
+        return prepared;
+    }
+    if (connect_undo && !prepared.undo) {
+        prepared.error = strprintf("Failed to read undo block data %s from disk", pindex->GetBlockHash().ToString());
+        return prepared;
+    }
+
+    interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, prepared.block.get());
+    block_info.undo_data = prepared.undo.get();
+    prepared.result = CustomPrepare(block_info);
+    return prepared;
+}
+
+bool BaseIndex::AppendPreparedBlock(const CBlockIndex* pindex, PreparedBlock& prepared)
+{
+    if (!prepared.error.empty()) {
+        FatalErrorf("%s", prepared.error);
+        return false;
+    }
+
+    interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, prepared.block.get());
+    block_info.undo_data = prepared.undo.get();
+
+    if (!CustomAppendPrepared(block_info, std::move(prepared.result))) {
+        FatalErrorf("Failed to write block %s to index database",
+                    pindex->GetBlockHash().ToString());
+        return false;
+    }
+
+    return true;
+}
+
 void BaseIndex::Sync()
 {
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
         auto last_log_time{NodeClock::now()};
         auto last_locator_write_time{last_log_time};
+
+        const bool connect_undo{CustomOptions().connect_undo_data};
+        // Registration with the block reader shared with other syncing indexes
+        std::optional<IndexBlockReader::Consumer> reader;
+        if (m_block_reader) reader.emplace(*m_block_reader, connect_undo, pindex ? pindex->nHeight : -1);
+        IndexBlockReader::Consumer* const reader_ptr{reader ? &*reader : nullptr};
+
+        // Blocks following pindex in the active chain that are being prepared
+        // on the thread pool, in height order. Only used for a parallel sync.
+        std::deque<std::pair<const CBlockIndex*, std::future<PreparedBlock>>> window;
+        const size_t workers{m_thread_pool && AllowParallelSync() ? m_thread_pool->WorkersCount() : 0};
+        const size_t window_size{workers * SYNC_BLOCKS_PER_WORKER};
+        const auto prepare_async = [&](const CBlockIndex* block) {
+            auto task = [this, block, connect_undo, reader_ptr] { return PrepareBlock(block, connect_undo, reader_ptr); };
+            if (auto future{m_thread_pool->Submit(task)}) return std::move(*future);
+            // The pool is shutting down, prepare the block on this thread.
+            std::promise<PreparedBlock> promise;
+            promise.set_value(task());
+            return promise.get_future();
+        };
+        // Tasks refer to this object, so wait for them before leaving.
+        const auto drain_window = [&] {
+            for (auto& [block, future] : window) future.wait();
+            window.clear();
+        };
+
         while (true) {
             if (m_interrupt) {
                 LogInfo("%s: m_interrupt set; exiting ThreadSync", GetName());
+                drain_window();
 
                 SetBestBlockIndex(pindex);
                 // No need to handle errors in Commit. If it fails, the error will be already be
@@ -222,7 +313,15 @@ void BaseIndex::Sync()
                 return;
             }
 
-            const CBlockIndex* pindex_next = WITH_LOCK(cs_main, return NextSyncBlock(pindex, m_chainstate->m_chain));
+            // Don't read further ahead of the other indexes while the shared
+            // buffer is full, so they can catch up on the blocks read for them.
+            if (reader && !reader->WaitForCapacity(m_interrupt)) continue;
+
+            // Blocks in the window always connect to pindex. If they have been
+            // reorged out in the meantime, the next call to NextSyncBlock once
+            // the window is drained rewinds the index.
+            const CBlockIndex* pindex_next = !window.empty() ? window.front().first :
+                                             WITH_LOCK(cs_main, return NextSyncBlock(pindex, m_chainstate->m_chain));
             // If pindex_next is null, it means pindex is the chain tip, so
             // commit data indexed so far.
             if (!pindex_next) {
@@ -248,8 +347,25 @@ void BaseIndex::Sync()
             }
             pindex = pindex_next;
 
-
-            if (!ProcessBlock(pindex)) return; // error logged internally
+            if (window_size > 0) {
+                if (window.empty()) window.emplace_back(pindex, prepare_async(pindex));
+                // Keep the workers busy with the blocks following pindex
+                while (window.size() < window_size) {
+                    const CBlockIndex* next{WITH_LOCK(cs_main, return m_chainstate->m_chain.Next(*window.back().first))};
+                    if (!next) break;
+                    window.emplace_back(next, prepare_async(next));
+                }
+                PreparedBlock prepared{window.front().second.get()};
+                window.pop_front();
+                if (!AppendPreparedBlock(pindex, prepared)) { // error logged internally
+                    drain_window();
+                    return;
+                }
+            } else {
+                PreparedBlock prepared{PrepareBlock(pindex, connect_undo, reader_ptr)};
+                if (!AppendPreparedBlock(pindex, prepared)) return; // error logged internally
+            }
+            if (reader) reader->SetHeight(pindex->nHeight);
 
             auto current_time{NodeClock::now()};
             if (current_time - last_log_time >= SYNC_LOG_INTERVAL) {
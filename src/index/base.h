@@ -7,6 +7,7 @@
 
 #include <attributes.h>
 #include <dbwrapper.h>
+#include <index/blockreader.h>
 #include <interfaces/chain.h>
 #include <kernel/cs_main.h>
 #include <sync.h>
@@ -15,6 +16,7 @@
 #include <util/threadinterrupt.h>
 #include <validationinterface.h>
 
+#include <any>
 #include <atomic>
 #include <cstddef>
 #include <memory>
@@ -25,8 +27,15 @@
 class CBlock;
 class CBlockIndex;
 class Chainstate;
+class ThreadPool;
 
 struct CBlockLocator;
+
+/** Default for -indexworkers, the number of threads preparing blocks during the initial index sync. */
+static constexpr int DEFAULT_INDEX_WORKERS{0};
+/** Maximum for -indexworkers. */
+static constexpr int MAX_INDEX_WORKERS{64};
+
 struct IndexSummary {
     std::string name;
     bool synced{false};
@@ -93,6 +102,18 @@ private:
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
+    /// Worker threads used to prepare blocks during the initial sync, if
+    /// AllowParallelSync(). Not owned.
+    ThreadPool* m_thread_pool{nullptr};
+
+    /// Source of block data shared with other indexes syncing at the same
+    /// time. Not owned.
+    IndexBlockReader* m_block_reader{nullptr};
+
+    /// Block data read by a sync worker, together with the result of
+    /// CustomPrepare for it.
+    struct PreparedBlock;
+
     /// Write the current index state (eg. chain block locator and subclass-specific items) to disk.
     ///
     /// Recommendations for error handling:
@@ -108,6 +129,14 @@ private:
 
     bool ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data = nullptr);
 
+    /// Read the block and undo data, through the shared block reader if there
+    /// is one, and run CustomPrepare on it. Called on the worker threads
+    /// during a parallel sync.
+    PreparedBlock PrepareBlock(const CBlockIndex* pindex, bool connect_undo, IndexBlockReader::Consumer* reader) const;
+
+    /// Pass a prepared block to CustomAppendPrepared. Called in height order.
+    bool AppendPreparedBlock(const CBlockIndex* pindex, PreparedBlock& prepared);
+
     virtual bool AllowPrune() const = 0;
 
     template <typename... Args>
@@ -128,6 +157,21 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Whether the per-block work of the index is split into CustomPrepare
+    /// and CustomAppendPrepared, so the initial sync can prepare several
+    /// blocks concurrently.
+    virtual bool AllowParallelSync() const { return false; }
+
+    /// Compute the index entries for a block without modifying any index
+    /// state. Only called if AllowParallelSync(), possibly concurrently for
+    /// different blocks and out of order. The result must not refer to the
+    /// block data, which does not outlive the call.
+    [[nodiscard]] virtual std::any CustomPrepare(const interfaces::BlockInfo& block) const { return {}; }
+
+    /// Write the index entries computed by CustomPrepare for a block. Called in
+    /// height order, like CustomAppend.
+    [[nodiscard]] virtual bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) { return CustomAppend(block); }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
@@ -164,6 +208,16 @@ public:
     /// validation interface so that it stays in sync with blockchain updates.
     [[nodiscard]] bool Init();
 
+    /// Use the given thread pool to prepare blocks in parallel during the
+    /// initial sync. Has no effect unless AllowParallelSync(). Must be called
+    /// before StartBackgroundSync, and the pool must outlive the sync thread.
+    void SetThreadPool(ThreadPool& thread_pool) { m_thread_pool = &thread_pool; }
+
+    /// Read blocks through the given reader during the initial sync, sharing
+    /// them with other indexes. Must be called before StartBackgroundSync, and
+    /// the reader must outlive the sync thread.
+    void SetBlockReader(IndexBlockReader& block_reader) { m_block_reader = &block_reader; }
+
     /// Starts the initial sync process on a background thread.
     [[nodiscard]] bool StartBackgroundSync();
 
@@ -24,6 +24,7 @@
 #include <util/log.h>
 #include <util/syserror.h>
 
+#include <any>
 #include <cerrno>
 #include <exception>
 #include <map>
@@ -249,7 +250,18 @@ std::optional<uint256> BlockFilterIndex::ReadFilterHeader(int height, const uint
 
 bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
 {
-    BlockFilter filter(m_filter_type, *Assert(block.data), *Assert(block.undo_data));
+    return CustomAppendPrepared(block, CustomPrepare(block));
+}
+
+std::any BlockFilterIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    return BlockFilter(m_filter_type, *Assert(block.data), *Assert(block.undo_data));
+}
+
+bool BlockFilterIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    // The filter header commits to the previous one, so it is computed here in height order.
+    const BlockFilter& filter{std::any_cast<const BlockFilter&>(prepared)};
     const uint256& header = filter.ComputeHeader(m_last_header);
     bool res = Write(filter, block.height, header);
     if (res) m_last_header = header; // update last header
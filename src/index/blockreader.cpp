@@ -0,0 +1,202 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/blockreader.h>
+
+#include <chain.h>
+#include <node/blockstorage.h>
+#include <primitives/block.h>
+#include <serialize.h>
+#include <undo.h>
+#include <util/check.h>
+#include <util/threadinterrupt.h>
+#include <util/time.h>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <utility>
+#include <vector>
+
+//! How often waiting consumers check whether they have been interrupted.
+static constexpr auto INTERRUPT_CHECK_INTERVAL{100ms};
+
+IndexBlockReader::Consumer::Consumer(IndexBlockReader& reader, bool need_undo, int height)
+    : m_reader{reader}
+{
+    m_reader.Register(*this, need_undo, height);
+}
+
+IndexBlockReader::Consumer::~Consumer()
+{
+    m_reader.Unregister(*this);
+}
+
+IndexBlockReader::IndexBlockReader(const node::BlockManager& blockman, size_t max_usage, int max_gap)
+    : m_blockman{blockman}, m_max_usage{max_usage}, m_max_gap{max_gap} {}
+
+IndexBlockReader::~IndexBlockReader()
+{
+    LOCK(m_mutex);
+    Assume(m_consumers.empty());
+}
+
+void IndexBlockReader::Register(const Consumer& consumer, bool need_undo, int height)
+{
+    LOCK(m_mutex);
+    m_consumers.emplace(&consumer, ConsumerState{.height = height, .need_undo = need_undo});
+}
+
+void IndexBlockReader::Unregister(const Consumer& consumer)
+{
+    {
+        LOCK(m_mutex);
+        m_consumers.erase(&consumer);
+        Prune();
+    }
+    m_cv.notify_all();
+}
+
+void IndexBlockReader::SetHeight(const Consumer& consumer, int height)
+{
+    {
+        LOCK(m_mutex);
+        m_consumers.at(&consumer).height = height;
+        Prune();
+    }
+    m_cv.notify_all();
+}
+
+bool IndexBlockReader::HasConsumerBehind(const Consumer& consumer, int height) const
+{
+    AssertLockHeld(m_mutex);
+    return std::ranges::any_of(m_consumers, [&](const auto& other) {
+        return other.first != &consumer && other.second.height < height && other.second.height >= height - m_max_gap;
+    });
+}
+
+void IndexBlockReader::Prune()
+{
+    AssertLockHeld(m_mutex);
+    // Heights of the blocks each consumer may still get from the buffer, as [first, last] ranges
+    std::vector<std::pair<int, int>> ranges;
+    ranges.reserve(m_consumers.size());
+    for (const auto& [_, state] : m_consumers) ranges.emplace_back(state.height + 1, state.height + m_max_gap);
+    std::ranges::sort(ranges);
+
+    // Drop the data of the blocks at heights in [from, to)
+    const auto erase{[&](int from, int to) EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+        const auto begin{m_heights.lower_bound(from)};
+        const auto end{m_heights.lower_bound(to)};
+        for (auto it{begin}; it != end; ++it) EraseEntry(it->second);
+        m_heights.erase(begin, end);
+    }};
+    int next{std::numeric_limits<int>::min()};
+    for (const auto& [first, last] : ranges) {
+        if (first > next) erase(next, first);
+        next = std::max(next, last + 1);
+    }
+    erase(next, std::numeric_limits<int>::max());
+}
+
+void IndexBlockReader::EraseEntry(const uint256& hash)
+{
+    AssertLockHeld(m_mutex);
+    const auto it{m_entries.find(hash)};
+    if (it == m_entries.end()) return;
+    m_usage -= it->second.usage;
+    m_entries.erase(it);
+}
+
+bool IndexBlockReader::WaitForCapacity(const Consumer& consumer, const CThreadInterrupt& interrupt)
+{
+    WAIT_LOCK(m_mutex, lock);
+    while (m_usage >= m_max_usage && HasConsumerBehind(consumer, m_consumers.at(&consumer).height)) {
+        if (interrupt) return false;
+        m_cv.wait_for(lock, INTERRUPT_CHECK_INTERVAL);
+    }
+    return !interrupt;
+}
+
+IndexBlockReader::BlockData IndexBlockReader::Read(const Consumer& consumer, const CBlockIndex& index, bool need_undo)
+{
+    const uint256 hash{index.GetBlockHash()};
+    BlockData data;
+    bool share{false};
+    bool read_undo{need_undo};
+    {
+        WAIT_LOCK(m_mutex, lock);
+        while (true) {
+            const auto it{m_entries.find(hash)};
+            if (it == m_entries.end()) break;
+            if (it->second.reading) {
+                // Another consumer is reading this block, wait for its result
+                m_cv.wait(lock);
+                continue;
+            }
+            if (!need_undo || it->second.undo) {
+                ++m_stats.shared_reads;
+                data.block = it->second.block;
+                if (need_undo) data.undo = it->second.undo;
+                return data;
+            }
+            // Buffered without undo data, which was not needed by anyone yet
+            break;
+        }
+
+        // Keep the data if a consumer other than this one, not too far behind, still has to
+        // process the block
+        for (const auto& [other, state] : m_consumers) {
+            if (other == &consumer || state.height >= index.nHeight || state.height < index.nHeight - m_max_gap) continue;
+            share = true;
+            read_undo |= state.need_undo;
+        }
+        if (share) {
+            EraseEntry(hash);
+            m_entries.emplace(hash, Entry{.height = index.nHeight});
+            m_heights.emplace(index.nHeight, hash);
+        }
+        ++m_stats.disk_reads;
+    }
+
+    auto block{std::make_shared<CBlock>()};
+    if (m_blockman.ReadBlock(*block, index)) data.block = std::move(block);
+    if (data.block && read_undo) {
+        auto undo{std::make_shared<CBlockUndo>()};
+        if (index.nHeight == 0 || m_blockman.ReadBlockUndo(*undo, index)) data.undo = std::move(undo);
+    }
+
+    if (share) {
+        {
+            LOCK(m_mutex);
+            // The entry may have been dropped while reading, once all other consumers moved on
+            if (const auto it{m_entries.find(hash)}; it != m_entries.end() && it->second.reading) {
+                Entry& entry{it->second};
+                if (data.block && (!read_undo || data.undo)) {
+                    entry.block = data.block;
+                    entry.undo = data.undo;
+                    entry.usage = ::GetSerializeSize(TX_WITH_WITNESS(*entry.block));
+                    if (entry.undo) entry.usage += ::GetSerializeSize(*entry.undo);
+                    entry.reading = false;
+                    m_usage += entry.usage;
+                } else {
+                    // Let waiting consumers retry and report the error themselves
+                    m_entries.erase(it);
+                }
+            }
+        }
+        m_cv.notify_all();
+    }
+    return data;
+}
+
+IndexBlockReader::Stats IndexBlockReader::GetStats() const
+{
+    LOCK(m_mutex);
+    Stats stats{m_stats};
+    stats.usage = m_usage;
+    stats.entries = m_entries.size();
+    stats.consumers = m_consumers.size();
+    return stats;
+}
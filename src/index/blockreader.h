@@ -0,0 +1,151 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_BLOCKREADER_H
+#define BITCOIN_INDEX_BLOCKREADER_H
+
+#include <sync.h>
+#include <uint256.h>
+#include <util/byte_units.h>
+#include <util/hasher.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+class CBlock;
+class CBlockIndex;
+class CBlockUndo;
+class CThreadInterrupt;
+namespace node {
+class BlockManager;
+} // namespace node
+
+/** Maximum amount of block and undo data buffered for indexes that lag behind others. */
+static constexpr size_t DEFAULT_INDEX_BLOCK_BUFFER{64_MiB};
+/** Maximum number of blocks an index can be behind another one to share its reads. */
+static constexpr int DEFAULT_INDEX_SHARED_READ_GAP{144};
+/** Default for -indexsharedreads. */
+static constexpr bool DEFAULT_INDEX_SHARED_READS{true};
+
+/**
+ * Shared source of block and undo data for indexes that sync at the same time.
+ *
+ * Every syncing index registers as a Consumer, which tracks the height it has
+ * indexed up to. When a consumer reads a block that another consumer at most
+ * max_gap blocks behind still has to index, the data is kept in a buffer until
+ * no such consumer is left, so each block is read from disk once instead of
+ * once per index. Concurrent reads of the same block are also merged into one.
+ *
+ * The buffer is bounded: consumers with another one at most max_gap blocks
+ * behind them wait in WaitForCapacity() before reading more blocks while the
+ * buffer is full, which keeps indexes that start together reading the chain
+ * together. Consumers further apart read on their own, so an index that is
+ * almost synced is not held back by one starting from genesis. The slowest
+ * consumer never waits, so progress is always possible.
+ */
+class IndexBlockReader
+{
+public:
+    struct BlockData {
+        std::shared_ptr<const CBlock> block;
+        //! Only set if undo data was requested.
+        std::shared_ptr<const CBlockUndo> undo;
+    };
+
+    struct Stats {
+        size_t usage{0};
+        size_t entries{0};
+        size_t consumers{0};
+        uint64_t disk_reads{0};
+        uint64_t shared_reads{0};
+    };
+
+    /** Registration of a syncing index with the reader. */
+    class Consumer
+    {
+    public:
+        /**
+         * @param[in] need_undo  Whether the index reads undo data.
+         * @param[in] height     Height of the last block the index has processed, or -1.
+         */
+        Consumer(IndexBlockReader& reader, bool need_undo, int height);
+        ~Consumer();
+
+        Consumer(const Consumer&) = delete;
+        Consumer& operator=(const Consumer&) = delete;
+
+        /** Record that the index has processed all blocks up to the given height. */
+        void SetHeight(int height) { m_reader.SetHeight(*this, height); }
+
+        /**
+         * Wait while the buffer is full and other indexes are behind this one.
+         *
+         * @return false if interrupted.
+         */
+        bool WaitForCapacity(const CThreadInterrupt& interrupt) { return m_reader.WaitForCapacity(*this, interrupt); }
+
+        /**
+         * Read a block, and its undo data if requested. Can be called from
+         * any thread. On failure to read, the corresponding member of the
+         * result is null.
+         */
+        BlockData Read(const CBlockIndex& index, bool need_undo) { return m_reader.Read(*this, index, need_undo); }
+
+    private:
+        IndexBlockReader& m_reader;
+    };
+
+    IndexBlockReader(const node::BlockManager& blockman, size_t max_usage, int max_gap = DEFAULT_INDEX_SHARED_READ_GAP);
+    ~IndexBlockReader();
+
+    Stats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct ConsumerState {
+        int height{-1};
+        bool need_undo{false};
+    };
+
+    struct Entry {
+        int height{0};
+        std::shared_ptr<const CBlock> block{};
+        std::shared_ptr<const CBlockUndo> undo{};
+        size_t usage{0};
+        //! Set while a consumer is reading the data from disk.
+        bool reading{true};
+    };
+
+    void Register(const Consumer& consumer, bool need_undo, int height) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void Unregister(const Consumer& consumer) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void SetHeight(const Consumer& consumer, int height) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    bool WaitForCapacity(const Consumer& consumer, const CThreadInterrupt& interrupt) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    BlockData Read(const Consumer& consumer, const CBlockIndex& index, bool need_undo) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Whether a consumer other than the given one is at most m_max_gap blocks below height.
+    bool HasConsumerBehind(const Consumer& consumer, int height) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    //! Drop the data that no consumer at most m_max_gap blocks behind it has to process.
+    void Prune() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void EraseEntry(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+    const node::BlockManager& m_blockman;
+    const size_t m_max_usage;
+    const int m_max_gap;
+
+    mutable Mutex m_mutex;
+    //! Signalled when buffered data is added or dropped, and when consumers make progress.
+    std::condition_variable m_cv;
+
+    std::map<const Consumer*, ConsumerState> m_consumers GUARDED_BY(m_mutex);
+    std::unordered_map<uint256, Entry, SaltedUint256Hasher> m_entries GUARDED_BY(m_mutex);
+    //! Buffered blocks by height, to drop them in order.
+    std::multimap<int, uint256> m_heights GUARDED_BY(m_mutex);
+    size_t m_usage GUARDED_BY(m_mutex){0};
+    Stats m_stats GUARDED_BY(m_mutex);
+};
+
+#endif // BITCOIN_INDEX_BLOCKREADER_H
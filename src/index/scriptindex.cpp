@@ -0,0 +1,257 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/scriptindex.h>
+
+#include <common/args.h>
+#include <crypto/sha256.h>
+#include <dbwrapper.h>
+#include <index/base.h>
+#include <interfaces/chain.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <streams.h>
+#include <uint256.h>
+#include <undo.h>
+#include <util/check.h>
+#include <util/fs.h>
+#include <util/strencodings.h>
+
+#include <any>
+#include <exception>
+#include <ios>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* For every entry, the database stores a key made of
+ * [DB_SCRIPTINDEX, SHA256(scriptPubKey), height (BE), entry type, outpoint]
+ * with the value of the output, and for spending entries also the spending input.
+ * The hash prefix and the big-endian height make the history of a script one contiguous
+ * key range in height order, which is read with a single iterator.
+ */
+constexpr uint8_t DB_SCRIPTINDEX{'s'};
+
+std::unique_ptr<ScriptIndex> g_scriptindex;
+
+namespace {
+struct DBKey {
+    uint256 script_hash{};
+    uint32_t height{0};
+    uint8_t type{0};
+    COutPoint outpoint{Txid{}, 0};
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_SCRIPTINDEX);
+        s << script_hash;
+        ser_writedata32be(s, height);
+        ser_writedata8(s, type);
+        s << outpoint;
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        if (ser_readdata8(s) != DB_SCRIPTINDEX) {
+            throw std::ios_base::failure("Invalid format for script index DB key");
+        }
+        s >> script_hash;
+        height = ser_readdata32be(s);
+        type = ser_readdata8(s);
+        s >> outpoint;
+    }
+};
+
+struct FundingValue {
+    CAmount amount{0};
+
+    SERIALIZE_METHODS(FundingValue, obj) { READWRITE(VARINT_MODE(obj.amount, VarIntMode::NONNEGATIVE_SIGNED)); }
+};
+
+struct SpendingValue {
+    CAmount amount{0};
+    Txid spending_txid{};
+    uint32_t spending_input{0};
+
+    SERIALIZE_METHODS(SpendingValue, obj)
+    {
+        READWRITE(VARINT_MODE(obj.amount, VarIntMode::NONNEGATIVE_SIGNED), obj.spending_txid, VARINT(obj.spending_input));
+    }
+};
+
+uint256 HashScript(const CScript& script)
+{
+    uint256 hash;
+    CSHA256().Write(script.data(), script.size()).Finalize(hash.begin());
+    return hash;
+}
+
+DBKey MakeKey(const uint256& script_hash, const ScriptIndexEntry& entry)
+{
+    return DBKey{
+        .script_hash = script_hash,
+        .height = static_cast<uint32_t>(entry.height),
+        .type = static_cast<uint8_t>(entry.type),
+        .outpoint = entry.outpoint,
+    };
+}
+} // namespace
+
+ScriptIndex::ScriptIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "scriptindex"), m_db{std::make_unique<DB>(gArgs.GetDataDirNet() / "indexes" / "scriptindex" / "db", n_cache_size, f_memory, f_wipe)}
+{}
+
+ScriptIndex::~ScriptIndex() = default;
+
+interfaces::Chain::NotifyOptions ScriptIndex::CustomOptions()
+{
+    interfaces::Chain::NotifyOptions options;
+    options.connect_undo_data = true;
+    options.disconnect_data = true;
+    options.disconnect_undo_data = true;
+    return options;
+}
+
+ScriptIndex::Entries ScriptIndex::BuildEntries(const interfaces::BlockInfo& block) const
+{
+    Entries entries;
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height == 0) return entries;
+
+    const CBlock& data{*Assert(block.data)};
+    const CBlockUndo& undo{*Assert(block.undo_data)};
+    for (size_t i{0}; i < data.vtx.size(); ++i) {
+        const CTransaction& tx{*data.vtx[i]};
+        for (uint32_t n{0}; n < tx.vout.size(); ++n) {
+            const CTxOut& out{tx.vout[n]};
+            if (out.scriptPubKey.IsUnspendable()) continue;
+            entries.emplace_back(HashScript(out.scriptPubKey), ScriptIndexEntry{
+                .height = block.height,
+                .type = ScriptIndexEntry::Type::FUNDING,
+                .outpoint = COutPoint{tx.GetHash(), n},
+                .amount = out.nValue,
+            });
+        }
+        if (tx.IsCoinBase()) continue;
+
+        const CTxUndo& tx_undo{undo.vtxundo.at(i - 1)};
+        for (uint32_t n{0}; n < tx.vin.size(); ++n) {
+            const CTxOut& spent{tx_undo.vprevout.at(n).out};
+            entries.emplace_back(HashScript(spent.scriptPubKey), ScriptIndexEntry{
+                .height = block.height,
+                .type = ScriptIndexEntry::Type::SPENDING,
+                .outpoint = tx.vin[n].prevout,
+                .amount = spent.nValue,
+                .spending_txid = tx.GetHash(),
+                .spending_input = n,
+            });
+        }
+    }
+    return entries;
+}
+
+bool ScriptIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    return CustomAppendPrepared(block, CustomPrepare(block));
+}
+
+std::any ScriptIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    return BuildEntries(block);
+}
+
+bool ScriptIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    CDBBatch batch(*m_db);
+    for (const auto& [script_hash, entry] : std::any_cast<const Entries&>(prepared)) {
+        if (entry.type == ScriptIndexEntry::Type::FUNDING) {
+            batch.Write(MakeKey(script_hash, entry), FundingValue{entry.amount});
+        } else {
+            batch.Write(MakeKey(script_hash, entry), SpendingValue{entry.amount, entry.spending_txid, entry.spending_input});
+        }
+    }
+    m_db->WriteBatch(batch);
+    return true;
+}
+
+bool ScriptIndex::CustomRemove(const interfaces::BlockInfo& block)
+{
+    CDBBatch batch(*m_db);
+    for (const auto& [script_hash, entry] : BuildEntries(block)) {
+        batch.Erase(MakeKey(script_hash, entry));
+    }
+    m_db->WriteBatch(batch);
+    return true;
+}
+
+BaseIndex::DB& ScriptIndex::GetDB() const { return *m_db; }
+
+bool ScriptIndex::FindScriptHistory(const CScript& script, const std::optional<ScriptIndexEntry>& after, size_t max_entries,
+                                    std::vector<ScriptIndexEntry>& entries) const
+{
+    const uint256 script_hash{HashScript(script)};
+    std::unique_ptr<CDBIterator> it(m_db->NewIterator());
+    it->Seek(after ? MakeKey(script_hash, *after) : DBKey{.script_hash = script_hash});
+
+    DBKey key;
+    if (after && it->Valid() && it->GetKey(key) && key.script_hash == script_hash &&
+        key.height == static_cast<uint32_t>(after->height) && key.type == static_cast<uint8_t>(after->type) && key.outpoint == after->outpoint) {
+        it->Next();
+    }
+
+    for (; it->Valid() && it->GetKey(key) && key.script_hash == script_hash; it->Next()) {
+        if (entries.size() >= max_entries) return true;
+
+        ScriptIndexEntry& entry{entries.emplace_back()};
+        entry.height = key.height;
+        entry.outpoint = key.outpoint;
+        if (key.type == static_cast<uint8_t>(ScriptIndexEntry::Type::FUNDING)) {
+            FundingValue value;
+            if (!it->GetValue(value)) throw std::runtime_error("Failed to read script index entry value");
+            entry.type = ScriptIndexEntry::Type::FUNDING;
+            entry.amount = value.amount;
+        } else {
+            SpendingValue value;
+            if (!it->GetValue(value)) throw std::runtime_error("Failed to read script index entry value");
+            entry.type = ScriptIndexEntry::Type::SPENDING;
+            entry.amount = value.amount;
+            entry.spending_txid = value.spending_txid;
+            entry.spending_input = value.spending_input;
+        }
+    }
+    return false;
+}
+
+std::string EncodeScriptHistoryCursor(const ScriptIndexEntry& entry)
+{
+    DataStream stream;
+    stream << MakeKey(/*script_hash=*/uint256::ZERO, entry);
+    // The prefix and script hash are implied by the query
+    return HexStr(std::span{stream}.subspan(1 + uint256::size()));
+}
+
+std::optional<ScriptIndexEntry> DecodeScriptHistoryCursor(std::string_view cursor)
+{
+    const auto bytes{TryParseHex<std::byte>(cursor)};
+    if (!bytes) return std::nullopt;
+    DataStream stream;
+    stream << DB_SCRIPTINDEX << uint256::ZERO;
+    stream.write(*bytes);
+    DBKey key;
+    try {
+        stream >> key;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+    if (!stream.empty() || key.type > static_cast<uint8_t>(ScriptIndexEntry::Type::SPENDING)) return std::nullopt;
+    return ScriptIndexEntry{
+        .height = static_cast<int>(key.height),
+        .type = static_cast<ScriptIndexEntry::Type>(key.type),
+        .outpoint = key.outpoint,
+    };
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SCRIPTINDEX_H
+#define BITCOIN_INDEX_SCRIPTINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <interfaces/chain.h>
+#include <primitives/transaction.h>
+#include <uint256.h>
+
+#include <any>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class CScript;
+
+static constexpr bool DEFAULT_SCRIPTINDEX{false};
+
+/** An output paying to a script, or the spend of such an output. */
+struct ScriptIndexEntry {
+    enum class Type : uint8_t {
+        FUNDING = 0,
+        SPENDING = 1,
+    };
+
+    int height{0};
+    Type type{Type::FUNDING};
+    //! The output paying to the script.
+    COutPoint outpoint{};
+    //! The value of the output.
+    CAmount amount{0};
+    //! For spending entries, the spending transaction and the index of the spending input.
+    Txid spending_txid{};
+    uint32_t spending_input{0};
+};
+
+/**
+ * ScriptIndex is used to look up the history of a scriptPubKey. For every
+ * output of every transaction in a block it stores a funding entry, and for
+ * every input a spending entry, under the hash of the scriptPubKey involved.
+ *
+ * Keys are made of the SHA256 hash of the script followed by the height, the
+ * entry type and the outpoint, so the history of a script is a single
+ * contiguous key range in height order. A collision-resistant hash keeps the
+ * histories of different scripts apart without storing the scripts.
+ */
+class ScriptIndex final : public BaseIndex
+{
+private:
+    //! Index entries of a block, with the hash of their script.
+    using Entries = std::vector<std::pair<uint256, ScriptIndexEntry>>;
+
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+    bool AllowPrune() const override { return true; }
+
+    Entries BuildEntries(const interfaces::BlockInfo& block) const;
+
+protected:
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool AllowParallelSync() const override { return true; }
+
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    explicit ScriptIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    ~ScriptIndex() override;
+
+    /**
+     * Look up the history of a script, in height order.
+     *
+     * @param[in]  script       The scriptPubKey to look up.
+     * @param[in]  after        If set, continue after this entry returned by a previous lookup.
+     * @param[in]  max_entries  Maximum number of entries to return.
+     * @param[out] entries      The entries found.
+     * @return  true if the history has more entries after the returned ones.
+     */
+    bool FindScriptHistory(const CScript& script, const std::optional<ScriptIndexEntry>& after, size_t max_entries,
+                           std::vector<ScriptIndexEntry>& entries) const;
+};
+
+/** Encode the position of an entry, to continue a history lookup after it. */
+std::string EncodeScriptHistoryCursor(const ScriptIndexEntry& entry);
+
+/** Decode a cursor created by EncodeScriptHistoryCursor into an entry with its position set. */
+std::optional<ScriptIndexEntry> DecodeScriptHistoryCursor(std::string_view cursor);
+
+/// The global script index. May be null.
+extern std::unique_ptr<ScriptIndex> g_scriptindex;
+
+#endif // BITCOIN_INDEX_SCRIPTINDEX_H
@@ -20,6 +20,7 @@
 #include <util/log.h>
 #include <validation.h>
 
+#include <any>
 #include <cassert>
 #include <cstdint>
 #include <cstdio>
@@ -72,9 +73,14 @@ TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size,
 TxIndex::~TxIndex() = default;
 
 bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    return CustomAppendPrepared(block, CustomPrepare(block));
+}
+
+std::any TxIndex::CustomPrepare(const interfaces::BlockInfo& block) const
 {
     // Exclude genesis block transaction because outputs are not spendable.
-    if (block.height == 0) return true;
+    if (block.height == 0) return {};
 
     assert(block.data);
     CDiskTxPos pos({block.file_number, block.data_pos}, GetSizeOfCompactSize(block.data->vtx.size()));
@@ -84,7 +90,14 @@ bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
         vPos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(TX_WITH_WITNESS(*tx));
     }
-    m_db->WriteTxs(vPos);
+    return vPos;
+}
+
+bool TxIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    if (block.height == 0) return true;
+
+    m_db->WriteTxs(std::any_cast<const std::vector<std::pair<Txid, CDiskTxPos>>&>(prepared));
     return true;
 }
 
@@ -8,6 +8,7 @@
 #include <index/base.h>
 #include <primitives/transaction.h>
 
+#include <any>
 #include <cstddef>
 #include <memory>
 
@@ -36,6 +37,12 @@ private:
 protected:
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool AllowParallelSync() const override { return true; }
+
+    std::any CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared) override;
+
     BaseIndex::DB& GetDB() const override;
 
 public:
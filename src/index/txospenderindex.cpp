@@ -23,6 +23,7 @@
 #include <util/fs.h>
 #include <validation.h>
 
+#include <any>
 #include <cstdio>
 #include <exception>
 #include <ios>
@@ -128,7 +129,17 @@ static std::vector<std::pair<COutPoint, CDiskTxPos>> BuildSpenderPositions(const
 
 bool TxoSpenderIndex::CustomAppend(const interfaces::BlockInfo& block)
 {
-    WriteSpenderInfos(BuildSpenderPositions(block));
+    return CustomAppendPrepared(block, CustomPrepare(block));
+}
+
+std::any TxoSpenderIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    return BuildSpenderPositions(block);
+}
+
+bool TxoSpenderIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, std::any&& prepared)
+{
+    WriteSpenderInfos(std::any_cast<const std::vector<std::pair<COutPoint, CDiskTxPos>>&>(prepared));
     return true;
 }
 
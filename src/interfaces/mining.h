@@ -89,6 +89,15 @@ public:
      * Interrupts the current wait for the next block template.
     */
     virtual void interruptWait() = 0;
+
+    /**
+     * Return the transactions added and removed relative to the template
+     * waitNext() was called on to return this one, along with the new
+     * coinbase merkle path and fee totals. For a template returned by
+     * createNewBlock(), or by waitNext() after the tip changed, all
+     * transactions are reported as added.
+     */
+    virtual node::BlockTemplateDelta getDelta() = 0;
 };
 
 //! Interface giving clients (RPC, Stratum v2 Template Provider in the future)
@@ -9,6 +9,7 @@
 #include <kernel/notifications_interface.h>
 #include <util/fs.h>
 
+#include <cstddef>
 #include <cstdint>
 
 class CChainParams;
@@ -16,6 +17,10 @@ class CChainParams;
 namespace kernel {
 
 static constexpr bool DEFAULT_XOR_BLOCKSDIR{true};
+/** Default for -blockwritequeue, in MiB. 0 writes block and undo data synchronously. */
+static constexpr int64_t DEFAULT_BLOCK_WRITE_QUEUE_MIB{0};
+/** Default for -blockcachesize, in MiB. 0 disables the cache of recently read blocks. */
+static constexpr int64_t DEFAULT_BLOCK_CACHE_MIB{0};
 
 /**
  * An options struct for `BlockManager`, more ergonomically referred to as
@@ -26,6 +31,10 @@ struct BlockManagerOpts {
     bool use_xor{DEFAULT_XOR_BLOCKSDIR};
     uint64_t prune_target{0};
     bool fast_prune{false};
+    //! Maximum number of bytes of block and undo data queued for background writing, 0 to disable.
+    size_t write_queue_bytes{0};
+    //! Maximum memory usage of the cache of recently read blocks, 0 to disable.
+    size_t block_cache_bytes{0};
     const fs::path blocks_dir;
     Notifications& notifications;
     DBParams block_tree_db_params;
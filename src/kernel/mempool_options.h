@@ -25,6 +25,8 @@ static constexpr unsigned int DEFAULT_MEMPOOL_EXPIRY_HOURS{336};
 static constexpr bool DEFAULT_PERSIST_V1_DAT{false};
 /** Default for -acceptnonstdtxn */
 static constexpr bool DEFAULT_ACCEPT_NON_STD_TXN{false};
+/** Default for -mempoolbackgroundlinearization */
+static constexpr bool DEFAULT_MEMPOOL_BACKGROUND_LINEARIZATION{false};
 
 namespace kernel {
 /**
@@ -54,6 +56,8 @@ struct MemPoolOptions {
     bool permit_bare_multisig{DEFAULT_PERMIT_BAREMULTISIG};
     bool require_standard{true};
     bool persist_v1_dat{DEFAULT_PERSIST_V1_DAT};
+    /** Improve cluster linearizations on a background thread rather than after every change */
+    bool background_linearization{DEFAULT_MEMPOOL_BACKGROUND_LINEARIZATION};
     MemPoolLimits limits{};
 
     ValidationSignals* signals{nullptr};
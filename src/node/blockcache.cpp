@@ -0,0 +1,115 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockcache.h>
+
+#include <core_memusage.h>
+#include <memusage.h>
+
+#include <iterator>
+#include <utility>
+
+namespace node {
+
+BlockCache::BlockCache(size_t max_usage)
+    : m_max_usage{max_usage}
+{
+    m_stats.max_usage = max_usage;
+}
+
+BlockCache::EntryList::iterator BlockCache::Touch(const uint256& hash)
+{
+    const auto it{m_map.find(hash)};
+    if (it == m_map.end()) return m_lru.end();
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second;
+}
+
+std::shared_ptr<const CBlock> BlockCache::GetBlock(const uint256& hash)
+{
+    LOCK(m_mutex);
+    const auto it{Touch(hash)};
+    if (it == m_lru.end() || !it->block) {
+        ++m_stats.misses;
+        return nullptr;
+    }
+    ++m_stats.hits;
+    return it->block;
+}
+
+std::shared_ptr<const BlockCache::RawBlock> BlockCache::GetRawBlock(const uint256& hash)
+{
+    LOCK(m_mutex);
+    const auto it{Touch(hash)};
+    if (it == m_lru.end() || !it->raw) {
+        ++m_stats.raw_misses;
+        return nullptr;
+    }
+    ++m_stats.raw_hits;
+    return it->raw;
+}
+
+BlockCache::Entry& BlockCache::FindOrCreate(const uint256& hash)
+{
+    if (const auto it{Touch(hash)}; it != m_lru.end()) return *it;
+    m_lru.push_front(Entry{.hash = hash});
+    m_map.emplace(hash, m_lru.begin());
+    return m_lru.front();
+}
+
+void BlockCache::Update(Entry& entry)
+{
+    m_stats.usage -= entry.usage;
+    // Account for the list node and the map node of the entry
+    entry.usage = memusage::MallocUsage(sizeof(Entry) + 2 * sizeof(void*)) +
+                  memusage::MallocUsage(sizeof(std::pair<const uint256, EntryList::iterator>) + sizeof(void*));
+    if (entry.block) entry.usage += RecursiveDynamicUsage(entry.block);
+    if (entry.raw) entry.usage += memusage::DynamicUsage(entry.raw) + memusage::DynamicUsage(*entry.raw);
+    m_stats.usage += entry.usage;
+
+    // Evict least recently used entries. The updated entry is at the front,
+    // and is evicted too if it does not fit on its own.
+    while (m_stats.usage > m_max_usage && !m_lru.empty()) {
+        EraseEntry(std::prev(m_lru.end()));
+    }
+}
+
+void BlockCache::EraseEntry(EntryList::iterator it)
+{
+    m_stats.usage -= it->usage;
+    m_map.erase(it->hash);
+    m_lru.erase(it);
+}
+
+void BlockCache::PutBlock(const uint256& hash, std::shared_ptr<const CBlock> block)
+{
+    LOCK(m_mutex);
+    Entry& entry{FindOrCreate(hash)};
+    entry.block = std::move(block);
+    Update(entry);
+}
+
+void BlockCache::PutRawBlock(const uint256& hash, std::shared_ptr<const RawBlock> raw)
+{
+    LOCK(m_mutex);
+    Entry& entry{FindOrCreate(hash)};
+    entry.raw = std::move(raw);
+    Update(entry);
+}
+
+void BlockCache::Erase(const uint256& hash)
+{
+    LOCK(m_mutex);
+    if (const auto it{m_map.find(hash)}; it != m_map.end()) EraseEntry(it->second);
+}
+
+BlockCache::Stats BlockCache::GetStats() const
+{
+    LOCK(m_mutex);
+    Stats stats{m_stats};
+    stats.entries = m_map.size();
+    return stats;
+}
+
+} // namespace node
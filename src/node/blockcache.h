@@ -0,0 +1,88 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_BLOCKCACHE_H
+#define BITCOIN_NODE_BLOCKCACHE_H
+
+#include <primitives/block.h>
+#include <sync.h>
+#include <uint256.h>
+#include <util/hasher.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace node {
+
+/**
+ * Memory-bounded LRU cache of blocks read from disk, keyed by block hash.
+ *
+ * Peers, RPC, REST, indexes and ZMQ tend to read the same recent blocks
+ * shortly after each other. Deserialized blocks and raw serialized blocks are
+ * cached independently of each other, as the consumers want one or the other,
+ * but share a single entry and memory budget per block hash.
+ */
+class BlockCache
+{
+public:
+    using RawBlock = std::vector<std::byte>;
+
+    struct Stats {
+        size_t usage{0};
+        size_t max_usage{0};
+        size_t entries{0};
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t raw_hits{0};
+        uint64_t raw_misses{0};
+    };
+
+    explicit BlockCache(size_t max_usage);
+
+    /** Return the cached deserialized block, or nullptr. Counts as a hit or miss. */
+    std::shared_ptr<const CBlock> GetBlock(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Return the cached serialized block, or nullptr. Counts as a hit or miss. */
+    std::shared_ptr<const RawBlock> GetRawBlock(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    void PutBlock(const uint256& hash, std::shared_ptr<const CBlock> block) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void PutRawBlock(const uint256& hash, std::shared_ptr<const RawBlock> raw) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Drop any cached data for the given block, e.g. after it was pruned. */
+    void Erase(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    Stats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Entry {
+        uint256 hash{};
+        std::shared_ptr<const CBlock> block{};
+        std::shared_ptr<const RawBlock> raw{};
+        size_t usage{0};
+    };
+    using EntryList = std::list<Entry>;
+
+    //! Look up an entry and mark it as most recently used.
+    EntryList::iterator Touch(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    //! Return the entry for hash, creating an empty one if needed.
+    Entry& FindOrCreate(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    //! Recompute the usage of an entry after it was modified and evict as needed.
+    void Update(Entry& entry) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void EraseEntry(EntryList::iterator it) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+    const size_t m_max_usage;
+
+    mutable Mutex m_mutex;
+    //! Entries in most recently used first order.
+    EntryList m_lru GUARDED_BY(m_mutex);
+    std::unordered_map<uint256, EntryList::iterator, SaltedUint256Hasher> m_map GUARDED_BY(m_mutex);
+    Stats m_stats GUARDED_BY(m_mutex);
+};
+
+} // namespace node
+
+#endif // BITCOIN_NODE_BLOCKCACHE_H
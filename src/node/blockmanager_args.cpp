@@ -36,6 +36,20 @@ util::Result<void> ApplyArgsManOptions(const ArgsManager& args, BlockManager::Op
 
     if (auto value{args.GetBoolArg("-fastprune")}) opts.fast_prune = *value;
 
+    if (auto value{args.GetIntArg("-blockwritequeue")}) {
+        if (*value < 0) {
+            return util::Error{_("-blockwritequeue cannot be configured with a negative value.")};
+        }
+        opts.write_queue_bytes = size_t(*value) * 1_MiB;
+    }
+
+    if (auto value{args.GetIntArg("-blockcachesize")}) {
+        if (*value < 0) {
+            return util::Error{_("-blockcachesize cannot be configured with a negative value.")};
+        }
+        opts.block_cache_bytes = size_t(*value) * 1_MiB;
+    }
+
     ReadDatabaseArgs(args, opts.block_tree_db_params.options);
 
     return {};
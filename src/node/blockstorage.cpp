@@ -30,6 +30,7 @@
 #include <util/check.h>
 #include <util/expected.h>
 #include <util/fs.h>
+#include <util/fs_helpers.h>
 #include <util/log.h>
 #include <util/obfuscation.h>
 #include <util/overflow.h>
@@ -41,6 +42,7 @@
 #include <util/translation.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <compare>
 #include <cstddef>
@@ -52,7 +54,9 @@
 #include <span>
 #include <stdexcept>
 #include <system_error>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 namespace kernel {
 static constexpr uint8_t DB_BLOCK_FILES{'f'};
@@ -265,6 +269,7 @@ void BlockManager::PruneOneBlockFile(const int fileNumber)
         if (pindex->nFile == fileNumber) {
             pindex->nStatus &= ~BLOCK_HAVE_DATA;
             pindex->nStatus &= ~BLOCK_HAVE_UNDO;
+            if (m_block_cache) m_block_cache->Erase(pindex->GetBlockHash());
             pindex->nFile = 0;
             pindex->nDataPos = 0;
             pindex->nUndoPos = 0;
@@ -735,9 +740,84 @@ bool BlockManager::ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index
     return true;
 }
 
+bool BlockManager::ReadBlockUndos(std::span<const CBlockIndex* const> blocks, std::vector<CBlockUndo>& blockundos) const
+{
+    blockundos.assign(blocks.size(), CBlockUndo{});
+
+    // Positions of the undo data to read, with the index of the block they belong to
+    std::vector<std::pair<FlatFilePos, size_t>> requests;
+    requests.reserve(blocks.size());
+    {
+        LOCK(::cs_main);
+        for (size_t i{0}; i < blocks.size(); ++i) {
+            if (blocks[i]->nHeight == 0) continue;
+            requests.emplace_back(blocks[i]->GetUndoPos(), i);
+        }
+    }
+    std::sort(requests.begin(), requests.end(), [](const auto& a, const auto& b) {
+        return std::tie(a.first.nFile, a.first.nPos) < std::tie(b.first.nFile, b.first.nPos);
+    });
+
+    std::vector<std::byte> data;
+    for (auto file_begin{requests.begin()}; file_begin != requests.end();) {
+        const int file_num{file_begin->first.nFile};
+        const auto file_end{std::find_if(file_begin, requests.end(), [&](const auto& r) { return r.first.nFile != file_num; })};
+
+        AutoFile file{OpenUndoFile(FlatFilePos{file_num, 0}, /*fReadOnly=*/true)};
+        if (file.IsNull()) {
+            LogError("OpenUndoFile failed for file %05i while reading block undos", file_num);
+            return false;
+        }
+
+        for (auto it{file_begin}; it != file_end; ++it) {
+            const auto& [pos, index]{*it};
+            if (pos.nPos < STORAGE_HEADER_BYTES) {
+                LogError("Invalid position %s while reading block undos", pos.ToString());
+                return false;
+            }
+            try {
+                // Unlike ReadBlockUndo(), read the storage header too, so the
+                // data and checksum can be fetched with a single read.
+                file.seek(pos.nPos - STORAGE_HEADER_BYTES, SEEK_SET);
+                MessageStartChars undo_start;
+                uint32_t undo_size;
+                file >> undo_start >> undo_size;
+                if (undo_start != GetParams().MessageStart() || undo_size > MAX_SIZE) {
+                    LogError("Invalid storage header at %s while reading block undos", pos.ToString());
+                    return false;
+                }
+                data.resize(undo_size + uint256::size());
+                file.read(data);
+
+                const auto undo_data{std::span{data}.first(undo_size)};
+                HashWriter hasher{};
+                hasher << blocks[index]->pprev->GetBlockHash();
+                hasher.write(undo_data);
+                uint256 checksum;
+                SpanReader{std::span{data}.subspan(undo_size)} >> checksum;
+                if (checksum != hasher.GetHash()) {
+                    LogError("Checksum mismatch at %s while reading block undos", pos.ToString());
+                    return false;
+                }
+                SpanReader{undo_data} >> blockundos[index];
+            } catch (const std::exception& e) {
+                LogError("Deserialize or I/O error - %s at %s while reading block undos", e.what(), pos.ToString());
+                return false;
+            }
+        }
+        file_begin = file_end;
+    }
+    return true;
+}
+
 bool BlockManager::FlushUndoFile(int block_file, bool finalize)
 {
     FlatFilePos undo_pos_old(block_file, m_blockfile_info[block_file].nUndoSize);
+    if (m_write_queue) {
+        // Errors are reported by the queue once the flush has been executed.
+        m_write_queue->Flush(m_undo_file_seq, undo_pos_old, finalize, _("Flushing undo file to disk failed. This is likely the result of an I/O error."));
+        return true;
+    }
     if (!m_undo_file_seq.Flush(undo_pos_old, finalize)) {
         m_opts.notifications.flushError(_("Flushing undo file to disk failed. This is likely the result of an I/O error."));
         return false;
@@ -760,7 +840,9 @@ bool BlockManager::FlushBlockFile(int blockfile_num, bool fFinalize, bool finali
     assert(static_cast<int>(m_blockfile_info.size()) > blockfile_num);
 
     FlatFilePos block_pos_old(blockfile_num, m_blockfile_info[blockfile_num].nSize);
-    if (!m_block_file_seq.Flush(block_pos_old, fFinalize)) {
+    if (m_write_queue) {
+        m_write_queue->Flush(m_block_file_seq, block_pos_old, fFinalize, _("Flushing block file to disk failed. This is likely the result of an I/O error."));
+    } else if (!m_block_file_seq.Flush(block_pos_old, fFinalize)) {
         m_opts.notifications.flushError(_("Flushing block file to disk failed. This is likely the result of an I/O error."));
         success = false;
     }
@@ -784,16 +866,54 @@ BlockfileType BlockManager::BlockfileTypeForHeight(int height)
 
 bool BlockManager::FlushChainstateBlockFile(int tip_height)
 {
-    LOCK(cs_LastBlockFile);
-    auto& cursor = m_blockfile_cursors[BlockfileTypeForHeight(tip_height)];
-    // If the cursor does not exist, it means an assumeutxo snapshot is loaded,
-    // but no blocks past the snapshot height have been written yet, so there
-    // is no data associated with the chainstate, and it is safe not to flush.
-    if (cursor) {
-        return FlushBlockFile(cursor->file_num, /*fFinalize=*/false, /*finalize_undo=*/false);
-    }
-    // No need to log warnings in this case.
-    return true;
+    bool success{true};
+    {
+        LOCK(cs_LastBlockFile);
+        auto& cursor = m_blockfile_cursors[BlockfileTypeForHeight(tip_height)];
+        // If the cursor does not exist, it means an assumeutxo snapshot is loaded,
+        // but no blocks past the snapshot height have been written yet, so there
+        // is no data associated with the chainstate, and it is safe not to flush.
+        // No need to log warnings in this case.
+        if (cursor) {
+            success = FlushBlockFile(cursor->file_num, /*fFinalize=*/false, /*finalize_undo=*/false);
+        }
+    }
+    // The caller is about to commit block index entries that point into the
+    // block and undo files, so everything queued so far must be on disk first.
+    if (m_write_queue && !m_write_queue->Sync()) {
+        success = false;
+    }
+    return success;
+}
+
+size_t BlockManager::AllocateFileSpace(const FlatFileSeq& seq, const FlatFilePos& pos, size_t add_size, bool& out_of_space)
+{
+    if (!m_write_queue) return seq.Allocate(pos, add_size, out_of_space);
+
+    // Pre-allocation must be ordered with the queued writes to the same file,
+    // so it runs on the writer thread. The disk space check is done here to
+    // fail as early as the synchronous path does.
+    out_of_space = false;
+    const size_t inc_size{seq.AllocationSize(pos, add_size)};
+    if (inc_size == 0) return 0;
+    if (!CheckDiskSpace(m_opts.blocks_dir, inc_size)) {
+        out_of_space = true;
+        return 0;
+    }
+    m_write_queue->Allocate(seq, pos, add_size);
+    return inc_size;
+}
+
+std::optional<BlockWriteQueue::Stats> BlockManager::GetWriteQueueStats() const
+{
+    if (!m_write_queue) return std::nullopt;
+    return m_write_queue->GetStats();
+}
+
+std::optional<BlockCache::Stats> BlockManager::GetBlockCacheStats() const
+{
+    if (!m_block_cache) return std::nullopt;
+    return m_block_cache->GetStats();
 }
 
 uint64_t BlockManager::CalculateCurrentUsage()
@@ -812,6 +932,11 @@ void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
     std::error_code ec;
     for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
         FlatFilePos pos(*it, 0);
+        if (m_write_queue) {
+            // Do not let a queued write recreate the file after it is removed.
+            m_write_queue->WaitForFile(m_block_file_seq, *it);
+            m_write_queue->WaitForFile(m_undo_file_seq, *it);
+        }
         const bool removed_blockfile{fs::remove(m_block_file_seq.FileName(pos), ec)};
         const bool removed_undofile{fs::remove(m_undo_file_seq.FileName(pos), ec)};
         if (removed_blockfile || removed_undofile) {
@@ -822,12 +947,14 @@ void BlockManager::UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const
 
 AutoFile BlockManager::OpenBlockFile(const FlatFilePos& pos, bool fReadOnly) const
 {
+    if (m_write_queue) m_write_queue->WaitForFile(m_block_file_seq, pos.nFile);
     return AutoFile{m_block_file_seq.Open(pos, fReadOnly), m_obfuscation};
 }
 
 /** Open an undo file (rev?????.dat) */
 AutoFile BlockManager::OpenUndoFile(const FlatFilePos& pos, bool fReadOnly) const
 {
+    if (m_write_queue) m_write_queue->WaitForFile(m_undo_file_seq, pos.nFile);
     return AutoFile{m_undo_file_seq.Open(pos, fReadOnly), m_obfuscation};
 }
 
@@ -913,7 +1040,7 @@ FlatFilePos BlockManager::FindNextBlockPos(unsigned int nAddSize, unsigned int n
     m_blockfile_info[nFile].nSize += nAddSize;
 
     bool out_of_space;
-    size_t bytes_allocated = m_block_file_seq.Allocate(pos, nAddSize, out_of_space);
+    size_t bytes_allocated = AllocateFileSpace(m_block_file_seq, pos, nAddSize, out_of_space);
     if (out_of_space) {
         m_opts.notifications.fatalError(_("Disk space is too low!"));
         return {};
@@ -959,7 +1086,7 @@ bool BlockManager::FindUndoPos(BlockValidationState& state, int nFile, FlatFileP
     m_dirty_fileinfo.insert(nFile);
 
     bool out_of_space;
-    size_t bytes_allocated = m_undo_file_seq.Allocate(pos, nAddSize, out_of_space);
+    size_t bytes_allocated = AllocateFileSpace(m_undo_file_seq, pos, nAddSize, out_of_space);
     if (out_of_space) {
         return FatalError(m_opts.notifications, state, _("Disk space is too low!"));
     }
@@ -985,32 +1112,43 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
             return false;
         }
 
-        // Open history file to append
-        AutoFile file{OpenUndoFile(pos)};
-        if (file.IsNull()) {
-            LogError("OpenUndoFile failed for %s while writing block undo", pos.ToString());
-            return FatalError(m_opts.notifications, state, _("Failed to write undo data."));
-        }
-        {
-            BufferedWriter fileout{file};
-
-            // Write index header
-            fileout << GetParams().MessageStart() << blockundo_size;
+        if (m_write_queue) {
+            DataStream data;
+            data.reserve(blockundo_size + UNDO_DATA_DISK_OVERHEAD);
+            data << GetParams().MessageStart() << blockundo_size;
+            HashWriter hasher{};
+            hasher << block.pprev->GetBlockHash() << blockundo;
+            data << blockundo << hasher.GetHash();
+            m_write_queue->Write(m_undo_file_seq, m_obfuscation, pos, std::move(data), _("Failed to write undo data."));
             pos.nPos += STORAGE_HEADER_BYTES;
+        } else {
+            // Open history file to append
+            AutoFile file{OpenUndoFile(pos)};
+            if (file.IsNull()) {
+                LogError("OpenUndoFile failed for %s while writing block undo", pos.ToString());
+                return FatalError(m_opts.notifications, state, _("Failed to write undo data."));
+            }
             {
-                // Calculate checksum
-                HashWriter hasher{};
-                hasher << block.pprev->GetBlockHash() << blockundo;
-                // Write undo data & checksum
-                fileout << blockundo << hasher.GetHash();
+                BufferedWriter fileout{file};
+
+                // Write index header
+                fileout << GetParams().MessageStart() << blockundo_size;
+                pos.nPos += STORAGE_HEADER_BYTES;
+                {
+                    // Calculate checksum
+                    HashWriter hasher{};
+                    hasher << block.pprev->GetBlockHash() << blockundo;
+                    // Write undo data & checksum
+                    fileout << blockundo << hasher.GetHash();
+                }
+                // BufferedWriter will flush pending data to file when fileout goes out of scope.
             }
-            // BufferedWriter will flush pending data to file when fileout goes out of scope.
-        }
 
-        // Make sure that the file is closed before we call `FlushUndoFile`.
-        if (file.fclose() != 0) {
-            LogError("Failed to close block undo file %s: %s", pos.ToString(), SysErrorString(errno));
-            return FatalError(m_opts.notifications, state, _("Failed to close block undo file."));
+            // Make sure that the file is closed before we call `FlushUndoFile`.
+            if (file.fclose() != 0) {
+                LogError("Failed to close block undo file %s: %s", pos.ToString(), SysErrorString(errno));
+                return FatalError(m_opts.notifications, state, _("Failed to close block undo file."));
+            }
         }
 
         // rev files are written in block height order, whereas blk files are written as blocks come in (often out of order)
@@ -1043,6 +1181,13 @@ bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, const std::o
 {
     block.SetNull();
 
+    if (m_block_cache && expected_hash) {
+        if (const auto cached{m_block_cache->GetBlock(*expected_hash)}) {
+            block = *cached;
+            return true;
+        }
+    }
+
     // Open history file to read
     const auto block_data{ReadRawBlock(pos)};
     if (!block_data) {
@@ -1077,6 +1222,8 @@ bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, const std::o
         return false;
     }
 
+    if (m_block_cache) m_block_cache->PutBlock(block_hash, std::make_shared<const CBlock>(block));
+
     return true;
 }
 
@@ -1086,8 +1233,19 @@ bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index) const
     return ReadBlock(block, block_pos, index.GetBlockHash());
 }
 
-BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part) const
+BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part, const std::optional<uint256>& block_hash) const
 {
+    if (m_block_cache && block_hash) {
+        if (const auto cached{m_block_cache->GetRawBlock(*block_hash)}) {
+            if (!block_part) return *cached;
+            const auto [offset, size]{*block_part};
+            if (size == 0 || SaturatingAdd(offset, size) > cached->size()) {
+                return util::Unexpected{ReadRawError::BadPartRange};
+            }
+            return std::vector<std::byte>(cached->begin() + offset, cached->begin() + offset + size);
+        }
+    }
+
     if (pos.nPos < STORAGE_HEADER_BYTES) {
         // If nPos is less than STORAGE_HEADER_BYTES, we can't read the header that precedes the block data
         // This would cause an unsigned integer underflow when trying to position the file cursor
@@ -1130,6 +1288,9 @@ BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& p
 
         std::vector<std::byte> data(blk_size); // Zeroing of memory is intentional here
         filein.read(data);
+        if (m_block_cache && block_hash && !block_part) {
+            m_block_cache->PutRawBlock(*block_hash, std::make_shared<const std::vector<std::byte>>(data));
+        }
         return data;
     } catch (const std::exception& e) {
         LogError("Read from block file failed: %s for %s while reading raw block", e.what(), pos.ToString());
@@ -1145,6 +1306,14 @@ FlatFilePos BlockManager::WriteBlock(const CBlock& block, int nHeight)
         LogError("FindNextBlockPos failed for %s while writing block", pos.ToString());
         return FlatFilePos();
     }
+    if (m_write_queue) {
+        DataStream data;
+        data.reserve(block_size + STORAGE_HEADER_BYTES);
+        data << GetParams().MessageStart() << block_size << TX_WITH_WITNESS(block);
+        m_write_queue->Write(m_block_file_seq, m_obfuscation, pos, std::move(data), _("Failed to write block."));
+        pos.nPos += STORAGE_HEADER_BYTES;
+        return pos;
+    }
     AutoFile file{OpenBlockFile(pos, /*fReadOnly=*/false)};
     if (file.IsNull()) {
         LogError("OpenBlockFile failed for %s while writing block", pos.ToString());
@@ -1237,6 +1406,13 @@ BlockManager::BlockManager(const util::SignalInterrupt& interrupt, Options opts)
 {
     m_block_tree_db = std::make_unique<BlockTreeDB>(m_opts.block_tree_db_params);
 
+    if (m_opts.write_queue_bytes > 0) {
+        m_write_queue = std::make_unique<BlockWriteQueue>(m_opts.write_queue_bytes, m_opts.notifications);
+    }
+    if (m_opts.block_cache_bytes > 0) {
+        m_block_cache = std::make_unique<BlockCache>(m_opts.block_cache_bytes);
+    }
+
     if (m_opts.block_tree_db_params.wipe_data) {
         m_block_tree_db->WriteReindexing(true);
         m_blockfiles_indexed = false;
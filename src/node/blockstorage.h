@@ -13,6 +13,8 @@
 #include <kernel/chainparams.h>
 #include <kernel/cs_main.h>
 #include <kernel/messagestartchars.h>
+#include <node/blockcache.h>
+#include <node/blockwritequeue.h>
 #include <primitives/block.h>
 #include <serialize.h>
 #include <streams.h>
@@ -222,7 +224,14 @@ private:
      * separator fields (STORAGE_HEADER_BYTES).
      */
     [[nodiscard]] FlatFilePos FindNextBlockPos(unsigned int nAddSize, unsigned int nHeight, uint64_t nTime);
+    /**
+     * Flush the block and undo files of the chainstate at the given tip height. When the
+     * write-behind queue is enabled, this is also a durability barrier: it returns once all
+     * previously queued block and undo writes have completed.
+     */
     [[nodiscard]] bool FlushChainstateBlockFile(int tip_height);
+    /** Pre-allocate space in a block or undo file, on the write-behind queue if it is enabled. */
+    size_t AllocateFileSpace(const FlatFileSeq& seq, const FlatFilePos& pos, size_t add_size, bool& out_of_space);
     bool FindUndoPos(BlockValidationState& state, int nFile, FlatFilePos& pos, unsigned int nAddSize);
 
     AutoFile OpenUndoFile(const FlatFilePos& pos, bool fReadOnly = false) const;
@@ -305,6 +314,13 @@ private:
     const FlatFileSeq m_block_file_seq;
     const FlatFileSeq m_undo_file_seq;
 
+    //! Background writer for block and undo data, or nullptr if writes are synchronous.
+    //! Declared after the file sequences, so it is drained before they are destroyed.
+    std::unique_ptr<BlockWriteQueue> m_write_queue;
+
+    //! Cache of recently read blocks, or nullptr if disabled.
+    std::unique_ptr<BlockCache> m_block_cache;
+
 protected:
     std::vector<CBlockFileInfo> m_blockfile_info;
 
@@ -411,6 +427,12 @@ public:
 
     [[nodiscard]] bool LoadingBlocks() const { return m_importing || !m_blockfiles_indexed; }
 
+    /** Statistics of the write-behind queue, if it is enabled. */
+    std::optional<BlockWriteQueue::Stats> GetWriteQueueStats() const;
+
+    /** Statistics of the cache of recently read blocks, if it is enabled. */
+    std::optional<BlockCache::Stats> GetBlockCacheStats() const;
+
     /** Calculate the amount of disk space the block & undo files currently use */
     uint64_t CalculateCurrentUsage();
 
@@ -471,13 +493,27 @@ public:
      */
     void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
 
-    /** Functions for disk access for blocks */
+    /** Functions for disk access for blocks. When the block hash is known, reads may be served by the block cache. */
     bool ReadBlock(CBlock& block, const FlatFilePos& pos, const std::optional<uint256>& expected_hash) const;
     bool ReadBlock(CBlock& block, const CBlockIndex& index) const;
-    ReadRawBlockResult ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part = std::nullopt) const;
+    ReadRawBlockResult ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part = std::nullopt, const std::optional<uint256>& block_hash = std::nullopt) const;
 
     bool ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const;
 
+    /**
+     * Read and verify the undo data of several blocks at once, e.g. a range of heights.
+     *
+     * The reads are ordered by their position in the rev?????.dat files, so
+     * each file is opened once and read front to back, instead of one open and
+     * seek per block. The genesis block has no undo data and results in an
+     * empty CBlockUndo.
+     *
+     * @param[in]  blocks      blocks to read the undo data of; they must have BLOCK_HAVE_UNDO set
+     * @param[out] blockundos  undo data in the same order as blocks
+     * @returns false if any of the reads failed
+     */
+    bool ReadBlockUndos(std::span<const CBlockIndex* const> blocks, std::vector<CBlockUndo>& blockundos) const;
+
     void CleanupBlockRevFiles() const;
 };
 
@@ -0,0 +1,183 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockwritequeue.h>
+
+#include <kernel/notifications_interface.h>
+#include <util/check.h>
+#include <util/log.h>
+#include <util/syserror.h>
+#include <util/threadnames.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <exception>
+
+namespace node {
+
+BlockWriteQueue::BlockWriteQueue(size_t max_pending_bytes, kernel::Notifications& notifications)
+    : m_max_pending_bytes{max_pending_bytes},
+      m_notifications{notifications}
+{
+    m_thread = std::thread([this] {
+        util::ThreadRename("blockwrite");
+        ThreadWrite();
+    });
+}
+
+BlockWriteQueue::~BlockWriteQueue()
+{
+    // Queued jobs are still executed: the block index may already refer to
+    // the positions they write to.
+    WITH_LOCK(m_mutex, m_stop = true);
+    m_work_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void BlockWriteQueue::Submit(Job&& job)
+{
+    job.id = m_next_id++;
+    m_last_job_for_file[{job.seq, job.pos.nFile}] = job.id;
+    m_pending_bytes += job.data.size();
+    m_jobs.push_back(std::move(job));
+    m_work_cv.notify_one();
+}
+
+void BlockWriteQueue::Allocate(const FlatFileSeq& seq, const FlatFilePos& pos, size_t add_size)
+{
+    LOCK(m_mutex);
+    Submit({.type = JobType::ALLOCATE, .seq = &seq, .pos = pos, .add_size = add_size});
+}
+
+void BlockWriteQueue::Write(const FlatFileSeq& seq, const Obfuscation& obfuscation, const FlatFilePos& pos, DataStream&& data, bilingual_str error_message)
+{
+    WAIT_LOCK(m_mutex, lock);
+    // Always admit a write into an empty queue, so that a single job larger
+    // than the limit cannot block forever.
+    m_done_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+        return m_pending_bytes == 0 || m_pending_bytes + data.size() <= m_max_pending_bytes;
+    });
+    Submit({.type = JobType::WRITE, .seq = &seq, .pos = pos, .obfuscation = obfuscation, .data = std::move(data), .error_message = std::move(error_message)});
+}
+
+void BlockWriteQueue::Flush(const FlatFileSeq& seq, const FlatFilePos& pos, bool finalize, bilingual_str error_message)
+{
+    LOCK(m_mutex);
+    Submit({.type = finalize ? JobType::FLUSH_FINALIZE : JobType::FLUSH, .seq = &seq, .pos = pos, .error_message = std::move(error_message)});
+}
+
+void BlockWriteQueue::WaitForFile(const FlatFileSeq& seq, int file)
+{
+    WAIT_LOCK(m_mutex, lock);
+    const auto it{m_last_job_for_file.find({&seq, file})};
+    if (it == m_last_job_for_file.end()) return;
+    const uint64_t target{it->second};
+    m_done_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_completed_id >= target; });
+}
+
+bool BlockWriteQueue::Sync()
+{
+    WAIT_LOCK(m_mutex, lock);
+    const uint64_t target{m_next_id - 1};
+    m_done_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_completed_id >= target; });
+    return !m_failed;
+}
+
+BlockWriteQueue::Stats BlockWriteQueue::GetStats() const
+{
+    LOCK(m_mutex);
+    Stats stats{m_stats};
+    stats.pending_bytes = m_pending_bytes;
+    stats.pending_jobs = m_jobs.size();
+    return stats;
+}
+
+bool BlockWriteQueue::Run(Job& job) const
+{
+    switch (job.type) {
+    case JobType::ALLOCATE: {
+        bool out_of_space;
+        job.seq->Allocate(job.pos, job.add_size, out_of_space);
+        if (out_of_space) {
+            m_notifications.fatalError(_("Disk space is too low!"));
+            return false;
+        }
+        return true;
+    }
+    case JobType::WRITE: {
+        AutoFile file{job.seq->Open(job.pos), job.obfuscation};
+        if (file.IsNull()) {
+            LogError("Failed to open %s for background write", job.pos.ToString());
+            m_notifications.fatalError(job.error_message);
+            return false;
+        }
+        try {
+            file.write_buffer(job.data);
+        } catch (const std::exception& e) {
+            LogError("Background write to %s failed: %s", job.pos.ToString(), e.what());
+            (void)file.fclose();
+            m_notifications.fatalError(job.error_message);
+            return false;
+        }
+        if (file.fclose() != 0) {
+            LogError("Failed to close %s after background write: %s", job.pos.ToString(), SysErrorString(errno));
+            m_notifications.fatalError(job.error_message);
+            return false;
+        }
+        return true;
+    }
+    case JobType::FLUSH:
+    case JobType::FLUSH_FINALIZE:
+        if (!job.seq->Flush(job.pos, job.type == JobType::FLUSH_FINALIZE)) {
+            m_notifications.flushError(job.error_message);
+            return false;
+        }
+        return true;
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
+void BlockWriteQueue::ThreadWrite()
+{
+    WAIT_LOCK(m_mutex, lock);
+    while (true) {
+        m_work_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || !m_jobs.empty(); });
+        if (m_jobs.empty()) {
+            Assume(m_stop);
+            return;
+        }
+        Job job{std::move(m_jobs.front())};
+        m_jobs.pop_front();
+
+        // A flush is redundant if a later flush of the same file is already
+        // queued, unless it would truncate the file and the later one would not.
+        bool skip{false};
+        if (job.type == JobType::FLUSH || job.type == JobType::FLUSH_FINALIZE) {
+            skip = std::any_of(m_jobs.begin(), m_jobs.end(), [&](const Job& later) {
+                return later.seq == job.seq && later.pos.nFile == job.pos.nFile &&
+                       (later.type == JobType::FLUSH_FINALIZE || (later.type == JobType::FLUSH && job.type == JobType::FLUSH));
+            });
+        }
+
+        bool success{true};
+        if (skip) {
+            ++m_stats.coalesced_flushes;
+        } else {
+            REVERSE_LOCK(lock, m_mutex);
+            success = Run(job);
+        }
+
+        if (!success) m_failed = true;
+        if (job.type == JobType::WRITE) ++m_stats.writes;
+        if ((job.type == JobType::FLUSH || job.type == JobType::FLUSH_FINALIZE) && !skip) ++m_stats.flushes;
+        m_pending_bytes -= job.data.size();
+        m_completed_id = job.id;
+        const auto it{m_last_job_for_file.find({job.seq, job.pos.nFile})};
+        if (it != m_last_job_for_file.end() && it->second == job.id) m_last_job_for_file.erase(it);
+        m_done_cv.notify_all();
+    }
+}
+
+} // namespace node
@@ -0,0 +1,135 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_BLOCKWRITEQUEUE_H
+#define BITCOIN_NODE_BLOCKWRITEQUEUE_H
+
+#include <flatfile.h>
+#include <streams.h>
+#include <sync.h>
+#include <util/obfuscation.h>
+#include <util/translation.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <thread>
+#include <utility>
+
+namespace kernel {
+class Notifications;
+} // namespace kernel
+
+namespace node {
+
+/**
+ * Write-behind stage for blk?????.dat and rev?????.dat files.
+ *
+ * Block and undo data is serialized by the caller and handed to a single
+ * background thread, which performs the pre-allocation, write and fsync for
+ * each job strictly in submission order. Because of this ordering, a
+ * completed flush job guarantees that every write submitted before it to the
+ * same file has been committed to disk.
+ *
+ * Consecutive flushes of the same file are coalesced: a flush job is skipped
+ * when a later flush for the same file is already queued, so a burst of
+ * blocks results in a single fsync (group commit).
+ *
+ * The amount of queued data is bounded; submitting a write blocks while the
+ * queue is full. Errors on the writer thread are reported through the kernel
+ * notifications interface, and make subsequent calls to Sync() fail.
+ */
+class BlockWriteQueue
+{
+public:
+    struct Stats {
+        size_t pending_bytes{0};
+        size_t pending_jobs{0};
+        uint64_t writes{0};
+        uint64_t flushes{0};
+        uint64_t coalesced_flushes{0};
+    };
+
+    BlockWriteQueue(size_t max_pending_bytes, kernel::Notifications& notifications);
+    ~BlockWriteQueue();
+
+    BlockWriteQueue(const BlockWriteQueue&) = delete;
+    BlockWriteQueue& operator=(const BlockWriteQueue&) = delete;
+
+    /** Pre-allocate add_size bytes after pos, see FlatFileSeq::Allocate(). */
+    void Allocate(const FlatFileSeq& seq, const FlatFilePos& pos, size_t add_size) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /**
+     * Write data at pos, obfuscated with the given key. Blocks while the queue
+     * holds more than the configured maximum number of bytes.
+     */
+    void Write(const FlatFileSeq& seq, const Obfuscation& obfuscation, const FlatFilePos& pos, DataStream&& data, bilingual_str error_message) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Commit the file at pos to disk, see FlatFileSeq::Flush(). */
+    void Flush(const FlatFileSeq& seq, const FlatFilePos& pos, bool finalize, bilingual_str error_message) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Wait until every job submitted so far for the given file has completed. */
+    void WaitForFile(const FlatFileSeq& seq, int file) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /**
+     * Durability barrier: wait until every job submitted so far has completed.
+     *
+     * @return false if any job has failed since the queue was created.
+     */
+    [[nodiscard]] bool Sync() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    Stats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    enum class JobType {
+        ALLOCATE,
+        WRITE,
+        FLUSH,
+        FLUSH_FINALIZE,
+    };
+
+    struct Job {
+        uint64_t id{0};
+        JobType type{JobType::WRITE};
+        const FlatFileSeq* seq{nullptr};
+        FlatFilePos pos{};
+        size_t add_size{0};
+        Obfuscation obfuscation{};
+        DataStream data{};
+        bilingual_str error_message{};
+    };
+
+    using FileKey = std::pair<const FlatFileSeq*, int>;
+
+    void Submit(Job&& job) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    bool Run(Job& job) const;
+    void ThreadWrite() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    const size_t m_max_pending_bytes;
+    kernel::Notifications& m_notifications;
+
+    mutable Mutex m_mutex;
+    //! Signalled when a job is submitted or the queue is stopped.
+    std::condition_variable m_work_cv;
+    //! Signalled when a job has completed.
+    std::condition_variable m_done_cv;
+
+    std::deque<Job> m_jobs GUARDED_BY(m_mutex);
+    //! Id of the most recently submitted job per file, erased once it has completed.
+    std::map<FileKey, uint64_t> m_last_job_for_file GUARDED_BY(m_mutex);
+    uint64_t m_next_id GUARDED_BY(m_mutex){1};
+    uint64_t m_completed_id GUARDED_BY(m_mutex){0};
+    size_t m_pending_bytes GUARDED_BY(m_mutex){0};
+    bool m_failed GUARDED_BY(m_mutex){false};
+    bool m_stop GUARDED_BY(m_mutex){false};
+    Stats m_stats GUARDED_BY(m_mutex);
+
+    std::thread m_thread;
+};
+
+} // namespace node
+
+#endif // BITCOIN_NODE_BLOCKWRITEQUEUE_H
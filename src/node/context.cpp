@@ -6,6 +6,7 @@
 
 #include <addrman.h>
 #include <banman.h>
+#include <index/blockreader.h>
 #include <interfaces/chain.h>
 #include <interfaces/mining.h>
 #include <kernel/context.h>
@@ -19,6 +20,7 @@
 #include <scheduler.h>
 #include <torcontrol.h>
 #include <txmempool.h>
+#include <util/threadpool.h>
 #include <validation.h>
 #include <validationinterface.h>
 
@@ -21,10 +21,12 @@ class CConnman;
 class ValidationSignals;
 class CScheduler;
 class CTxMemPool;
+class IndexBlockReader;
 class ChainstateManager;
 class ECC_Context;
 class NetGroupManager;
 class PeerManager;
+class ThreadPool;
 class TorController;
 namespace interfaces {
 class Chain;
@@ -75,6 +77,10 @@ struct NodeContext {
     std::unique_ptr<BanMan> banman;
     ArgsManager* args{nullptr}; // Currently a raw pointer because the memory is not managed by this struct
     std::vector<BaseIndex*> indexes; // raw pointers because memory is not managed by this struct
+    //! Worker threads shared by the indexes during their initial sync, see -indexworkers.
+    std::unique_ptr<ThreadPool> index_threadpool;
+    //! Block data source shared by the indexes during their initial sync.
+    std::unique_ptr<IndexBlockReader> index_block_reader;
     std::unique_ptr<interfaces::Chain> chain;
     //! List of all chain clients (wallet processes or other client) connected to node.
     std::vector<std::unique_ptr<interfaces::ChainClient>> chain_clients;
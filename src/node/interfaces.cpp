@@ -86,6 +86,7 @@ using interfaces::Rpc;
 using interfaces::WalletLoader;
 using kernel::ChainstateRole;
 using node::BlockAssembler;
+using node::BlockTemplateCache;
 using node::BlockWaitOptions;
 using node::CoinbaseTx;
 using util::Join;
@@ -867,13 +868,14 @@ public:
 class BlockTemplateImpl : public BlockTemplate
 {
 public:
-    explicit BlockTemplateImpl(BlockAssembler::Options assemble_options,
+    explicit BlockTemplateImpl(std::shared_ptr<BlockTemplateCache> template_cache,
                                std::unique_ptr<CBlockTemplate> block_template,
-                               NodeContext& node) : m_assemble_options(std::move(assemble_options)),
+                               const CBlockTemplate& previous,
+                               NodeContext& node) : m_template_cache(std::move(template_cache)),
                                                     m_block_template(std::move(block_template)),
+                                                    m_delta(GetBlockTemplateDelta(previous, *Assert(m_block_template))),
                                                     m_node(node)
     {
-        assert(m_block_template);
     }
 
     CBlockHeader getBlockHeader() override
@@ -914,9 +916,13 @@ public:
 
     std::unique_ptr<BlockTemplate> waitNext(BlockWaitOptions options) override
     {
-        auto new_template = WaitAndCreateNewBlock(chainman(), notifications(), m_node.mempool.get(), m_block_template, options, m_assemble_options, m_interrupt_wait);
-        if (new_template) return std::make_unique<BlockTemplateImpl>(m_assemble_options, std::move(new_template), m_node);
-        return nullptr;
+        auto new_template = WaitAndCreateNewBlock(chainman(), notifications(), *m_template_cache, m_block_template, options, m_interrupt_wait);
+        if (!new_template) return nullptr;
+        // A template on a new tip is described in full, like one returned by createNewBlock()
+        if (new_template->block.hashPrevBlock != m_block_template->block.hashPrevBlock) {
+            return std::make_unique<BlockTemplateImpl>(m_template_cache, std::move(new_template), CBlockTemplate{}, m_node);
+        }
+        return std::make_unique<BlockTemplateImpl>(m_template_cache, std::move(new_template), *m_block_template, m_node);
     }
 
     void interruptWait() override
@@ -924,9 +930,17 @@ public:
         InterruptWait(notifications(), m_interrupt_wait);
     }
 
-    const BlockAssembler::Options m_assemble_options;
+    BlockTemplateDelta getDelta() override
+    {
+        return m_delta;
+    }
+
+    //! Shared by the templates returned by waitNext()
+    const std::shared_ptr<BlockTemplateCache> m_template_cache;
 
     const std::unique_ptr<CBlockTemplate> m_block_template;
+    //! Changes relative to the template this one was derived from
+    const BlockTemplateDelta m_delta;
 
     bool m_interrupt_wait{false};
     ChainstateManager& chainman() { return *Assert(m_node.chainman); }
@@ -993,7 +1007,9 @@ public:
 
         BlockAssembler::Options assemble_options{options};
         ApplyArgsManOptions(*Assert(m_node.args), assemble_options);
-        return std::make_unique<BlockTemplateImpl>(assemble_options, BlockAssembler{chainman().ActiveChainstate(), context()->mempool.get(), assemble_options}.CreateNewBlock(), m_node);
+        auto template_cache{std::make_shared<BlockTemplateCache>(chainman().ActiveChainstate(), context()->mempool.get(), assemble_options)};
+        auto block_template{template_cache->GetBlockTemplate()};
+        return std::make_unique<BlockTemplateImpl>(std::move(template_cache), std::move(block_template), CBlockTemplate{}, m_node);
     }
 
     void interrupt() override
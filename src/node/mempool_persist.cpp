@@ -5,10 +5,15 @@
 #include <node/mempool_persist.h>
 
 #include <clientversion.h>
+#include <coins.h>
 #include <consensus/amount.h>
 #include <logging.h>
+#include <policy/packages.h>
+#include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <random.h>
+#include <script/interpreter.h>
+#include <script/sigcache.h>
 #include <serialize.h>
 #include <streams.h>
 #include <sync.h>
@@ -16,20 +21,27 @@
 #include <uint256.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
+#include <util/hasher.h>
 #include <util/obfuscation.h>
 #include <util/signalinterrupt.h>
 #include <util/syserror.h>
+#include <util/threadpool.h>
 #include <util/time.h>
+#include <util/translation.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <exception>
 #include <functional>
+#include <future>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
 #include <stdexcept>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -40,6 +52,33 @@ namespace node {
 static const uint64_t MEMPOOL_DUMP_VERSION_NO_XOR_KEY{1};
 static const uint64_t MEMPOOL_DUMP_VERSION{2};
 
+namespace {
+//! Number of transactions that are read from the file and verified ahead of
+//! their submission to the mempool at a time
+constexpr size_t LOAD_BATCH_SIZE{1000};
+
+struct LoadedTx {
+    CTransactionRef tx;
+    int64_t time;
+    //! Pre-verification of the scripts, if it was started
+    std::optional<std::future<void>> verified;
+};
+
+/**
+ * Verify the scripts of a transaction with signature caching, so that its
+ * submission to the mempool finds the signatures in the cache. The result is
+ * not used otherwise, the mempool checks will fail the same way.
+ */
+void PreVerifyScripts(const CTransaction& tx, std::vector<CTxOut>& spent_outputs, SignatureCache& signature_cache)
+{
+    PrecomputedTransactionData txdata;
+    txdata.Init(tx, std::move(spent_outputs));
+    for (unsigned int i{0}; i < tx.vin.size(); ++i) {
+        if (CScriptCheck{txdata.m_spent_outputs[i], tx, signature_cache, i, STANDARD_SCRIPT_VERIFY_FLAGS, /*cacheIn=*/true, &txdata}()) return;
+    }
+}
+} // namespace
+
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active_chainstate, ImportMempoolOptions&& opts)
 {
     if (load_path.empty()) return false;
@@ -55,7 +94,58 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
     int64_t failed = 0;
     int64_t already_there = 0;
     int64_t unbroadcast = 0;
+    int64_t pre_verified = 0;
+    int64_t in_packages = 0;
     const auto now{NodeClock::now()};
+    ChainstateManager& chainman{active_chainstate.m_chainman};
+
+    // Transactions of the batch being submitted and of the next one. The
+    // thread pool is declared after them, so its tasks finish before they go away.
+    std::vector<LoadedTx> batch;
+    std::vector<LoadedTx> next_batch;
+    // Recently read transactions, which may not be in the mempool yet when
+    // their children are pre-verified
+    std::unordered_map<Txid, CTransactionRef, SaltedTxidHasher> recent_txs;
+    ThreadPool thread_pool{"mempoolload"};
+    if (chainman.m_options.worker_threads_num > 0) thread_pool.Start(chainman.m_options.worker_threads_num);
+
+    // Start verifying the scripts of the transactions whose spent outputs can be
+    // found, on the thread pool. This is best effort: a transaction whose
+    // parent is missing fails its submission anyway.
+    const auto pre_verify{[&](std::vector<LoadedTx>& txs) {
+        if (thread_pool.WorkersCount() == 0) return;
+        LOCK2(::cs_main, pool.cs);
+        const CCoinsViewCache& coins_tip{active_chainstate.CoinsTip()};
+        for (LoadedTx& loaded : txs) {
+            std::vector<CTxOut> spent_outputs;
+            spent_outputs.reserve(loaded.tx->vin.size());
+            for (const CTxIn& txin : loaded.tx->vin) {
+                CTransactionRef parent;
+                if (const auto it{recent_txs.find(txin.prevout.hash)}; it != recent_txs.end()) {
+                    parent = it->second;
+                } else {
+                    parent = pool.get(txin.prevout.hash);
+                }
+                if (parent) {
+                    if (txin.prevout.n >= parent->vout.size()) break;
+                    spent_outputs.push_back(parent->vout[txin.prevout.n]);
+                } else if (const Coin& coin{coins_tip.AccessCoin(txin.prevout)}; !coin.IsSpent()) {
+                    spent_outputs.push_back(coin.out);
+                } else {
+                    break;
+                }
+            }
+            recent_txs.emplace(loaded.tx->GetHash(), loaded.tx);
+            if (spent_outputs.size() != loaded.tx->vin.size()) continue;
+            auto future{thread_pool.Submit([tx = loaded.tx, spent_outputs = std::move(spent_outputs), &chainman]() mutable {
+                PreVerifyScripts(*tx, spent_outputs, chainman.m_validation_cache.m_signature_cache);
+            })};
+            if (future) {
+                loaded.verified = std::move(*future);
+                ++pre_verified;
+            }
+        }
+    }};
 
     try {
         uint64_t version;
@@ -73,55 +163,113 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
 
         uint64_t total_txns_to_load;
         file >> total_txns_to_load;
+        uint64_t txns_read = 0;
         uint64_t txns_tried = 0;
         LogInfo("Loading %u mempool transactions from file...\n", total_txns_to_load);
+        chainman.GetNotifications().progress(_("Loading mempool…"), 0, false);
         int next_tenth_to_report = 0;
-        while (txns_tried < total_txns_to_load) {
-            const int percentage_done(100.0 * txns_tried / total_txns_to_load);
-            if (next_tenth_to_report < percentage_done / 10) {
-                LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining)\n",
-                        percentage_done, txns_tried, total_txns_to_load - txns_tried);
-                next_tenth_to_report = percentage_done / 10;
-            }
-            ++txns_tried;
 
-            CTransactionRef tx;
-            int64_t nTime;
-            int64_t nFeeDelta;
-            file >> TX_WITH_WITNESS(tx);
-            file >> nTime;
-            file >> nFeeDelta;
+        // Read the next batch of unexpired transactions
+        const auto read_batch{[&](std::vector<LoadedTx>& txs) {
+            txs.clear();
+            while (txns_read < total_txns_to_load && txs.size() < LOAD_BATCH_SIZE) {
+                ++txns_read;
+                CTransactionRef tx;
+                int64_t nTime;
+                int64_t nFeeDelta;
+                file >> TX_WITH_WITNESS(tx);
+                file >> nTime;
+                file >> nFeeDelta;
+
+                if (opts.use_current_time) {
+                    nTime = TicksSinceEpoch<std::chrono::seconds>(now);
+                }
 
-            if (opts.use_current_time) {
-                nTime = TicksSinceEpoch<std::chrono::seconds>(now);
+                CAmount amountdelta = nFeeDelta;
+                if (amountdelta && opts.apply_fee_delta_priority) {
+                    pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
+                }
+                if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
+                    txs.push_back(LoadedTx{.tx = std::move(tx), .time = nTime, .verified = std::nullopt});
+                } else {
+                    ++expired;
+                    ++txns_tried;
+                }
             }
+        }};
+
+        // Low fee transactions that may be accepted along with a child paying for them
+        std::map<Txid, std::pair<uint64_t, CTransactionRef>> reconsiderable;
+
+        read_batch(next_batch);
+        pre_verify(next_batch);
+        while (!next_batch.empty()) {
+            std::swap(batch, next_batch);
+            // Read and pre-verify the next batch while this one is submitted
+            // in file order, which is topological.
+            recent_txs.clear();
+            for (const LoadedTx& loaded : batch) recent_txs.emplace(loaded.tx->GetHash(), loaded.tx);
+            read_batch(next_batch);
+            pre_verify(next_batch);
+
+            for (LoadedTx& loaded : batch) {
+                const int percentage_done(100.0 * txns_tried / total_txns_to_load);
+                if (next_tenth_to_report < percentage_done / 10) {
+                    LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining)\n",
+                            percentage_done, txns_tried, total_txns_to_load - txns_tried);
+                    chainman.GetNotifications().progress(_("Loading mempool…"), percentage_done, false);
+                    next_tenth_to_report = percentage_done / 10;
+                }
+                ++txns_tried;
 
-            CAmount amountdelta = nFeeDelta;
-            if (amountdelta && opts.apply_fee_delta_priority) {
-                pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
-            }
-            if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
+                if (loaded.verified) loaded.verified->wait();
+                const CTransactionRef& tx{loaded.tx};
                 LOCK(cs_main);
-                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
+                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, loaded.time, /*bypass_limits=*/false, /*test_accept=*/false);
                 if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
                     ++count;
-                } else {
+                } else if (pool.exists(tx->GetHash())) {
                     // mempool may contain the transaction already, e.g. from
                     // wallet(s) having loaded it while we were processing
                     // mempool transactions; consider these as valid, instead of
                     // failed, but mark them as 'already there'
-                    if (pool.exists(tx->GetHash())) {
-                        ++already_there;
-                    } else {
+                    ++already_there;
+                } else if (accepted.m_state.GetResult() == TxValidationResult::TX_RECONSIDERABLE) {
+                    reconsiderable.emplace(tx->GetHash(), std::make_pair(txns_tried, tx));
+                } else if (accepted.m_state.GetResult() == TxValidationResult::TX_MISSING_INPUTS) {
+                    // Submit the child together with its parents that were
+                    // too low fee on their own, in file order.
+                    std::vector<std::pair<uint64_t, CTransactionRef>> parents;
+                    for (const CTxIn& txin : tx->vin) {
+                        const auto it{reconsiderable.find(txin.prevout.hash)};
+                        if (it != reconsiderable.end() && std::ranges::find(parents, it->second) == parents.end()) parents.push_back(it->second);
+                    }
+                    if (parents.empty()) {
                         ++failed;
+                        continue;
+                    }
+                    std::ranges::sort(parents, {}, &std::pair<uint64_t, CTransactionRef>::first);
+                    Package package;
+                    for (const auto& [_, parent] : parents) package.push_back(parent);
+                    package.push_back(tx);
+                    (void)ProcessNewPackage(active_chainstate, pool, package, /*test_accept=*/false, /*client_maxfeerate=*/std::nullopt);
+                    for (const auto& package_tx : package) {
+                        if (!pool.exists(package_tx->GetHash())) continue;
+                        ++count;
+                        ++in_packages;
+                        reconsiderable.erase(package_tx->GetHash());
                     }
+                    if (!pool.exists(tx->GetHash())) ++failed;
+                } else {
+                    ++failed;
+                }
+                if (chainman.m_interrupt) {
+                    chainman.GetNotifications().progress(bilingual_str{}, 100, false);
+                    return false;
                 }
-            } else {
-                ++expired;
             }
-            if (active_chainstate.m_chainman.m_interrupt)
-                return false;
         }
+        failed += reconsiderable.size();
         std::map<Txid, CAmount> mapDeltas;
         file >> mapDeltas;
 
@@ -143,10 +291,13 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
         }
     } catch (const std::exception& e) {
         LogInfo("Failed to deserialize mempool data on file: %s. Continuing anyway.\n", e.what());
+        chainman.GetNotifications().progress(bilingual_str{}, 100, false);
         return false;
     }
 
-    LogInfo("Imported mempool transactions from file: %i succeeded, %i failed, %i expired, %i already there, %i waiting for initial broadcast\n", count, failed, expired, already_there, unbroadcast);
+    chainman.GetNotifications().progress(bilingual_str{}, 100, false);
+    LogInfo("Imported mempool transactions from file: %i succeeded (%i in packages), %i failed, %i expired, %i already there, %i waiting for initial broadcast, %i pre-verified on %i threads\n",
+            count, in_packages, failed, expired, already_there, unbroadcast, pre_verified, thread_pool.WorkersCount());
     return true;
 }
 
@@ -22,12 +22,15 @@
 #include <policy/policy.h>
 #include <pow.h>
 #include <primitives/transaction.h>
+#include <util/hasher.h>
 #include <util/moneystr.h>
 #include <util/signalinterrupt.h>
 #include <util/time.h>
 #include <validation.h>
 
 #include <algorithm>
+#include <span>
+#include <unordered_map>
 #include <utility>
 #include <numeric>
 
@@ -76,6 +79,41 @@ void RegenerateCommitments(CBlock& block, ChainstateManager& chainman)
     block.hashMerkleRoot = BlockMerkleRoot(block);
 }
 
+BlockTemplateDelta GetBlockTemplateDelta(const CBlockTemplate& previous, const CBlockTemplate& block_template)
+{
+    // Both fee and sigop vectors exclude the coinbase transaction, unlike CBlock::vtx
+    const auto previous_txs{std::span{previous.block.vtx}.last(previous.vTxFees.size())};
+    const auto txs{std::span{block_template.block.vtx}.last(block_template.vTxFees.size())};
+
+    std::unordered_map<Wtxid, uint32_t, SaltedWtxidHasher> previous_positions;
+    previous_positions.reserve(previous_txs.size());
+    for (uint32_t i{0}; i < previous_txs.size(); ++i) {
+        previous_positions.emplace(previous_txs[i]->GetWitnessHash(), i);
+    }
+
+    BlockTemplateDelta delta;
+    std::vector<bool> kept(previous_txs.size(), false);
+    delta.tx_order.reserve(txs.size());
+    for (size_t i{0}; i < txs.size(); ++i) {
+        if (const auto it{previous_positions.find(txs[i]->GetWitnessHash())}; it != previous_positions.end()) {
+            kept[it->second] = true;
+            delta.tx_order.push_back(it->second);
+        } else {
+            delta.tx_order.push_back(previous_txs.size() + delta.added.size());
+            delta.added.push_back(txs[i]);
+            delta.added_fees.push_back(block_template.vTxFees[i]);
+            delta.added_sigops.push_back(block_template.vTxSigOpsCost[i]);
+        }
+    }
+    for (size_t i{0}; i < previous_txs.size(); ++i) {
+        if (!kept[i]) delta.removed.push_back(previous_txs[i]->GetWitnessHash());
+    }
+    delta.coinbase_merkle_path = TransactionMerklePath(block_template.block, 0);
+    delta.previous_fees = std::accumulate(previous.vTxFees.begin(), previous.vTxFees.end(), CAmount{0});
+    delta.fees = std::accumulate(block_template.vTxFees.begin(), block_template.vTxFees.end(), CAmount{0});
+    return delta;
+}
+
 static BlockAssembler::Options ClampOptions(BlockAssembler::Options options)
 {
     // Apply DEFAULT_BLOCK_RESERVED_WEIGHT when the caller left it unset.
@@ -121,7 +159,15 @@ void BlockAssembler::resetBlock()
 
 std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock()
 {
-    const auto time_start{SteadyClock::now()};
+    LOCK(::cs_main);
+    SelectTransactions();
+    return FinishBlock();
+}
+
+void BlockAssembler::SelectTransactions()
+{
+    AssertLockHeld(::cs_main);
+    m_time_start = SteadyClock::now();
 
     resetBlock();
 
@@ -132,9 +178,9 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock()
     // getblocktemplate RPC and mining interface consumers must not use it.
     pblock->vtx.emplace_back();
 
-    LOCK(::cs_main);
-    CBlockIndex* pindexPrev = m_chainstate.m_chain.Tip();
+    const CBlockIndex* pindexPrev = m_chainstate.m_chain.Tip();
     assert(pindexPrev != nullptr);
+    m_prev_block = pindexPrev;
     nHeight = pindexPrev->nHeight + 1;
 
     pblock->nVersion = m_chainstate.m_chainman.m_versionbitscache.ComputeBlockVersion(pindexPrev, chainparams.GetConsensus());
@@ -153,6 +199,15 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock()
         addChunks();
         m_mempool->StopBlockBuilding();
     }
+}
+
+std::unique_ptr<CBlockTemplate> BlockAssembler::FinishBlock()
+{
+    AssertLockHeld(::cs_main);
+    // Must follow SelectTransactions() on the same tip
+    Assert(pblocktemplate && m_prev_block == m_chainstate.m_chain.Tip());
+    CBlock* const pblock = &pblocktemplate->block;
+    const CBlockIndex* const pindexPrev{m_prev_block};
 
     const auto time_1{SteadyClock::now()};
 
@@ -229,9 +284,9 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock()
     const auto time_2{SteadyClock::now()};
 
     LogDebug(BCLog::BENCH, "CreateNewBlock() chunks: %.2fms, validity: %.2fms (total %.2fms)\n",
-             Ticks<MillisecondsDouble>(time_1 - time_start),
+             Ticks<MillisecondsDouble>(time_1 - m_time_start),
              Ticks<MillisecondsDouble>(time_2 - time_1),
-             Ticks<MillisecondsDouble>(time_2 - time_start));
+             Ticks<MillisecondsDouble>(time_2 - m_time_start));
 
     return std::move(pblocktemplate);
 }
@@ -351,6 +406,68 @@ void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t
     block.fChecked = false;
 }
 
+BlockTemplateCache::BlockTemplateCache(Chainstate& chainstate, const CTxMemPool* mempool, const BlockAssembler::Options& options)
+    : m_chainstate{chainstate},
+      m_mempool{options.use_mempool ? mempool : nullptr},
+      m_options{options}
+{
+}
+
+std::unique_ptr<CBlockTemplate> BlockTemplateCache::GetBlockTemplate(CAmount min_fees)
+{
+    const auto time_start{SteadyClock::now()};
+    LOCK(::cs_main);
+    const CBlockIndex* tip{Assert(m_chainstate.m_chain.Tip())};
+
+    if (tip->GetBlockHash() != m_prev_hash) {
+        m_prev_hash = tip->GetBlockHash();
+        m_mempool_updates = m_mempool ? m_mempool->GetTransactionsUpdated() : 0;
+        auto block_template{BlockAssembler{m_chainstate, m_mempool, m_options}.CreateNewBlock()};
+        m_selected_fees = std::accumulate(block_template->vTxFees.begin(), block_template->vTxFees.end(), CAmount{0});
+        m_template = std::make_unique<CBlockTemplate>(*block_template);
+        const auto elapsed{SteadyClock::now() - time_start};
+        ++m_stats.full_builds;
+        m_stats.full_build_time += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+        LogDebug(BCLog::BENCH, "Built block template for new tip: %.2fms\n", Ticks<MillisecondsDouble>(elapsed));
+        return block_template;
+    }
+
+    // Read the counter before selecting, so that a concurrent mempool change
+    // can only cause a superfluous update later on.
+    const unsigned int mempool_updates{m_mempool ? m_mempool->GetTransactionsUpdated() : 0};
+    if (mempool_updates == m_mempool_updates && (m_template || m_selected_fees < min_fees)) {
+        ++m_stats.reused;
+        if (m_selected_fees < min_fees) return nullptr;
+        auto block_template{std::make_unique<CBlockTemplate>(*m_template)};
+        UpdateTime(&block_template->block, m_chainstate.m_chainman.GetConsensus(), tip);
+        return block_template;
+    }
+
+    BlockAssembler assembler{m_chainstate, m_mempool, m_options};
+    assembler.SelectTransactions();
+    m_mempool_updates = mempool_updates;
+    m_selected_fees = assembler.GetSelectedFees();
+    // Only complete the template when it will be returned
+    std::unique_ptr<CBlockTemplate> block_template;
+    m_template.reset();
+    if (m_selected_fees >= min_fees) {
+        block_template = assembler.FinishBlock();
+        m_template = std::make_unique<CBlockTemplate>(*block_template);
+    }
+    const auto elapsed{SteadyClock::now() - time_start};
+    ++m_stats.updates;
+    m_stats.update_time += std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+    LogDebug(BCLog::BENCH, "Updated block template for mempool changes: %.2fms (fees %d, %s)\n",
+             Ticks<MillisecondsDouble>(elapsed), m_selected_fees, block_template ? "completed" : "below threshold");
+    return block_template;
+}
+
+BlockTemplateCache::Stats BlockTemplateCache::GetStats() const
+{
+    LOCK(::cs_main);
+    return m_stats;
+}
+
 void InterruptWait(KernelNotifications& kernel_notifications, bool& interrupt_wait)
 {
     LOCK(kernel_notifications.m_tip_block_mutex);
@@ -360,10 +477,9 @@ void InterruptWait(KernelNotifications& kernel_notifications, bool& interrupt_wa
 
 std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainman,
                                                       KernelNotifications& kernel_notifications,
-                                                      CTxMemPool* mempool,
+                                                      BlockTemplateCache& template_cache,
                                                       const std::unique_ptr<CBlockTemplate>& block_template,
                                                       const BlockWaitOptions& options,
-                                                      const BlockAssembler::Options& assemble_options,
                                                       bool& interrupt_wait)
 {
     // Delay calculating the current template fees, just in case a new block
@@ -413,32 +529,25 @@ std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainma
         }
 
         /**
-         * We determine if fees increased compared to the previous template by generating
-         * a fresh template. There may be more efficient ways to determine how much
-         * (approximate) fees for the next block increased, perhaps more so after
-         * Cluster Mempool.
+         * We determine if fees increased compared to the previous template by
+         * selecting the transactions of a new one. The template cache skips
+         * this when the mempool did not change since the last check, and only
+         * completes the template when its fees are high enough.
          *
          * We'll also create a new template if the tip changed during this iteration.
          */
         if (options.fee_threshold < MAX_MONEY || tip_changed) {
-            auto new_tmpl{BlockAssembler{
-                chainman.ActiveChainstate(),
-                mempool,
-                assemble_options}
-                              .CreateNewBlock()};
-
             // If the tip changed, return the new template regardless of its fees.
-            if (tip_changed) return new_tmpl;
+            if (tip_changed) return template_cache.GetBlockTemplate();
 
             // Calculate the original template total fees if we haven't already
             if (current_fees == -1) {
                 current_fees = std::accumulate(block_template->vTxFees.begin(), block_template->vTxFees.end(), CAmount{0});
             }
 
-            // Check if fees increased enough to return the new template
-            const CAmount new_fees = std::accumulate(new_tmpl->vTxFees.begin(), new_tmpl->vTxFees.end(), CAmount{0});
+            // Return the new template if fees increased enough
             Assume(options.fee_threshold != MAX_MONEY);
-            if (new_fees >= current_fees + options.fee_threshold) return new_tmpl;
+            if (auto new_tmpl{template_cache.GetBlockTemplate(current_fees + options.fee_threshold)}) return new_tmpl;
         }
 
         now = NodeClock::now();
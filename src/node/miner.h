@@ -7,12 +7,15 @@
 #define BITCOIN_NODE_MINER_H
 
 #include <interfaces/types.h>
+#include <kernel/cs_main.h>
 #include <node/types.h>
 #include <policy/policy.h>
 #include <primitives/block.h>
 #include <txmempool.h>
 #include <util/feefrac.h>
+#include <util/time.h>
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -62,6 +65,9 @@ class BlockAssembler
 private:
     // The constructed block template
     std::unique_ptr<CBlockTemplate> pblocktemplate;
+    // The tip the block template builds on
+    const CBlockIndex* m_prev_block{nullptr};
+    SteadyClock::time_point m_time_start;
 
     // Information on the current status of the block
     uint64_t nBlockWeight;
@@ -92,6 +98,18 @@ public:
     /** Construct a new block template */
     std::unique_ptr<CBlockTemplate> CreateNewBlock();
 
+    /**
+     * Start a new block template on the current tip and select its
+     * transactions, without creating the coinbase transaction. This allows
+     * callers to look at the fees of the selection (GetSelectedFees()) before
+     * completing the template with FinishBlock().
+     */
+    void SelectTransactions() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+    /** Total fees of the transactions picked by SelectTransactions() */
+    CAmount GetSelectedFees() const { return nFees; }
+    /** Add the coinbase transaction and header to the selected transactions and return the template */
+    std::unique_ptr<CBlockTemplate> FinishBlock() EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+
     /** The number of transactions in the last assembled block (excluding coinbase transaction) */
     inline static std::optional<int64_t> m_last_block_num_txs{};
     /** The weight of the last assembled block (including reserved weight for block header, txs count and coinbase tx) */
@@ -122,6 +140,59 @@ private:
     bool TestChunkTransactions(const std::vector<CTxMemPoolEntryRef>& txs) const;
 };
 
+/**
+ * Block template for a fixed set of options that is kept up to date with the
+ * chain and the mempool, for callers that repeatedly ask for a better template
+ * (BlockTemplate::waitNext()).
+ *
+ * A new tip causes a full rebuild. Otherwise the template only needs to be
+ * updated when the mempool added, removed or reprioritised transactions since
+ * the last update (CTxMemPool::GetTransactionsUpdated()). In that case the
+ * transactions are selected again from the mempool's chunk order, which the
+ * TxGraph maintains incrementally, and the coinbase transaction, witness
+ * commitment and validity test are only done when the selection is good enough
+ * to be returned. When nothing changed, the last result is reused without
+ * touching the mempool.
+ */
+class BlockTemplateCache
+{
+public:
+    struct Stats {
+        //! Templates built because the tip changed
+        uint64_t full_builds{0};
+        //! Transaction selections redone because the mempool changed
+        uint64_t updates{0};
+        //! Requests answered without touching the mempool
+        uint64_t reused{0};
+        std::chrono::microseconds full_build_time{0};
+        std::chrono::microseconds update_time{0};
+    };
+
+    BlockTemplateCache(Chainstate& chainstate, const CTxMemPool* mempool, const BlockAssembler::Options& options);
+
+    /**
+     * Return a template for the current tip and mempool if the tip changed
+     * since the last call, or if its transaction fees are at least min_fees.
+     * Return nullptr otherwise.
+     */
+    std::unique_ptr<CBlockTemplate> GetBlockTemplate(CAmount min_fees = 0);
+
+    Stats GetStats() const;
+
+private:
+    Chainstate& m_chainstate;
+    const CTxMemPool* const m_mempool;
+    const BlockAssembler::Options m_options;
+
+    //! Tip, mempool update counter and total fees of the last transaction selection
+    uint256 m_prev_hash GUARDED_BY(::cs_main);
+    unsigned int m_mempool_updates GUARDED_BY(::cs_main){0};
+    CAmount m_selected_fees GUARDED_BY(::cs_main){0};
+    //! Completed template for the last selection, if it was completed
+    std::unique_ptr<CBlockTemplate> m_template GUARDED_BY(::cs_main);
+    Stats m_stats GUARDED_BY(::cs_main);
+};
+
 /**
  * Get the minimum time a miner should use in the next block. This always
  * accounts for the BIP94 timewarp rule, so does not necessarily reflect the
@@ -131,6 +202,9 @@ int64_t GetMinimumTime(const CBlockIndex* pindexPrev, int64_t difficulty_adjustm
 
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::Params& consensusParams, const CBlockIndex* pindexPrev);
 
+/** Compute the changes of block_template relative to previous, see BlockTemplate::getDelta() */
+BlockTemplateDelta GetBlockTemplateDelta(const CBlockTemplate& previous, const CBlockTemplate& block_template);
+
 /** Update an old GenerateCoinbaseCommitment from CreateNewBlock after the block txs have changed */
 void RegenerateCommitments(CBlock& block, ChainstateManager& chainman);
 
@@ -149,10 +223,9 @@ void InterruptWait(KernelNotifications& kernel_notifications, bool& interrupt_wa
  */
 std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainman,
                                                       KernelNotifications& kernel_notifications,
-                                                      CTxMemPool* mempool,
+                                                      BlockTemplateCache& template_cache,
                                                       const std::unique_ptr<CBlockTemplate>& block_template,
                                                       const BlockWaitOptions& options,
-                                                      const BlockAssembler::Options& assemble_options,
                                                       bool& interrupt_wait);
 
 /* Locks cs_main and returns the block hash and block height of the active chain if it exists; otherwise, returns nullopt.*/
@@ -158,6 +158,33 @@ struct CoinbaseTx {
     uint32_t lock_time;
 };
 
+/**
+ * Changes of a block template relative to the template it was returned from
+ * by waitNext(), so that clients can update their copy of the block without
+ * fetching and parsing it again. Transactions are identified by wtxid.
+ */
+struct BlockTemplateDelta {
+    //! Transactions of the previous template that are not in this one
+    std::vector<Wtxid> removed;
+    //! Transactions of this template that were not in the previous one, in block order
+    std::vector<CTransactionRef> added;
+    //! Fees and sigop costs of the added transactions
+    std::vector<CAmount> added_fees;
+    std::vector<int64_t> added_sigops;
+    /**
+     * For every transaction of this template (excluding the coinbase
+     * transaction), its position in the previous template (excluding the
+     * coinbase transaction), or the number of transactions of the previous
+     * template plus its position in `added`.
+     */
+    std::vector<uint32_t> tx_order;
+    //! Merkle path to the coinbase transaction, see BlockTemplate::getCoinbaseMerklePath()
+    std::vector<uint256> coinbase_merkle_path;
+    //! Total transaction fees of the previous template and of this one
+    CAmount previous_fees{0};
+    CAmount fees{0};
+};
+
 /**
  * How to broadcast a local transaction.
  * Used to influence `BroadcastTransaction()` and its callers.
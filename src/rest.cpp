@@ -8,10 +8,12 @@
 #include <blockfilter.h>
 #include <chain.h>
 #include <chainparams.h>
+#include <common/json_writer.h>
 #include <core_io.h>
 #include <flatfile.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
+#include <index/scriptindex.h>
 #include <index/txindex.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
@@ -33,6 +35,7 @@
 #include <validation.h>
 
 #include <any>
+#include <optional>
 #include <vector>
 
 #include <univalue.h>
@@ -43,6 +46,7 @@ using util::SplitString;
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
 static constexpr unsigned int MAX_REST_HEADERS_RESULTS = 2000;
+static constexpr unsigned int MAX_REST_SPENT_TXOUTS_RESULTS = 100;
 
 static const struct {
     RESTResponseFormat rf;
@@ -327,6 +331,20 @@ static bool rest_spent_txouts(const std::any& context, HTTPRequest* req, const s
         return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/spenttxouts/<hash>.<ext>");
     }
 
+    // With a count, return the spent outputs of that many consecutive blocks
+    // of the active chain, starting at the given block.
+    std::optional<size_t> count;
+    try {
+        if (const auto raw_count{req->GetQueryParameter("count")}) {
+            count = ToIntegral<size_t>(*raw_count);
+            if (!count.has_value() || *count < 1 || *count > MAX_REST_SPENT_TXOUTS_RESULTS) {
+                return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Block count is invalid or out of acceptable range (1-%u): %s", MAX_REST_SPENT_TXOUTS_RESULTS, *raw_count));
+            }
+        }
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+
     auto hash{uint256::FromHex(hashStr)};
     if (!hash) {
         return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
@@ -337,20 +355,54 @@ static bool rest_spent_txouts(const std::any& context, HTTPRequest* req, const s
         return false;
     }
 
-    const CBlockIndex* pblockindex = WITH_LOCK(cs_main, return chainman->m_blockman.LookupBlockIndex(*hash));
-    if (!pblockindex) {
-        return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+    std::vector<const CBlockIndex*> blocks;
+    {
+        LOCK(cs_main);
+        const CBlockIndex* pblockindex{chainman->m_blockman.LookupBlockIndex(*hash)};
+        if (!pblockindex) {
+            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        }
+        if (!count) {
+            blocks.push_back(pblockindex);
+        } else {
+            const CChain& active_chain{chainman->ActiveChain()};
+            if (!active_chain.Contains(*pblockindex)) {
+                return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found in the active chain");
+            }
+            for (; pblockindex && blocks.size() < *count; pblockindex = active_chain.Next(*pblockindex)) {
+                blocks.push_back(pblockindex);
+            }
+        }
+        for (const CBlockIndex* block : blocks) {
+            if (block->nHeight > 0 && !(block->nStatus & BLOCK_HAVE_UNDO)) {
+                return RESTERR(req, HTTP_NOT_FOUND, block->GetBlockHash().GetHex() + " undo not available");
+            }
+        }
     }
 
-    CBlockUndo block_undo;
-    if (pblockindex->nHeight > 0 && !chainman->m_blockman.ReadBlockUndo(block_undo, *pblockindex)) {
+    std::vector<CBlockUndo> block_undos;
+    if (!chainman->m_blockman.ReadBlockUndos(blocks, block_undos)) {
         return RESTERR(req, HTTP_NOT_FOUND, hashStr + " undo not available");
     }
 
+    // Without a count, the response is the spent outputs of the single block.
+    // With a count, it is a list of (block hash, spent outputs) pairs.
+    const auto serialize{[&](DataStream& stream) {
+        if (!count) {
+            SerializeBlockUndo(stream, block_undos.front());
+            return;
+        }
+        WriteCompactSize(stream, blocks.size());
+        for (size_t i{0}; i < blocks.size(); ++i) {
+            stream << blocks[i]->GetBlockHash();
+            SerializeBlockUndo(stream, block_undos[i]);
+        }
+    }};
+
     switch (rf) {
     case RESTResponseFormat::BINARY: {
         DataStream ssSpentResponse{};
-        SerializeBlockUndo(ssSpentResponse, block_undo);
+        serialize(ssSpentResponse);
         req->WriteHeader("Content-Type", "application/octet-stream");
         req->WriteReply(HTTP_OK, ssSpentResponse);
         return true;
@@ -358,7 +410,7 @@ static bool rest_spent_txouts(const std::any& context, HTTPRequest* req, const s
 
     case RESTResponseFormat::HEX: {
         DataStream ssSpentResponse{};
-        SerializeBlockUndo(ssSpentResponse, block_undo);
+        serialize(ssSpentResponse);
         const std::string strHex{HexStr(ssSpentResponse) + "\n"};
         req->WriteHeader("Content-Type", "text/plain");
         req->WriteReply(HTTP_OK, strHex);
@@ -367,7 +419,19 @@ static bool rest_spent_txouts(const std::any& context, HTTPRequest* req, const s
 
     case RESTResponseFormat::JSON: {
         UniValue result(UniValue::VARR);
-        BlockUndoToJSON(block_undo, result);
+        if (!count) {
+            BlockUndoToJSON(block_undos.front(), result);
+        } else {
+            for (size_t i{0}; i < blocks.size(); ++i) {
+                UniValue spent(UniValue::VARR);
+                BlockUndoToJSON(block_undos[i], spent);
+                UniValue entry(UniValue::VOBJ);
+                entry.pushKV("blockhash", blocks[i]->GetBlockHash().GetHex());
+                entry.pushKV("height", blocks[i]->nHeight);
+                entry.pushKV("spenttxouts", std::move(spent));
+                result.push_back(std::move(entry));
+            }
+        }
         std::string strJSON = result.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strJSON);
@@ -424,7 +488,7 @@ static bool rest_block(const std::any& context,
         pos = pblockindex->GetBlockPos();
     }
 
-    const auto block_data{chainman.m_blockman.ReadRawBlock(pos, block_part)};
+    const auto block_data{chainman.m_blockman.ReadRawBlock(pos, block_part, *hash)};
     if (!block_data) {
         switch (block_data.error()) {
         case node::ReadRawError::IO: return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "I/O error reading " + hashStr);
@@ -453,10 +517,9 @@ static bool rest_block(const std::any& context,
         if (tx_verbosity) {
             CBlock block{};
             SpanReader{*block_data} >> TX_WITH_WITNESS(block);
-            UniValue objBlock = blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, *tx_verbosity, chainman.GetConsensus().powLimit);
-            std::string strJSON = objBlock.write() + "\n";
-            req->WriteHeader("Content-Type", "application/json");
-            req->WriteReply(HTTP_OK, strJSON);
+            WriteJSONReply(*req, HTTP_OK, [&](JsonWriter& writer) {
+                blockToJSON(writer, chainman.m_blockman, block, *tip, *pblockindex, *tx_verbosity, chainman.GetConsensus().powLimit);
+            });
             return true;
         }
         return RESTERR(req, HTTP_BAD_REQUEST, "JSON output is not supported for this request type");
@@ -820,7 +883,10 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
             if (verbose && mempool_sequence) {
                 return RESTERR(req, HTTP_BAD_REQUEST, "Verbose results cannot contain mempool sequence values. (hint: set \"verbose=false\")");
             }
-            str_json = MempoolToJSON(*mempool, verbose, mempool_sequence).write() + "\n";
+            WriteJSONReply(*req, HTTP_OK, [&](JsonWriter& writer) {
+                MempoolToJSON(writer, *mempool, verbose, mempool_sequence);
+            });
+            return true;
         } else {
             str_json = MempoolInfoToJSON(*mempool).write() + "\n";
         }
@@ -880,11 +946,9 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
     }
 
     case RESTResponseFormat::JSON: {
-        UniValue objTx(UniValue::VOBJ);
-        TxToUniv(*tx, /*block_hash=*/hashBlock, /*entry=*/ objTx);
-        std::string strJSON = objTx.write() + "\n";
-        req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        WriteJSONReply(*req, HTTP_OK, [&](JsonWriter& writer) {
+            TxToJSON(writer, *tx, /*block_hash=*/hashBlock);
+        });
         return true;
     }
 
@@ -1138,6 +1202,57 @@ static bool rest_blockhash_by_height(const std::any& context, HTTPRequest* req,
     }
 }
 
+static bool rest_script_history(const std::any& context, HTTPRequest* req, const std::string& str_uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    std::string script_hex;
+    const RESTResponseFormat rf = ParseDataFormat(script_hex, str_uri_part);
+
+    const auto script_bytes{TryParseHex<uint8_t>(script_hex)};
+    if (!script_bytes) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid script: " + SanitizeString(script_hex, SAFE_CHARS_URI));
+    }
+    const CScript script(script_bytes->begin(), script_bytes->end());
+
+    size_t count{DEFAULT_SCRIPT_HISTORY_RESULTS};
+    std::optional<ScriptIndexEntry> after;
+    try {
+        if (const auto raw_count{req->GetQueryParameter("count")}) {
+            const auto parsed_count{ToIntegral<size_t>(*raw_count)};
+            if (!parsed_count || *parsed_count < 1 || *parsed_count > MAX_SCRIPT_HISTORY_RESULTS) {
+                return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Entry count is invalid or out of acceptable range (1-%u): %s", MAX_SCRIPT_HISTORY_RESULTS, *raw_count));
+            }
+            count = *parsed_count;
+        }
+        if (const auto cursor{req->GetQueryParameter("cursor")}) {
+            after = DecodeScriptHistoryCursor(*cursor);
+            if (!after) return RESTERR(req, HTTP_BAD_REQUEST, "Invalid cursor: " + SanitizeString(*cursor, SAFE_CHARS_URI));
+        }
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+
+    if (!g_scriptindex) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Index is not enabled, start with -scriptindex");
+    }
+    if (!g_scriptindex->BlockUntilSyncedToCurrentChain()) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "Script history is still in the process of being indexed.");
+    }
+
+    switch (rf) {
+    case RESTResponseFormat::JSON: {
+        std::vector<ScriptIndexEntry> entries;
+        const bool more{g_scriptindex->FindScriptHistory(script, after, count, entries)};
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteReply(HTTP_OK, ScriptHistoryToJSON(entries, more).write() + "\n");
+        return true;
+    }
+    default: {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+    }
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(const std::any& context, HTTPRequest* req, const std::string& strReq);
@@ -1156,6 +1271,7 @@ static const struct {
     {"/rest/deploymentinfo", rest_deploymentinfo},
     {"/rest/blockhashbyheight/", rest_blockhash_by_height},
     {"/rest/spenttxouts/", rest_spent_txouts},
+    {"/rest/scripthistory/", rest_script_history},
 };
 
 void StartREST(const std::any& context)
@@ -12,6 +12,7 @@
 #include <clientversion.h>
 #include <coins.h>
 #include <common/args.h>
+#include <common/json_writer.h>
 #include <consensus/amount.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
@@ -22,6 +23,7 @@
 #include <hash.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scriptindex.h>
 #include <interfaces/mining.h>
 #include <kernel/coinstats.h>
 #include <logging/timer.h>
@@ -208,6 +210,20 @@ UniValue coinbaseTxToJSON(const CTransaction& coinbase_tx)
     return coinbase_tx_obj;
 }
 
+/** Read the undo data of a block if it is needed for verbosity and available. Throws before anything is written. */
+static std::optional<CBlockUndo> ReadBlockUndoForJSON(BlockManager& blockman, const CBlockIndex& blockindex, TxVerbosity verbosity)
+{
+    if (verbosity == TxVerbosity::SHOW_TXID) return std::nullopt;
+    const bool is_not_pruned{WITH_LOCK(::cs_main, return !blockman.IsBlockPruned(blockindex))};
+    const bool have_undo{is_not_pruned && WITH_LOCK(::cs_main, return blockindex.nStatus & BLOCK_HAVE_UNDO)};
+    if (!have_undo) return std::nullopt;
+    CBlockUndo blockUndo;
+    if (!blockman.ReadBlockUndo(blockUndo, blockindex)) {
+        throw JSONRPCError(RPC_INTERNAL_ERROR, "Undo data expected but can't be read. This could be due to disk corruption or a conflict with a pruning event.");
+    }
+    return blockUndo;
+}
+
 UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
 {
     UniValue result = blockheaderToJSON(tip, blockindex, pow_limit);
@@ -231,16 +247,11 @@ UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIn
 
         case TxVerbosity::SHOW_DETAILS:
         case TxVerbosity::SHOW_DETAILS_AND_PREVOUT:
-            CBlockUndo blockUndo;
-            const bool is_not_pruned{WITH_LOCK(::cs_main, return !blockman.IsBlockPruned(blockindex))};
-            bool have_undo{is_not_pruned && WITH_LOCK(::cs_main, return blockindex.nStatus & BLOCK_HAVE_UNDO)};
-            if (have_undo && !blockman.ReadBlockUndo(blockUndo, blockindex)) {
-                throw JSONRPCError(RPC_INTERNAL_ERROR, "Undo data expected but can't be read. This could be due to disk corruption or a conflict with a pruning event.");
-            }
+            const std::optional<CBlockUndo> blockUndo{ReadBlockUndoForJSON(blockman, blockindex, verbosity)};
             for (size_t i = 0; i < block.vtx.size(); ++i) {
                 const CTransactionRef& tx = block.vtx.at(i);
                 // coinbase transaction (i.e. i == 0) doesn't have undo data
-                const CTxUndo* txundo = (have_undo && i > 0) ? &blockUndo.vtxundo.at(i - 1) : nullptr;
+                const CTxUndo* txundo = (blockUndo && i > 0) ? &blockUndo->vtxundo.at(i - 1) : nullptr;
                 UniValue objTx(UniValue::VOBJ);
                 TxToUniv(*tx, /*block_hash=*/uint256(), /*entry=*/objTx, /*include_hex=*/true, txundo, verbosity);
                 txs.push_back(std::move(objTx));
@@ -253,6 +264,38 @@ UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIn
     return result;
 }
 
+void blockToJSON(JsonWriter& writer, BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
+{
+    CHECK_NONFATAL(!block.vtx.empty());
+    const std::optional<CBlockUndo> blockUndo{ReadBlockUndoForJSON(blockman, blockindex, verbosity)};
+
+    writer.BeginObject();
+    writer.Members(blockheaderToJSON(tip, blockindex, pow_limit));
+    writer.Key("strippedsize");
+    writer.Value(::GetSerializeSize(TX_NO_WITNESS(block)));
+    writer.Key("size");
+    writer.Value(::GetSerializeSize(TX_WITH_WITNESS(block)));
+    writer.Key("weight");
+    writer.Value(::GetBlockWeight(block));
+    writer.Key("coinbase_tx");
+    writer.Value(coinbaseTxToJSON(*block.vtx[0]));
+
+    writer.Key("tx");
+    writer.BeginArray();
+    for (size_t i = 0; i < block.vtx.size(); ++i) {
+        const CTransaction& tx{*block.vtx[i]};
+        if (verbosity == TxVerbosity::SHOW_TXID) {
+            writer.String(tx.GetHash().GetHex());
+            continue;
+        }
+        // coinbase transaction (i.e. i == 0) doesn't have undo data
+        const CTxUndo* txundo = (blockUndo && i > 0) ? &blockUndo->vtxundo.at(i - 1) : nullptr;
+        TxToJSON(writer, tx, /*block_hash=*/uint256(), /*include_hex=*/true, txundo, verbosity);
+    }
+    writer.EndArray();
+    writer.EndObject();
+}
+
 static RPCMethod getblockcount()
 {
     return RPCMethod{
@@ -718,7 +761,7 @@ static std::vector<std::byte> GetRawBlockChecked(BlockManager& blockman, const C
         pos = blockindex.GetBlockPos();
     }
 
-    if (auto data{blockman.ReadRawBlock(pos)}) return std::move(*data);
+    if (auto data{blockman.ReadRawBlock(pos, /*block_part=*/std::nullopt, blockindex.GetBlockHash())}) return std::move(*data);
     // Block not found on disk. This shouldn't normally happen unless the block was
     // pruned right after we released the lock above.
     throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
@@ -3044,6 +3087,96 @@ static RPCMethod getblockfilter()
     };
 }
 
+UniValue ScriptHistoryToJSON(const std::vector<ScriptIndexEntry>& entries, bool more)
+{
+    UniValue history(UniValue::VARR);
+    for (const ScriptIndexEntry& entry : entries) {
+        UniValue obj(UniValue::VOBJ);
+        const bool spending{entry.type == ScriptIndexEntry::Type::SPENDING};
+        obj.pushKV("type", spending ? "spending" : "funding");
+        obj.pushKV("height", entry.height);
+        obj.pushKV("txid", entry.outpoint.hash.GetHex());
+        obj.pushKV("vout", entry.outpoint.n);
+        obj.pushKV("value", ValueFromAmount(entry.amount));
+        if (spending) {
+            obj.pushKV("spending_txid", entry.spending_txid.GetHex());
+            obj.pushKV("spending_vin", entry.spending_input);
+        }
+        history.push_back(std::move(obj));
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("history", std::move(history));
+    if (more) ret.pushKV("cursor", EncodeScriptHistoryCursor(entries.back()));
+    return ret;
+}
+
+static RPCMethod getscripthistory()
+{
+    return RPCMethod{
+        "getscripthistory",
+        "Return the outputs paying to a scriptPubKey and the inputs spending them, in block height order.\n"
+        "Requires -scriptindex. Results are paginated: if the history has more entries than requested, the\n"
+        "result includes a cursor to pass to the next call.\n",
+        {
+            {"scriptPubKey", RPCArg::Type::STR_HEX, RPCArg::Optional::NO, "The hex-encoded scriptPubKey"},
+            {"count", RPCArg::Type::NUM, RPCArg::Default{DEFAULT_SCRIPT_HISTORY_RESULTS}, strprintf("The maximum number of entries to return (1-%d)", MAX_SCRIPT_HISTORY_RESULTS)},
+            {"cursor", RPCArg::Type::STR_HEX, RPCArg::Optional::OMITTED, "The cursor returned by a previous call, to continue after its last entry"},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::ARR, "history", "",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR, "type", "\"funding\" for an output paying to the script, \"spending\" for an input spending such an output"},
+                        {RPCResult::Type::NUM, "height", "The height of the block containing the transaction"},
+                        {RPCResult::Type::STR_HEX, "txid", "The transaction id of the output"},
+                        {RPCResult::Type::NUM, "vout", "The index of the output"},
+                        {RPCResult::Type::STR_AMOUNT, "value", "The value of the output in " + CURRENCY_UNIT},
+                        {RPCResult::Type::STR_HEX, "spending_txid", /*optional=*/true, "The transaction id of the spending transaction"},
+                        {RPCResult::Type::NUM, "spending_vin", /*optional=*/true, "The index of the spending input"},
+                    }},
+                }},
+                {RPCResult::Type::STR_HEX, "cursor", /*optional=*/true, "If there are more entries, the cursor to continue with"},
+            }},
+        RPCExamples{
+            HelpExampleCli("getscripthistory", "\"0014751e76e8199196d454941c45d1b3a323f1433bd6\"") +
+            HelpExampleCli("getscripthistory", "\"0014751e76e8199196d454941c45d1b3a323f1433bd6\" 10 \"<cursor>\"") +
+            HelpExampleRpc("getscripthistory", "\"0014751e76e8199196d454941c45d1b3a323f1433bd6\", 10")
+        },
+        [](const RPCMethod& self, const JSONRPCRequest& request) -> UniValue
+{
+    const std::vector<unsigned char> script_bytes{ParseHexV(request.params[0], "scriptPubKey")};
+    const CScript script(script_bytes.begin(), script_bytes.end());
+
+    const int count{self.Arg<int>("count")};
+    if (count < 1 || count > static_cast<int>(MAX_SCRIPT_HISTORY_RESULTS)) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("count must be between 1 and %d", MAX_SCRIPT_HISTORY_RESULTS));
+    }
+
+    std::optional<ScriptIndexEntry> after;
+    if (const auto cursor{self.MaybeArg<std::string_view>("cursor")}) {
+        after = DecodeScriptHistoryCursor(*cursor);
+        if (!after) throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    }
+
+    if (!g_scriptindex) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Requires scriptindex. Start bitcoind with -scriptindex.");
+    }
+    if (!g_scriptindex->BlockUntilSyncedToCurrentChain()) {
+        const IndexSummary summary{g_scriptindex->GetSummary()};
+        throw JSONRPCError(RPC_MISC_ERROR, strprintf("Unable to get data because scriptindex is still syncing. Current height: %d", summary.best_block_height));
+    }
+
+    std::vector<ScriptIndexEntry> entries;
+    const bool more{g_scriptindex->FindScriptHistory(script, after, count, entries)};
+    return ScriptHistoryToJSON(entries, more);
+},
+    };
+}
+
 /**
  * RAII class that registers a prune lock in its constructor to prevent
  * block data from being pruned, and removes it in its destructor.
@@ -3664,6 +3797,7 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &scanblocks},
         {"blockchain", &getdescriptoractivity},
         {"blockchain", &getblockfilter},
+        {"blockchain", &getscripthistory},
         {"blockchain", &dumptxoutset},
         {"blockchain", &loadtxoutset},
         {"blockchain", &getchainstates},
@@ -20,8 +20,10 @@
 class CBlock;
 class CBlockIndex;
 class CChain;
+class JsonWriter;
 class Chainstate;
 class UniValue;
+struct ScriptIndexEntry;
 namespace node {
 class BlockManager;
 struct NodeContext;
@@ -29,6 +31,10 @@ struct NodeContext;
 
 static constexpr int NUM_GETBLOCKSTATS_PERCENTILES = 5;
 
+/** Default and maximum number of script history entries returned by one query */
+static constexpr unsigned int DEFAULT_SCRIPT_HISTORY_RESULTS{100};
+static constexpr unsigned int MAX_SCRIPT_HISTORY_RESULTS{1000};
+
 /**
  * Get the difficulty of the net wrt to the given block index.
  *
@@ -40,9 +46,15 @@ double GetDifficulty(const CBlockIndex& blockindex);
 /** Block description to JSON */
 UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
 
+/** Stream the same block description as blockToJSON into writer, one transaction at a time */
+void blockToJSON(JsonWriter& writer, node::BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
+
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex, uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
 
+/** Script history entries to JSON, with a cursor to the next page if there are more entries */
+UniValue ScriptHistoryToJSON(const std::vector<ScriptIndexEntry>& entries, bool more);
+
 /** Used by getblockstats to get feerates at different percentiles by weight  */
 void CalculatePercentilesByWeight(CAmount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<CAmount, int64_t>>& scores, int64_t total_weight);
 
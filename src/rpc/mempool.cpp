@@ -9,6 +9,7 @@
 
 #include <chainparams.h>
 #include <common/args.h>
+#include <common/json_writer.h>
 #include <consensus/validation.h>
 #include <core_io.h>
 #include <index/txospenderindex.h>
@@ -31,9 +32,15 @@
 #include <util/time.h>
 #include <util/vector.h>
 
+#include <chrono>
 #include <map>
+#include <optional>
+#include <set>
+#include <string>
 #include <string_view>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 using node::DumpMempool;
 
@@ -510,39 +517,103 @@ static void clusterToJSON(const CTxMemPool& pool, UniValue& info, std::vector<co
     info.pushKV("chunks", std::move(all_chunks));
 }
 
-static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
+namespace {
+/**
+ * The data of a mempool entry that is returned by the RPCs. It is copied while
+ * holding the mempool lock, so the much more expensive conversion to JSON can
+ * happen after releasing it, without blocking transaction acceptance.
+ */
+struct MempoolEntrySnapshot {
+    CTransactionRef tx;
+    int32_t vsize;
+    int32_t weight;
+    std::chrono::seconds time;
+    unsigned int height;
+    size_t descendant_count;
+    size_t descendant_size;
+    CAmount descendant_fees;
+    size_t ancestor_count;
+    size_t ancestor_size;
+    CAmount ancestor_fees;
+    FeePerWeight chunk_feerate;
+    CAmount fee;
+    CAmount modified_fee;
+    std::vector<Txid> depends;
+    std::vector<Txid> spent_by;
+    bool unbroadcast;
+    std::optional<bool> bip125_replaceable;
+};
+} // namespace
+
+static MempoolEntrySnapshot SnapshotEntry(const CTxMemPool& pool, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
 {
     AssertLockHeld(pool.cs);
 
-    auto [ancestor_count, ancestor_size, ancestor_fees] = pool.CalculateAncestorData(e);
-    auto [descendant_count, descendant_size, descendant_fees] = pool.CalculateDescendantData(e);
-
-    info.pushKV("vsize", e.GetTxSize());
-    info.pushKV("weight", e.GetTxWeight());
-    info.pushKV("time", count_seconds(e.GetTime()));
-    info.pushKV("height", e.GetHeight());
-    info.pushKV("descendantcount", descendant_count);
-    info.pushKV("descendantsize", descendant_size);
-    info.pushKV("ancestorcount", ancestor_count);
-    info.pushKV("ancestorsize", ancestor_size);
-    info.pushKV("wtxid", e.GetTx().GetWitnessHash().ToString());
-    auto feerate = pool.GetMainChunkFeerate(e);
-    info.pushKV("chunkweight", feerate.size);
+    MempoolEntrySnapshot snapshot{
+        .tx = e.GetSharedTx(),
+        .vsize = e.GetTxSize(),
+        .weight = e.GetTxWeight(),
+        .time = e.GetTime(),
+        .height = e.GetHeight(),
+        .descendant_count = 0,
+        .descendant_size = 0,
+        .descendant_fees = 0,
+        .ancestor_count = 0,
+        .ancestor_size = 0,
+        .ancestor_fees = 0,
+        .chunk_feerate = pool.GetMainChunkFeerate(e),
+        .fee = e.GetFee(),
+        .modified_fee = e.GetModifiedFee(),
+        .depends = {},
+        .spent_by = {},
+        .unbroadcast = pool.IsUnbroadcastTx(e.GetTx().GetHash()),
+        .bip125_replaceable = std::nullopt,
+    };
+    std::tie(snapshot.ancestor_count, snapshot.ancestor_size, snapshot.ancestor_fees) = pool.CalculateAncestorData(e);
+    std::tie(snapshot.descendant_count, snapshot.descendant_size, snapshot.descendant_fees) = pool.CalculateDescendantData(e);
+
+    for (const CTxIn& txin : e.GetTx().vin) {
+        if (pool.exists(txin.prevout.hash)) snapshot.depends.push_back(txin.prevout.hash);
+    }
+    for (const CTxMemPoolEntry& child : pool.GetChildren(e)) {
+        snapshot.spent_by.push_back(child.GetTx().GetHash());
+    }
+
+    // Add opt-in RBF status
+    if (IsDeprecatedRPCEnabled("bip125")) {
+        RBFTransactionState rbfState = IsRBFOptIn(e.GetTx(), pool);
+        if (rbfState == RBFTransactionState::UNKNOWN) {
+            throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
+        }
+        snapshot.bip125_replaceable = rbfState == RBFTransactionState::REPLACEABLE_BIP125;
+    }
+    return snapshot;
+}
+
+static void entryToJSON(UniValue& info, const MempoolEntrySnapshot& e)
+{
+    info.pushKV("vsize", e.vsize);
+    info.pushKV("weight", e.weight);
+    info.pushKV("time", count_seconds(e.time));
+    info.pushKV("height", e.height);
+    info.pushKV("descendantcount", e.descendant_count);
+    info.pushKV("descendantsize", e.descendant_size);
+    info.pushKV("ancestorcount", e.ancestor_count);
+    info.pushKV("ancestorsize", e.ancestor_size);
+    info.pushKV("wtxid", e.tx->GetWitnessHash().ToString());
+    info.pushKV("chunkweight", e.chunk_feerate.size);
 
     UniValue fees(UniValue::VOBJ);
-    fees.pushKV("base", ValueFromAmount(e.GetFee()));
-    fees.pushKV("modified", ValueFromAmount(e.GetModifiedFee()));
-    fees.pushKV("ancestor", ValueFromAmount(ancestor_fees));
-    fees.pushKV("descendant", ValueFromAmount(descendant_fees));
-    fees.pushKV("chunk", ValueFromAmount(feerate.fee));
+    fees.pushKV("base", ValueFromAmount(e.fee));
+    fees.pushKV("modified", ValueFromAmount(e.modified_fee));
+    fees.pushKV("ancestor", ValueFromAmount(e.ancestor_fees));
+    fees.pushKV("descendant", ValueFromAmount(e.descendant_fees));
+    fees.pushKV("chunk", ValueFromAmount(e.chunk_feerate.fee));
     info.pushKV("fees", std::move(fees));
 
-    const CTransaction& tx = e.GetTx();
     std::set<std::string> setDepends;
-    for (const CTxIn& txin : tx.vin)
-    {
-        if (pool.exists(txin.prevout.hash))
-            setDepends.insert(txin.prevout.hash.ToString());
+    for (const Txid& dep : e.depends) {
+        setDepends.insert(dep.ToString());
     }
 
     UniValue depends(UniValue::VARR);
@@ -554,24 +625,31 @@ static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPool
     info.pushKV("depends", std::move(depends));
 
     UniValue spent(UniValue::VARR);
-    for (const CTxMemPoolEntry& child : pool.GetChildren(e)) {
-        spent.push_back(child.GetTx().GetHash().ToString());
+    for (const Txid& child : e.spent_by) {
+        spent.push_back(child.ToString());
     }
 
     info.pushKV("spentby", std::move(spent));
-    info.pushKV("unbroadcast", pool.IsUnbroadcastTx(tx.GetHash()));
+    info.pushKV("unbroadcast", e.unbroadcast);
 
-    // Add opt-in RBF status
-    if (IsDeprecatedRPCEnabled("bip125")) {
-        bool rbfStatus = false;
-        RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
-        if (rbfState == RBFTransactionState::UNKNOWN) {
-            throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
-        } else if (rbfState == RBFTransactionState::REPLACEABLE_BIP125) {
-            rbfStatus = true;
-        }
-        info.pushKV("bip125-replaceable", rbfStatus);
+    if (e.bip125_replaceable) {
+        info.pushKV("bip125-replaceable", *e.bip125_replaceable);
+    }
+}
+
+/** Convert snapshots of mempool entries to a JSON object keyed by txid. */
+static UniValue EntriesToJSON(const std::vector<MempoolEntrySnapshot>& entries)
+{
+    UniValue o(UniValue::VOBJ);
+    for (const MempoolEntrySnapshot& e : entries) {
+        UniValue info(UniValue::VOBJ);
+        entryToJSON(info, e);
+        // Mempool has unique entries so there is no advantage in using
+        // UniValue::pushKV, which checks if the key already exists in O(N).
+        // UniValue::pushKVEnd is used instead which currently is O(1).
+        o.pushKVEnd(e.tx->GetHash().ToString(), std::move(info));
     }
+    return o;
 }
 
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempool_sequence)
@@ -580,27 +658,30 @@ UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempoo
         if (include_mempool_sequence) {
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values.");
         }
-        LOCK(pool.cs);
-        UniValue o(UniValue::VOBJ);
-        for (const CTxMemPoolEntry& e : pool.entryAll()) {
-            UniValue info(UniValue::VOBJ);
-            entryToJSON(pool, info, e);
-            // Mempool has unique entries so there is no advantage in using
-            // UniValue::pushKV, which checks if the key already exists in O(N).
-            // UniValue::pushKVEnd is used instead which currently is O(1).
-            o.pushKVEnd(e.GetTx().GetHash().ToString(), std::move(info));
+        std::vector<MempoolEntrySnapshot> entries;
+        {
+            LOCK(pool.cs);
+            entries.reserve(pool.size());
+            for (const CTxMemPoolEntry& e : pool.entryAll()) {
+                entries.push_back(SnapshotEntry(pool, e));
+            }
         }
-        return o;
+        return EntriesToJSON(entries);
     } else {
-        UniValue a(UniValue::VARR);
+        std::vector<Txid> txids;
         uint64_t mempool_sequence;
         {
             LOCK(pool.cs);
+            txids.reserve(pool.size());
             for (const CTxMemPoolEntry& e : pool.entryAll()) {
-                a.push_back(e.GetTx().GetHash().ToString());
+                txids.push_back(e.GetTx().GetHash());
             }
             mempool_sequence = pool.GetSequence();
         }
+        UniValue a(UniValue::VARR);
+        for (const Txid& txid : txids) {
+            a.push_back(txid.ToString());
+        }
         if (!include_mempool_sequence) {
             return a;
         } else {
@@ -612,6 +693,33 @@ UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempoo
     }
 }
 
+void MempoolToJSON(JsonWriter& writer, const CTxMemPool& pool, bool verbose, bool include_mempool_sequence)
+{
+    if (!verbose) {
+        writer.Value(MempoolToJSON(pool, verbose, include_mempool_sequence));
+        return;
+    }
+    if (include_mempool_sequence) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values.");
+    }
+    std::vector<MempoolEntrySnapshot> entries;
+    {
+        LOCK(pool.cs);
+        entries.reserve(pool.size());
+        for (const CTxMemPoolEntry& e : pool.entryAll()) {
+            entries.push_back(SnapshotEntry(pool, e));
+        }
+    }
+    writer.BeginObject();
+    for (const MempoolEntrySnapshot& e : entries) {
+        UniValue info(UniValue::VOBJ);
+        entryToJSON(info, e);
+        writer.Key(e.tx->GetHash().ToString());
+        writer.Value(info);
+    }
+    writer.EndObject();
+}
+
 static RPCMethod getmempoolfeeratediagram()
 {
     return RPCMethod{"getmempoolfeeratediagram",
@@ -738,31 +846,30 @@ static RPCMethod getmempoolancestors()
     auto txid{Txid::FromUint256(ParseHashV(request.params[0], "txid"))};
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
+    std::vector<MempoolEntrySnapshot> entries;
+    {
+        LOCK(mempool.cs);
 
-    const auto entry{mempool.GetEntry(txid)};
-    if (entry == nullptr) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
-    }
+        const auto entry{mempool.GetEntry(txid)};
+        if (entry == nullptr) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
+        }
 
-    auto ancestors{mempool.CalculateMemPoolAncestors(*entry)};
+        auto ancestors{mempool.CalculateMemPoolAncestors(*entry)};
 
-    if (!fVerbose) {
-        UniValue o(UniValue::VARR);
-        for (CTxMemPool::txiter ancestorIt : ancestors) {
-            o.push_back(ancestorIt->GetTx().GetHash().ToString());
+        if (!fVerbose) {
+            UniValue o(UniValue::VARR);
+            for (CTxMemPool::txiter ancestorIt : ancestors) {
+                o.push_back(ancestorIt->GetTx().GetHash().ToString());
+            }
+            return o;
         }
-        return o;
-    } else {
-        UniValue o(UniValue::VOBJ);
+        entries.reserve(ancestors.size());
         for (CTxMemPool::txiter ancestorIt : ancestors) {
-            const CTxMemPoolEntry &e = *ancestorIt;
-            UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
-            o.pushKV(e.GetTx().GetHash().ToString(), std::move(info));
+            entries.push_back(SnapshotEntry(mempool, *ancestorIt));
         }
-        return o;
     }
+    return EntriesToJSON(entries);
 },
     };
 }
@@ -799,35 +906,34 @@ static RPCMethod getmempooldescendants()
     auto txid{Txid::FromUint256(ParseHashV(request.params[0], "txid"))};
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
+    std::vector<MempoolEntrySnapshot> entries;
+    {
+        LOCK(mempool.cs);
 
-    const auto it{mempool.GetIter(txid)};
-    if (!it) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
-    }
+        const auto it{mempool.GetIter(txid)};
+        if (!it) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
+        }
 
-    CTxMemPool::setEntries setDescendants;
-    mempool.CalculateDescendants(*it, setDescendants);
-    // CTxMemPool::CalculateDescendants will include the given tx
-    setDescendants.erase(*it);
+        CTxMemPool::setEntries setDescendants;
+        mempool.CalculateDescendants(*it, setDescendants);
+        // CTxMemPool::CalculateDescendants will include the given tx
+        setDescendants.erase(*it);
 
-    if (!fVerbose) {
-        UniValue o(UniValue::VARR);
-        for (CTxMemPool::txiter descendantIt : setDescendants) {
-            o.push_back(descendantIt->GetTx().GetHash().ToString());
-        }
+        if (!fVerbose) {
+            UniValue o(UniValue::VARR);
+            for (CTxMemPool::txiter descendantIt : setDescendants) {
+                o.push_back(descendantIt->GetTx().GetHash().ToString());
+            }
 
-        return o;
-    } else {
-        UniValue o(UniValue::VOBJ);
+            return o;
+        }
+        entries.reserve(setDescendants.size());
         for (CTxMemPool::txiter descendantIt : setDescendants) {
-            const CTxMemPoolEntry &e = *descendantIt;
-            UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
-            o.pushKV(e.GetTx().GetHash().ToString(), std::move(info));
+            entries.push_back(SnapshotEntry(mempool, *descendantIt));
         }
-        return o;
     }
+    return EntriesToJSON(entries);
 },
     };
 }
@@ -886,15 +992,18 @@ static RPCMethod getmempoolentry()
     auto txid{Txid::FromUint256(ParseHashV(request.params[0], "txid"))};
 
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
-    LOCK(mempool.cs);
+    const MempoolEntrySnapshot snapshot{[&] {
+        LOCK(mempool.cs);
 
-    const auto entry{mempool.GetEntry(txid)};
-    if (entry == nullptr) {
-        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
-    }
+        const auto entry{mempool.GetEntry(txid)};
+        if (entry == nullptr) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Transaction not in mempool");
+        }
+        return SnapshotEntry(mempool, *entry);
+    }()};
 
     UniValue info(UniValue::VOBJ);
-    entryToJSON(mempool, info, *entry);
+    entryToJSON(info, snapshot);
     return info;
 },
     };
@@ -1055,6 +1164,7 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool)
     ret.pushKV("size", pool.size());
     ret.pushKV("bytes", pool.GetTotalTxSize());
     ret.pushKV("usage", pool.DynamicMemoryUsage());
+    ret.pushKV("allocated", pool.AllocatedMemoryUsage());
     ret.pushKV("total_fee", ValueFromAmount(pool.GetTotalFee()));
     ret.pushKV("maxmempool", pool.m_opts.max_size_bytes);
     ret.pushKV("mempoolminfee", ValueFromAmount(std::max(pool.GetMinFee(), pool.m_opts.min_relay_feerate).GetFeePerK()));
@@ -1066,6 +1176,15 @@ UniValue MempoolInfoToJSON(const CTxMemPool& pool)
     ret.pushKV("limitclustercount", pool.m_opts.limits.cluster_count);
     ret.pushKV("limitclustersize", pool.m_opts.limits.cluster_size_vbytes);
     ret.pushKV("optimal", pool.m_txgraph->DoWork(0)); // 0 work is a quick check for known optimality
+    ret.pushKV("nonoptimalclusters", pool.m_txgraph->GetMainNonOptimalClusterCount());
+    if (pool.HasBackgroundLinearization()) {
+        const auto stats{pool.GetBackgroundLinearizationStats()};
+        UniValue background(UniValue::VOBJ);
+        background.pushKV("jobs", stats.jobs);
+        background.pushKV("discarded", stats.discarded);
+        background.pushKV("duration", stats.duration.count());
+        ret.pushKV("backgroundlinearization", std::move(background));
+    }
     if (IsDeprecatedRPCEnabled("fullrbf")) {
         ret.pushKV("fullrbf", true);
     }
@@ -1085,6 +1204,7 @@ static RPCMethod getmempoolinfo()
                     {RPCResult::Type::NUM, "size", "Current tx count"},
                     {RPCResult::Type::NUM, "bytes", "Sum of all virtual transaction sizes as defined in BIP 141. Differs from actual serialized size because witness data is discounted"},
                     {RPCResult::Type::NUM, "usage", "Total memory usage for the mempool"},
+                    {RPCResult::Type::NUM, "allocated", "Total memory allocated for the mempool. Like usage, but counting the whole memory arena that mempool entries are allocated from, which does not shrink when transactions are removed"},
                     {RPCResult::Type::STR_AMOUNT, "total_fee", "Total fees for the mempool in " + CURRENCY_UNIT + ", ignoring modified fees through prioritisetransaction"},
                     {RPCResult::Type::NUM, "maxmempool", "Maximum memory usage for the mempool"},
                     {RPCResult::Type::STR_AMOUNT, "mempoolminfee", "Minimum fee rate in " + CURRENCY_UNIT + "/kvB for tx to be accepted. Is the maximum of minrelaytxfee and minimum mempool fee"},
@@ -1096,6 +1216,13 @@ static RPCMethod getmempoolinfo()
                     {RPCResult::Type::NUM, "limitclustercount", "Maximum number of transactions that can be in a cluster (configured by -limitclustercount)"},
                     {RPCResult::Type::NUM, "limitclustersize", "Maximum size of a cluster in virtual bytes (configured by -limitclustersize)"},
                     {RPCResult::Type::BOOL, "optimal", "If the mempool is in a known-optimal transaction ordering"},
+                    {RPCResult::Type::NUM, "nonoptimalclusters", "Number of clusters whose transaction ordering is not known to be optimal"},
+                    {RPCResult::Type::OBJ, "backgroundlinearization", /*optional=*/true, "Only present if -mempoolbackgroundlinearization is enabled",
+                    {
+                        {RPCResult::Type::NUM, "jobs", "Number of clusters the background thread has worked on"},
+                        {RPCResult::Type::NUM, "discarded", "Number of results discarded because the cluster changed in the meantime"},
+                        {RPCResult::Type::NUM, "duration", "Total time spent on the background thread, in microseconds"},
+                    }},
                 };
                 if (IsDeprecatedRPCEnabled("fullrbf")) {
                     list.emplace_back(RPCResult::Type::BOOL, "fullrbf", "True if the mempool accepts RBF without replaceability signaling inspection (DEPRECATED)");
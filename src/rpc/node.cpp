@@ -9,6 +9,7 @@
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scriptindex.h>
 #include <index/txindex.h>
 #include <index/txospenderindex.h>
 #include <interfaces/chain.h>
@@ -17,6 +18,7 @@
 #include <interfaces/ipc.h>
 #include <kernel/cs_main.h>
 #include <logging.h>
+#include <node/blockstorage.h>
 #include <node/context.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
@@ -27,6 +29,7 @@
 #include <util/any.h>
 #include <util/check.h>
 #include <util/time.h>
+#include <validation.h>
 
 #include <cstdint>
 #ifdef HAVE_MALLOC_INFO
@@ -167,6 +170,16 @@ static RPCMethod getmemoryinfo()
                                 {RPCResult::Type::NUM, "chunks_used", "Number allocated chunks"},
                                 {RPCResult::Type::NUM, "chunks_free", "Number unused chunks"},
                             }},
+                            {RPCResult::Type::OBJ, "blockcache", /*optional=*/true, "Information about the cache of recently read blocks (only present if -blockcachesize is set)",
+                            {
+                                {RPCResult::Type::NUM, "usage", "Number of bytes used"},
+                                {RPCResult::Type::NUM, "max_usage", "Maximum number of bytes"},
+                                {RPCResult::Type::NUM, "entries", "Number of cached blocks"},
+                                {RPCResult::Type::NUM, "hits", "Number of deserialized block reads served from the cache"},
+                                {RPCResult::Type::NUM, "misses", "Number of deserialized block reads that went to disk"},
+                                {RPCResult::Type::NUM, "raw_hits", "Number of serialized block reads served from the cache"},
+                                {RPCResult::Type::NUM, "raw_misses", "Number of serialized block reads that went to disk"},
+                            }},
                         }
                     },
                     RPCResult{"mode \"mallocinfo\"",
@@ -183,6 +196,20 @@ static RPCMethod getmemoryinfo()
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        const NodeContext& node{EnsureAnyNodeContext(request.context)};
+        if (node.chainman) {
+            if (const auto stats{node.chainman->m_blockman.GetBlockCacheStats()}) {
+                UniValue cache(UniValue::VOBJ);
+                cache.pushKV("usage", stats->usage);
+                cache.pushKV("max_usage", stats->max_usage);
+                cache.pushKV("entries", stats->entries);
+                cache.pushKV("hits", stats->hits);
+                cache.pushKV("misses", stats->misses);
+                cache.pushKV("raw_hits", stats->raw_hits);
+                cache.pushKV("raw_misses", stats->raw_misses);
+                obj.pushKV("blockcache", std::move(cache));
+            }
+        }
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -402,6 +429,10 @@ static RPCMethod getindexinfo()
         result.pushKVs(SummaryToJSON(g_txospenderindex->GetSummary(), index_name));
     }
 
+    if (g_scriptindex) {
+        result.pushKVs(SummaryToJSON(g_scriptindex->GetSummary(), index_name));
+    }
+
     ForEachBlockFilterIndex([&result, &index_name](const BlockFilterIndex& index) {
         result.pushKVs(SummaryToJSON(index.GetSummary(), index_name));
     });
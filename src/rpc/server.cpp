@@ -66,6 +66,38 @@ struct RPCCommandExecution
     }
 };
 
+void RPCMethodCounters::EndCall(std::chrono::microseconds latency, bool error)
+{
+    const int64_t us{std::max<int64_t>(latency.count(), 0)};
+    const size_t bucket(std::ranges::lower_bound(RPC_LATENCY_BUCKETS_US, us) - RPC_LATENCY_BUCKETS_US.begin());
+    m_calls.fetch_add(1, std::memory_order_relaxed);
+    if (error) m_errors.fetch_add(1, std::memory_order_relaxed);
+    m_latency_sum_us.fetch_add(static_cast<uint64_t>(us), std::memory_order_relaxed);
+    m_latency_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    m_in_flight.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void RPCMethodCounters::AddTraffic(uint64_t bytes_in, uint64_t bytes_out)
+{
+    m_bytes_in.fetch_add(bytes_in, std::memory_order_relaxed);
+    m_bytes_out.fetch_add(bytes_out, std::memory_order_relaxed);
+}
+
+RPCMethodStats RPCMethodCounters::Snapshot() const
+{
+    RPCMethodStats stats;
+    stats.calls = m_calls.load(std::memory_order_relaxed);
+    stats.errors = m_errors.load(std::memory_order_relaxed);
+    stats.in_flight = m_in_flight.load(std::memory_order_relaxed);
+    stats.bytes_in = m_bytes_in.load(std::memory_order_relaxed);
+    stats.bytes_out = m_bytes_out.load(std::memory_order_relaxed);
+    stats.latency_sum_us = m_latency_sum_us.load(std::memory_order_relaxed);
+    for (size_t i{0}; i < m_latency_buckets.size(); ++i) {
+        stats.latency_buckets[i] = m_latency_buckets[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
 std::string CRPCTable::help(std::string_view strCommand, const JSONRPCRequest& helpreq) const
 {
     std::string strRet;
@@ -235,9 +267,77 @@ static RPCMethod getrpcinfo()
     };
 }
 
+static RPCMethod getrpcstats()
+{
+    return RPCMethod{
+        "getrpcstats",
+        "Returns call counts, latency histograms and traffic of the RPC methods called since startup.\n"
+        "Counters are updated without locking, so a snapshot taken while calls are executing may be off by a few calls.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::ARR, "latency_buckets", "Upper bounds of the latency histogram buckets, in microseconds",
+                        {
+                            {RPCResult::Type::NUM, "", "Upper bound"},
+                        }},
+                        {RPCResult::Type::OBJ_DYN, "methods", "Methods that were called at least once",
+                        {
+                            {RPCResult::Type::OBJ, "method", "The name of the RPC method",
+                            {
+                                {RPCResult::Type::NUM, "calls", "Number of completed calls"},
+                                {RPCResult::Type::NUM, "errors", "Number of completed calls that returned an error"},
+                                {RPCResult::Type::NUM, "in_flight", "Number of calls currently executing"},
+                                {RPCResult::Type::NUM, "bytes_in", "Total size of the requests, in bytes. Calls in batch requests are not included"},
+                                {RPCResult::Type::NUM, "bytes_out", "Total size of the replies, in bytes. Calls in batch requests are not included"},
+                                {RPCResult::Type::NUM, "latency_sum", "Total time spent executing the completed calls, in microseconds"},
+                                {RPCResult::Type::ARR, "latency_histogram", "Number of completed calls per latency bucket, followed by the number of calls slower than the last bucket",
+                                {
+                                    {RPCResult::Type::NUM, "", "Number of calls"},
+                                }},
+                            }},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getrpcstats", "")
+                + HelpExampleRpc("getrpcstats", "")},
+        [](const RPCMethod& self, const JSONRPCRequest& request) -> UniValue
+{
+    UniValue buckets(UniValue::VARR);
+    for (const int64_t bound : RPC_LATENCY_BUCKETS_US) {
+        buckets.push_back(bound);
+    }
+
+    UniValue methods(UniValue::VOBJ);
+    for (const auto& [method, stats] : tableRPC.GetMethodStats()) {
+        UniValue histogram(UniValue::VARR);
+        for (const uint64_t count : stats.latency_buckets) {
+            histogram.push_back(count);
+        }
+        UniValue entry(UniValue::VOBJ);
+        entry.pushKV("calls", stats.calls);
+        entry.pushKV("errors", stats.errors);
+        entry.pushKV("in_flight", stats.in_flight);
+        entry.pushKV("bytes_in", stats.bytes_in);
+        entry.pushKV("bytes_out", stats.bytes_out);
+        entry.pushKV("latency_sum", stats.latency_sum_us);
+        entry.pushKV("latency_histogram", std::move(histogram));
+        methods.pushKV(method, std::move(entry));
+    }
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("latency_buckets", std::move(buckets));
+    result.pushKV("methods", std::move(methods));
+    return result;
+}
+    };
+}
+
 static const CRPCCommand vRPCCommands[]{
     /* Overall control/query calls */
     {"control", &getrpcinfo},
+    {"control", &getrpcstats},
     {"control", &help},
     {"control", &stop},
     {"control", &uptime},
@@ -255,6 +355,7 @@ void CRPCTable::appendCommand(const std::string& name, const CRPCCommand* pcmd)
     CHECK_NONFATAL(!IsRPCRunning()); // Only add commands before rpc is running
 
     mapCommands[name].push_back(pcmd);
+    m_method_counters.try_emplace(name);
 }
 
 bool CRPCTable::removeCommand(const std::string& name, const CRPCCommand* pcmd)
@@ -270,6 +371,22 @@ bool CRPCTable::removeCommand(const std::string& name, const CRPCCommand* pcmd)
     return false;
 }
 
+void CRPCTable::RecordTraffic(std::string_view method, uint64_t bytes_in, uint64_t bytes_out)
+{
+    const auto it{m_method_counters.find(method)};
+    if (it != m_method_counters.end()) it->second.AddTraffic(bytes_in, bytes_out);
+}
+
+std::map<std::string, RPCMethodStats> CRPCTable::GetMethodStats() const
+{
+    std::map<std::string, RPCMethodStats> ret;
+    for (const auto& [method, counters] : m_method_counters) {
+        RPCMethodStats stats{counters.Snapshot()};
+        if (stats.calls > 0 || stats.in_flight > 0) ret.emplace(method, stats);
+    }
+    return ret;
+}
+
 void StartRPC()
 {
     LogDebug(BCLog::RPC, "Starting RPC\n");
@@ -491,8 +608,20 @@ UniValue CRPCTable::execute(const JSONRPCRequest &request) const
     // Find method
     auto it = mapCommands.find(request.strMethod);
     if (it != mapCommands.end()) {
+        // Every method in mapCommands has counters, see appendCommand()
+        RPCMethodCounters& counters{m_method_counters.find(request.strMethod)->second};
+        counters.BeginCall();
+        const auto start{SteadyClock::now()};
         UniValue result;
-        if (ExecuteCommands(it->second, request, result)) {
+        bool handled;
+        try {
+            handled = ExecuteCommands(it->second, request, result);
+        } catch (...) {
+            counters.EndCall(std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - start), /*error=*/true);
+            throw;
+        }
+        counters.EndCall(std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - start), /*error=*/!handled);
+        if (handled) {
             return result;
         }
     }
@@ -9,10 +9,14 @@
 #include <rpc/request.h>
 #include <rpc/util.h>
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <map>
 #include <string>
+#include <string_view>
 
 #include <univalue.h>
 
@@ -80,6 +84,50 @@ public:
     intptr_t unique_id;
 };
 
+/** Upper bounds of the buckets of the RPC latency histograms, in microseconds. */
+inline constexpr std::array<int64_t, 16> RPC_LATENCY_BUCKETS_US{
+    100, 250, 500, 1'000, 2'500, 5'000, 10'000, 25'000, 50'000,
+    100'000, 250'000, 500'000, 1'000'000, 2'500'000, 5'000'000, 10'000'000};
+
+/** Statistics of the calls to one RPC method since startup. */
+struct RPCMethodStats
+{
+    uint64_t calls{0};
+    //! Calls that threw an error
+    uint64_t errors{0};
+    //! Calls currently executing
+    uint64_t in_flight{0};
+    //! Sizes of the requests and replies of calls that were not part of a batch
+    uint64_t bytes_in{0};
+    uint64_t bytes_out{0};
+    //! Sum of the latencies of all calls, in microseconds
+    uint64_t latency_sum_us{0};
+    //! Calls per bucket of RPC_LATENCY_BUCKETS_US, followed by those slower than the last bucket
+    std::array<uint64_t, RPC_LATENCY_BUCKETS_US.size() + 1> latency_buckets{};
+};
+
+/**
+ * Lock-free counters behind RPCMethodStats. Updated with relaxed atomics from
+ * every RPC thread, so a snapshot may be mid-update by a call or two.
+ */
+class RPCMethodCounters
+{
+public:
+    void BeginCall() { m_in_flight.fetch_add(1, std::memory_order_relaxed); }
+    void EndCall(std::chrono::microseconds latency, bool error);
+    void AddTraffic(uint64_t bytes_in, uint64_t bytes_out);
+    RPCMethodStats Snapshot() const;
+
+private:
+    std::atomic<uint64_t> m_calls{0};
+    std::atomic<uint64_t> m_errors{0};
+    std::atomic<uint64_t> m_in_flight{0};
+    std::atomic<uint64_t> m_bytes_in{0};
+    std::atomic<uint64_t> m_bytes_out{0};
+    std::atomic<uint64_t> m_latency_sum_us{0};
+    std::array<std::atomic<uint64_t>, RPC_LATENCY_BUCKETS_US.size() + 1> m_latency_buckets{};
+};
+
 /**
  * RPC command dispatcher.
  */
@@ -87,6 +135,9 @@ class CRPCTable
 {
 private:
     std::map<std::string, std::vector<const CRPCCommand*>> mapCommands;
+    //! Statistics per method name. Like mapCommands, only modified before the
+    //! RPC server is running, so it can be read without locking.
+    mutable std::map<std::string, RPCMethodCounters, std::less<>> m_method_counters;
 public:
     CRPCTable();
     std::string help(std::string_view name, const JSONRPCRequest& helpreq) const;
@@ -124,6 +175,12 @@ public:
      */
     void appendCommand(const std::string& name, const CRPCCommand* pcmd);
     bool removeCommand(const std::string& name, const CRPCCommand* pcmd);
+
+    /** Account the size of the request and reply of a call to method. Unknown methods are ignored. */
+    void RecordTraffic(std::string_view method, uint64_t bytes_in, uint64_t bytes_out);
+
+    /** Statistics of every method that has been called, by method name. */
+    std::map<std::string, RPCMethodStats> GetMethodStats() const;
 };
 
 bool IsDeprecatedRPCEnabled(const std::string& method);
@@ -5,6 +5,7 @@
 #include <chain.h>
 #include <common/args.h>
 #include <common/messages.h>
+#include <common/system.h>
 #include <common/types.h>
 #include <consensus/amount.h>
 #include <core_io.h>
@@ -24,9 +25,11 @@
 #include <util/result.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 
 #include <algorithm>
+#include <future>
 #include <iterator>
 #include <string_view>
 #include <tuple>
@@ -1336,6 +1339,38 @@ std::pair<int64_t, int64_t> ParseDescriptorRange(const UniValue& value)
     return {low, high};
 }
 
+//! Fewest descriptor indexes worth handing to a thread of their own
+static constexpr int64_t MIN_EXPAND_INDEXES_PER_THREAD{250};
+
+namespace {
+/** Scripts and keys of a run of consecutive descriptor indexes */
+struct ExpandedRange {
+    std::vector<CScript> scripts;
+    FlatSigningProvider out;
+    //! False if an index could not be expanded
+    bool success{true};
+};
+} // namespace
+
+static ExpandedRange ExpandRange(const std::vector<std::unique_ptr<Descriptor>>& descs, const SigningProvider& provider, int64_t begin, int64_t end, bool expand_priv)
+{
+    ExpandedRange ret;
+    for (int64_t i = begin; i < end; ++i) {
+        for (const auto& desc : descs) {
+            std::vector<CScript> scripts;
+            if (!desc->Expand(i, provider, scripts, ret.out)) {
+                ret.success = false;
+                return ret;
+            }
+            if (expand_priv) {
+                desc->ExpandPrivate(/*pos=*/i, provider, /*out=*/ret.out);
+            }
+            std::move(scripts.begin(), scripts.end(), std::back_inserter(ret.scripts));
+        }
+    }
+    return ret;
+}
+
 std::vector<CScript> EvalDescriptorStringOrObject(const UniValue& scanobject, FlatSigningProvider& provider, const bool expand_priv)
 {
     std::string desc_str;
@@ -1363,18 +1398,44 @@ std::vector<CScript> EvalDescriptorStringOrObject(const UniValue& scanobject, Fl
         range.first = 0;
         range.second = 0;
     }
-    std::vector<CScript> ret;
-    for (int i = range.first; i <= range.second; ++i) {
-        for (const auto& desc : descs) {
-            std::vector<CScript> scripts;
-            if (!desc->Expand(i, provider, scripts, provider)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, strprintf("Cannot derive script without private keys: '%s'", desc_str));
-            }
-            if (expand_priv) {
-                desc->ExpandPrivate(/*pos=*/i, provider, /*out=*/provider);
+
+    // Expand the first index on its own, as it may initialize state shared by the descriptors'
+    // key expressions. Split the rest into runs of consecutive indexes expanded on several
+    // threads, and collect their results in index order.
+    const int64_t rest{range.second - range.first};
+    const int threads{int(std::clamp<int64_t>(rest / MIN_EXPAND_INDEXES_PER_THREAD, 1, GetNumCores()))};
+    std::vector<ExpandedRange> runs(threads + 1);
+    runs[0] = ExpandRange(descs, provider, range.first, range.first + 1, expand_priv);
+    const auto expand_run{[&](int t) {
+        const int64_t begin{range.first + 1 + rest * t / threads};
+        const int64_t end{range.first + 1 + rest * (t + 1) / threads};
+        runs[t + 1] = ExpandRange(descs, provider, begin, end, expand_priv);
+    }};
+    if (runs[0].success && threads > 1) {
+        ThreadPool pool{"descexpand"};
+        pool.Start(threads - 1);
+        std::vector<std::future<void>> futures;
+        for (int t = 1; t < threads; ++t) {
+            auto future{pool.Submit([&expand_run, t] { expand_run(t); })};
+            if (future) {
+                futures.push_back(std::move(*future));
+            } else {
+                expand_run(t);
             }
-            std::move(scripts.begin(), scripts.end(), std::back_inserter(ret));
         }
+        expand_run(0);
+        for (auto& future : futures) future.get();
+    } else if (runs[0].success) {
+        expand_run(0);
+    }
+
+    std::vector<CScript> ret;
+    for (ExpandedRange& run : runs) {
+        if (!run.success) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, strprintf("Cannot derive script without private keys: '%s'", desc_str));
+        }
+        std::move(run.scripts.begin(), run.scripts.end(), std::back_inserter(ret));
+        provider.Merge(std::move(run.out));
     }
     return ret;
 }
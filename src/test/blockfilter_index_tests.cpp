@@ -15,6 +15,7 @@
 #include <test/util/common.h>
 #include <test/util/setup_common.h>
 #include <util/byte_units.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
@@ -271,6 +272,33 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_initial_sync, BuildChainTestingSetup)
     filter_index.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_parallel_sync, BuildChainTestingSetup)
+{
+    ThreadPool thread_pool{"index"};
+    thread_pool.Start(/*num_workers=*/3);
+
+    BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1_MiB, true);
+    filter_index.SetThreadPool(thread_pool);
+    BOOST_REQUIRE(filter_index.Init());
+
+    filter_index.Sync();
+
+    // Filters are computed on the workers but committed in height order, so
+    // the filter header chain is the same as with a sequential sync.
+    {
+        LOCK(cs_main);
+        uint256 last_header;
+        for (const CBlockIndex* block_index = m_node.chainman->ActiveChain().Genesis();
+             block_index != nullptr;
+             block_index = m_node.chainman->ActiveChain().Next(*block_index)) {
+            CheckFilterLookups(filter_index, block_index, last_header, m_node.chainman->m_blockman);
+        }
+    }
+
+    filter_index.Stop();
+    thread_pool.Stop();
+}
+
 BOOST_FIXTURE_TEST_CASE(blockfilter_index_init_destroy, BasicTestingSetup)
 {
     BlockFilterIndex* filter_index;
@@ -5,12 +5,15 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <clientversion.h>
+#include <node/blockcache.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
 #include <script/solver.h>
+#include <undo.h>
 #include <primitives/block.h>
 #include <util/chaintype.h>
+#include <util/strencodings.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
@@ -231,6 +234,47 @@ BOOST_FIXTURE_TEST_CASE(blockmanager_readblock_hash_mismatch, TestingSetup)
     BOOST_CHECK(!m_node.chainman->m_blockman.ReadBlock(block, index));
 }
 
+BOOST_FIXTURE_TEST_CASE(blockmanager_read_block_undos, TestChain100Setup)
+{
+    auto& blockman{m_node.chainman->m_blockman};
+    std::vector<const CBlockIndex*> blocks;
+    {
+        LOCK(::cs_main);
+        const CChain& chain{m_node.chainman->ActiveChain()};
+        // Out of height order, to check the results are returned in request order
+        for (int height{chain.Height()}; height >= 0; --height) blocks.push_back(chain[height]);
+    }
+
+    std::vector<CBlockUndo> block_undos;
+    BOOST_REQUIRE(blockman.ReadBlockUndos(blocks, block_undos));
+    BOOST_REQUIRE_EQUAL(block_undos.size(), blocks.size());
+    for (size_t i{0}; i < blocks.size(); ++i) {
+        CBlockUndo expected;
+        if (blocks[i]->nHeight > 0) BOOST_REQUIRE(blockman.ReadBlockUndo(expected, *blocks[i]));
+        DataStream ss_expected, ss_actual;
+        ss_expected << expected;
+        ss_actual << block_undos[i];
+        BOOST_CHECK_EQUAL(HexStr(ss_expected), HexStr(ss_actual));
+    }
+
+    // A block with the wrong parent fails checksum verification
+    CBlockIndex wrong_parent;
+    {
+        LOCK(::cs_main);
+        const CChain& chain{m_node.chainman->ActiveChain()};
+        const CBlockIndex* tip{chain.Tip()};
+        wrong_parent.nHeight = tip->nHeight;
+        wrong_parent.nStatus = tip->nStatus;
+        wrong_parent.nFile = tip->nFile;
+        wrong_parent.nUndoPos = tip->nUndoPos;
+        wrong_parent.phashBlock = tip->phashBlock;
+        wrong_parent.pprev = chain.Genesis();
+    }
+    const std::vector<const CBlockIndex*> bad_blocks{blocks[1], &wrong_parent};
+    ASSERT_DEBUG_LOG("Checksum mismatch");
+    BOOST_CHECK(!blockman.ReadBlockUndos(bad_blocks, block_undos));
+}
+
 BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
 {
     KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
@@ -300,6 +344,85 @@ BOOST_AUTO_TEST_CASE(blockmanager_flush_block_file)
     BOOST_CHECK_EQUAL(read_block.nVersion, 2);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_write_queue)
+{
+    KernelNotifications notifications{Assert(m_node.shutdown_request), m_node.exit_status, *Assert(m_node.warnings)};
+    node::BlockManager::Options blockman_opts{
+        .chainparams = Params(),
+        // Small enough that every write has to wait for the previous one
+        .write_queue_bytes = 100,
+        .blocks_dir = m_args.GetBlocksDirPath(),
+        .notifications = notifications,
+        .block_tree_db_params = DBParams{
+            .path = m_args.GetDataDirNet() / "blocks" / "index",
+            .cache_bytes = 0,
+        },
+    };
+    BlockManager blockman{*Assert(m_node.shutdown_signal), blockman_opts};
+
+    std::vector<FlatFilePos> positions;
+    for (int i{1}; i <= 10; ++i) {
+        CBlock block;
+        block.nVersion = i;
+        positions.push_back(blockman.WriteBlock(block, /*nHeight=*/i));
+        BOOST_CHECK_EQUAL(positions.back().nPos, (81 + STORAGE_HEADER_BYTES) * (i - 1) + STORAGE_HEADER_BYTES);
+    }
+
+    // Reads wait for the queued writes to the same file
+    for (int i{1}; i <= 10; ++i) {
+        CBlock read_block;
+        ASSERT_DEBUG_LOG("Errors in block header");
+        BOOST_CHECK(!blockman.ReadBlock(read_block, positions[i - 1], {}));
+        BOOST_CHECK_EQUAL(read_block.nVersion, i);
+    }
+
+    const auto stats{blockman.GetWriteQueueStats()};
+    BOOST_REQUIRE(stats);
+    BOOST_CHECK_EQUAL(stats->writes, 10U);
+    BOOST_CHECK_EQUAL(stats->pending_jobs, 0U);
+    BOOST_CHECK_EQUAL(stats->pending_bytes, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_block_cache)
+{
+    CBlock block;
+    block.nVersion = 1;
+    const auto shared_block{std::make_shared<const CBlock>(block)};
+    const uint256 hash1{1}, hash2{2}, hash3{3};
+
+    node::BlockCache probe{std::numeric_limits<size_t>::max()};
+    probe.PutBlock(hash1, shared_block);
+    const size_t entry_usage{probe.GetStats().usage};
+    BOOST_CHECK_GT(entry_usage, 0U);
+
+    // Room for exactly two entries
+    node::BlockCache cache{2 * entry_usage};
+    cache.PutBlock(hash1, shared_block);
+    cache.PutBlock(hash2, shared_block);
+    BOOST_CHECK_EQUAL(cache.GetStats().entries, 2U);
+
+    // Make hash1 the most recently used entry, so hash2 is evicted next
+    BOOST_CHECK(cache.GetBlock(hash1) == shared_block);
+    cache.PutBlock(hash3, shared_block);
+    BOOST_CHECK(cache.GetBlock(hash2) == nullptr);
+    BOOST_CHECK(cache.GetBlock(hash1) == shared_block);
+    BOOST_CHECK(cache.GetBlock(hash3) == shared_block);
+
+    // Only the deserialized block is cached
+    BOOST_CHECK(cache.GetRawBlock(hash3) == nullptr);
+
+    cache.Erase(hash3);
+    BOOST_CHECK(cache.GetBlock(hash3) == nullptr);
+
+    const auto stats{cache.GetStats()};
+    BOOST_CHECK_EQUAL(stats.entries, 1U);
+    BOOST_CHECK_EQUAL(stats.usage, entry_usage);
+    BOOST_CHECK_EQUAL(stats.hits, 3U);
+    BOOST_CHECK_EQUAL(stats.misses, 2U);
+    BOOST_CHECK_EQUAL(stats.raw_hits, 0U);
+    BOOST_CHECK_EQUAL(stats.raw_misses, 1U);
+}
+
 BOOST_FIXTURE_TEST_CASE(prune_lock_update_and_delete, TestingSetup)
 {
     LOCK(::cs_main);
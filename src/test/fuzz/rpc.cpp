@@ -155,6 +155,8 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getrawmempool",
     "getrawtransaction",
     "getrpcinfo",
+    "getrpcstats",
+    "getscripthistory",
     "gettxout",
     "gettxoutsetinfo",
     "gettxspendingprevout",
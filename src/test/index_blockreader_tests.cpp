@@ -0,0 +1,157 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockfilter.h>
+#include <chain.h>
+#include <index/blockfilterindex.h>
+#include <index/blockreader.h>
+#include <index/txindex.h>
+#include <interfaces/chain.h>
+#include <primitives/block.h>
+#include <test/util/common.h>
+#include <test/util/setup_common.h>
+#include <undo.h>
+#include <util/threadinterrupt.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(index_blockreader_tests)
+
+BOOST_FIXTURE_TEST_CASE(index_blockreader_shared_reads, TestChain100Setup)
+{
+    const CBlockIndex* block1;
+    const CBlockIndex* block2;
+    {
+        LOCK(::cs_main);
+        block1 = m_node.chainman->ActiveChain()[1];
+        block2 = m_node.chainman->ActiveChain()[2];
+    }
+
+    // A one byte buffer is full as soon as any block is buffered
+    IndexBlockReader reader{m_node.chainman->m_blockman, /*max_usage=*/1};
+    std::optional<IndexBlockReader::Consumer> fast{std::in_place, reader, /*need_undo=*/false, /*height=*/0};
+    IndexBlockReader::Consumer slow{reader, /*need_undo=*/true, /*height=*/0};
+
+    // The first read hits the disk and keeps the data, including the undo data
+    // needed by the other consumer.
+    const auto fast_data{fast->Read(*block1, /*need_undo=*/false)};
+    BOOST_REQUIRE(fast_data.block);
+    BOOST_CHECK_EQUAL(fast_data.block->GetHash(), block1->GetBlockHash());
+    auto stats{reader.GetStats()};
+    BOOST_CHECK_EQUAL(stats.disk_reads, 1U);
+    BOOST_CHECK_EQUAL(stats.entries, 1U);
+    BOOST_CHECK_EQUAL(stats.consumers, 2U);
+    BOOST_CHECK_GT(stats.usage, 0U);
+
+    // The consumer ahead waits for the buffer to drain, the one behind does not
+    fast->SetHeight(1);
+    CThreadInterrupt interrupt;
+    interrupt();
+    BOOST_CHECK(!fast->WaitForCapacity(interrupt));
+    interrupt.reset();
+    BOOST_CHECK(slow.WaitForCapacity(interrupt));
+
+    const auto slow_data{slow.Read(*block1, /*need_undo=*/true)};
+    BOOST_CHECK_EQUAL(slow_data.block, fast_data.block);
+    BOOST_REQUIRE(slow_data.undo);
+    BOOST_CHECK_EQUAL(slow_data.undo->vtxundo.size(), slow_data.block->vtx.size() - 1);
+    stats = reader.GetStats();
+    BOOST_CHECK_EQUAL(stats.disk_reads, 1U);
+    BOOST_CHECK_EQUAL(stats.shared_reads, 1U);
+
+    // Data is dropped once every consumer has processed it
+    slow.SetHeight(1);
+    stats = reader.GetStats();
+    BOOST_CHECK_EQUAL(stats.entries, 0U);
+    BOOST_CHECK_EQUAL(stats.usage, 0U);
+    BOOST_CHECK(fast->WaitForCapacity(interrupt));
+
+    // Without other consumers behind, reads are not buffered
+    fast.reset();
+    BOOST_CHECK_EQUAL(reader.GetStats().consumers, 1U);
+    BOOST_CHECK(slow.Read(*block2, /*need_undo=*/true).undo);
+    BOOST_CHECK_EQUAL(reader.GetStats().entries, 0U);
+}
+
+BOOST_FIXTURE_TEST_CASE(index_blockreader_distant_consumers, TestChain100Setup)
+{
+    const CBlockIndex* block1;
+    const CBlockIndex* block51;
+    {
+        LOCK(::cs_main);
+        block1 = m_node.chainman->ActiveChain()[1];
+        block51 = m_node.chainman->ActiveChain()[51];
+    }
+
+    // Two indexes syncing from genesis together, and one far ahead of them
+    IndexBlockReader reader{m_node.chainman->m_blockman, /*max_usage=*/1, /*max_gap=*/10};
+    IndexBlockReader::Consumer first{reader, /*need_undo=*/false, /*height=*/0};
+    IndexBlockReader::Consumer second{reader, /*need_undo=*/false, /*height=*/0};
+    IndexBlockReader::Consumer leader{reader, /*need_undo=*/false, /*height=*/50};
+
+    // The trailing indexes share their reads, filling the buffer
+    BOOST_REQUIRE(first.Read(*block1, /*need_undo=*/false).block);
+    first.SetHeight(1);
+    auto stats{reader.GetStats()};
+    BOOST_CHECK_EQUAL(stats.entries, 1U);
+    BOOST_CHECK_GT(stats.usage, 0U);
+    CThreadInterrupt interrupt;
+    interrupt();
+    BOOST_CHECK(!first.WaitForCapacity(interrupt));
+    interrupt.reset();
+
+    // The leader is not throttled by them, and reads without buffering
+    BOOST_CHECK(leader.WaitForCapacity(interrupt));
+    BOOST_REQUIRE(leader.Read(*block51, /*need_undo=*/false).block);
+    leader.SetHeight(51);
+    BOOST_CHECK(leader.WaitForCapacity(interrupt));
+    stats = reader.GetStats();
+    BOOST_CHECK_EQUAL(stats.entries, 1U);
+    BOOST_CHECK_EQUAL(stats.disk_reads, 2U);
+
+    BOOST_CHECK(second.Read(*block1, /*need_undo=*/false).block);
+    second.SetHeight(1);
+    stats = reader.GetStats();
+    BOOST_CHECK_EQUAL(stats.shared_reads, 1U);
+    BOOST_CHECK_EQUAL(stats.entries, 0U);
+}
+
+BOOST_FIXTURE_TEST_CASE(index_blockreader_concurrent_sync, TestChain100Setup)
+{
+    IndexBlockReader reader{m_node.chainman->m_blockman, /*max_usage=*/16 << 10};
+
+    TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, true);
+    BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true);
+    txindex.SetBlockReader(reader);
+    filter_index.SetBlockReader(reader);
+    BOOST_REQUIRE(txindex.Init());
+    BOOST_REQUIRE(filter_index.Init());
+    BOOST_REQUIRE(txindex.StartBackgroundSync());
+    BOOST_REQUIRE(filter_index.StartBackgroundSync());
+
+    while (!txindex.BlockUntilSyncedToCurrentChain() || !filter_index.BlockUntilSyncedToCurrentChain()) {
+        UninterruptibleSleep(10ms);
+    }
+
+    CTransactionRef tx;
+    uint256 block_hash;
+    for (const auto& coinbase : m_coinbase_txns) {
+        BOOST_CHECK(txindex.FindTx(coinbase->GetHash(), block_hash, tx));
+    }
+    {
+        LOCK(::cs_main);
+        BlockFilter filter;
+        BOOST_CHECK(filter_index.LookupFilter(m_node.chainman->ActiveTip(), filter));
+    }
+
+    txindex.Stop();
+    filter_index.Stop();
+    const auto stats{reader.GetStats()};
+    BOOST_CHECK_EQUAL(stats.consumers, 0U);
+    BOOST_CHECK_EQUAL(stats.entries, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
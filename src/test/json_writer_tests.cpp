@@ -0,0 +1,117 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <common/json_writer.h>
+#include <core_io.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <undo.h>
+#include <univalue.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(json_writer_tests, BasicTestingSetup)
+
+static std::string StreamValue(const UniValue& value, size_t flush_threshold, size_t* chunks = nullptr)
+{
+    std::string out;
+    JsonWriter writer{[&](std::string_view chunk) {
+        out += chunk;
+        if (chunks) ++*chunks;
+    }, flush_threshold};
+    writer.Value(value);
+    writer.Flush();
+    BOOST_CHECK_EQUAL(writer.BytesWritten(), out.size());
+    return out;
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_matches_univalue)
+{
+    UniValue inner{UniValue::VOBJ};
+    inner.pushKV("escaped \"key\"", std::string{"line\nbreak\t\\ \x01 \x7f"});
+    inner.pushKV("empty_obj", UniValue{UniValue::VOBJ});
+    inner.pushKV("empty_arr", UniValue{UniValue::VARR});
+    inner.pushKV("null", NullUniValue);
+
+    UniValue arr{UniValue::VARR};
+    arr.push_back(-42);
+    arr.push_back(true);
+    arr.push_back(false);
+    arr.push_back(ValueFromAmount(1234567));
+    arr.push_back(inner);
+    arr.push_back(std::string{});
+
+    UniValue doc{UniValue::VOBJ};
+    doc.pushKV("arr", arr);
+    doc.pushKV("obj", inner);
+    doc.pushKV("num", 7);
+
+    for (const UniValue& value : {doc, arr, inner, UniValue{"str"}, UniValue{1}, NullUniValue}) {
+        BOOST_CHECK_EQUAL(StreamValue(value, JsonWriter::DEFAULT_FLUSH_THRESHOLD), value.write());
+        BOOST_CHECK_EQUAL(StreamValue(value, 1), value.write());
+    }
+
+    // Small thresholds produce many chunks, large ones a single chunk.
+    size_t chunks{0};
+    StreamValue(doc, 1, &chunks);
+    BOOST_CHECK_GT(chunks, 10U);
+    chunks = 0;
+    StreamValue(doc, JsonWriter::DEFAULT_FLUSH_THRESHOLD, &chunks);
+    BOOST_CHECK_EQUAL(chunks, 1U);
+}
+
+BOOST_AUTO_TEST_CASE(json_writer_members)
+{
+    UniValue obj{UniValue::VOBJ};
+    obj.pushKV("a", 1);
+    obj.pushKV("b", "x");
+
+    std::string out;
+    JsonWriter writer{[&](std::string_view chunk) { out += chunk; }};
+    writer.BeginObject();
+    writer.Members(obj);
+    writer.Key("c");
+    writer.BeginArray();
+    writer.String("y");
+    writer.Value(UniValue{UniValue::VOBJ});
+    writer.EndArray();
+    writer.EndObject();
+    writer.Flush();
+    BOOST_CHECK_EQUAL(out, R"({"a":1,"b":"x","c":["y",{}]})");
+}
+
+BOOST_AUTO_TEST_CASE(tx_to_json_matches_tx_to_univ)
+{
+    CMutableTransaction mtx;
+    mtx.version = 2;
+    mtx.nLockTime = 100;
+    mtx.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), 3}, CScript{} << OP_1, 0xfffffffe);
+    mtx.vin[0].scriptWitness.stack = {{1, 2, 3}, {}};
+    mtx.vout.emplace_back(50000, CScript{} << OP_RETURN);
+    mtx.vout.emplace_back(12345, CScript{} << OP_TRUE);
+    const CTransaction tx{mtx};
+
+    CTxUndo txundo;
+    txundo.vprevout.emplace_back(CTxOut{100000, CScript{} << OP_TRUE}, /*nHeightIn=*/10, /*fCoinBaseIn=*/false);
+
+    for (const TxVerbosity verbosity : {TxVerbosity::SHOW_DETAILS, TxVerbosity::SHOW_DETAILS_AND_PREVOUT}) {
+        for (const CTxUndo* undo : std::vector<const CTxUndo*>{nullptr, &txundo}) {
+            UniValue expected{UniValue::VOBJ};
+            TxToUniv(tx, uint256::ONE, expected, /*include_hex=*/true, undo, verbosity);
+
+            std::string out;
+            JsonWriter writer{[&](std::string_view chunk) { out += chunk; }, /*flush_threshold=*/16};
+            TxToJSON(writer, tx, uint256::ONE, /*include_hex=*/true, undo, verbosity);
+            writer.Flush();
+            BOOST_CHECK_EQUAL(out, expected.write());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
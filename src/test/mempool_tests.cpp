@@ -116,6 +116,36 @@ BOOST_AUTO_TEST_CASE(MempoolRemoveTest)
     BOOST_CHECK_EQUAL(testPool.size(), 0U);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolMemoryArenaTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(::cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+
+    std::vector<CMutableTransaction> txs(2000);
+    for (size_t i{0}; i < txs.size(); ++i) {
+        txs[i].vin.resize(1);
+        txs[i].vin[0].scriptSig = CScript() << i;
+        txs[i].vout.resize(1);
+        txs[i].vout[0].scriptPubKey = CScript() << OP_11 << OP_EQUAL;
+        txs[i].vout[0].nValue = 11000LL;
+    }
+
+    for (const auto& tx : txs) TryAddToMempool(pool, entry.FromTx(tx));
+    const size_t chunks{pool.m_memory_resource.NumAllocatedChunks()};
+    // The entries and their spent outpoints did not fit into the first chunk
+    BOOST_CHECK_GT(chunks, 1U);
+    BOOST_CHECK_GE(pool.AllocatedMemoryUsage(), chunks * pool.m_memory_resource.ChunkSizeBytes());
+
+    // The arena keeps its chunks when transactions are removed, and reuses them
+    for (const auto& tx : txs) pool.removeRecursive(CTransaction(tx), REMOVAL_REASON_DUMMY);
+    BOOST_CHECK_EQUAL(pool.size(), 0U);
+    BOOST_CHECK_EQUAL(pool.m_memory_resource.NumAllocatedChunks(), chunks);
+    BOOST_CHECK_LT(pool.DynamicMemoryUsage(), pool.AllocatedMemoryUsage());
+    for (const auto& tx : txs) TryAddToMempool(pool, entry.FromTx(tx));
+    BOOST_CHECK_EQUAL(pool.m_memory_resource.NumAllocatedChunks(), chunks);
+}
+
 BOOST_AUTO_TEST_CASE(MempoolSizeLimitTest)
 {
     auto& pool = static_cast<MemPoolTest&>(*Assert(m_node.mempool));
@@ -37,6 +37,7 @@ using namespace util::hex_literals;
 using interfaces::BlockTemplate;
 using interfaces::Mining;
 using node::BlockAssembler;
+using node::BlockTemplateCache;
 
 namespace miner_tests {
 struct MinerTestingSetup : public TestingSetup {
@@ -869,4 +870,119 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     TestPrioritisedMining(scriptPubKey, txFirst);
 }
 
+BOOST_FIXTURE_TEST_CASE(block_template_cache, TestChain100Setup)
+{
+    const CScript script{m_coinbase_txns[0]->vout[0].scriptPubKey};
+    BlockAssembler::Options options;
+    options.coinbase_output_script = script;
+    BlockTemplateCache cache{m_node.chainman->ActiveChainstate(), m_node.mempool.get(), options};
+
+    // The first template is built from scratch
+    auto block_template{cache.GetBlockTemplate()};
+    BOOST_REQUIRE(block_template);
+    BOOST_CHECK_EQUAL(block_template->block.vtx.size(), 1U);
+    BOOST_CHECK_EQUAL(cache.GetStats().full_builds, 1U);
+
+    // Without mempool changes the mempool is not looked at again
+    BOOST_CHECK(!cache.GetBlockTemplate(/*min_fees=*/1));
+    BOOST_REQUIRE(cache.GetBlockTemplate());
+    BOOST_CHECK_EQUAL(cache.GetStats().reused, 2U);
+    BOOST_CHECK_EQUAL(cache.GetStats().updates, 0U);
+
+    // A new transaction causes a new selection, which is only completed when
+    // its fees are high enough
+    const CMutableTransaction tx{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1,
+                                                               coinbaseKey, script, 49 * COIN, /*submit=*/true)};
+    BOOST_CHECK(!cache.GetBlockTemplate(/*min_fees=*/2 * COIN));
+    BOOST_CHECK_EQUAL(cache.GetStats().updates, 1U);
+    BOOST_CHECK(!cache.GetBlockTemplate(/*min_fees=*/2 * COIN));
+    BOOST_CHECK_EQUAL(cache.GetStats().reused, 3U);
+    block_template = cache.GetBlockTemplate(/*min_fees=*/COIN);
+    BOOST_REQUIRE(block_template);
+    BOOST_CHECK_EQUAL(cache.GetStats().updates, 2U);
+    BOOST_REQUIRE_EQUAL(block_template->block.vtx.size(), 2U);
+    BOOST_CHECK_EQUAL(block_template->block.vtx[1]->GetHash(), tx.GetHash());
+    BOOST_CHECK_EQUAL(block_template->vTxFees[0], COIN);
+    BOOST_CHECK_EQUAL(block_template->block.vtx[0]->vout[0].nValue, COIN + GetBlockSubsidy(101, m_node.chainman->GetConsensus()));
+
+    // Fee changes count as mempool changes
+    m_node.mempool->PrioritiseTransaction(tx.GetHash(), COIN);
+    BOOST_REQUIRE(cache.GetBlockTemplate());
+    BOOST_CHECK_EQUAL(cache.GetStats().updates, 3U);
+
+    // A new tip causes a full build, regardless of the fees
+    const uint256 tip_hash{CreateAndProcessBlock({}, script).GetHash()};
+    block_template = cache.GetBlockTemplate(/*min_fees=*/MAX_MONEY);
+    BOOST_REQUIRE(block_template);
+    BOOST_CHECK_EQUAL(block_template->block.hashPrevBlock, tip_hash);
+    BOOST_CHECK_EQUAL(cache.GetStats().full_builds, 2U);
+}
+
+BOOST_FIXTURE_TEST_CASE(block_template_delta, TestChain100Setup)
+{
+    const CScript script{m_coinbase_txns[0]->vout[0].scriptPubKey};
+    // Let the coinbase outputs of the first three blocks mature
+    for (int i{0}; i < 2; ++i) CreateAndProcessBlock({}, script);
+    auto mining{interfaces::MakeMining(m_node, /*wait_loaded=*/false)};
+    BlockAssembler::Options options;
+    options.coinbase_output_script = script;
+
+    auto block_template{mining->createNewBlock(options, /*cooldown=*/false)};
+    BOOST_REQUIRE(block_template);
+    auto delta{block_template->getDelta()};
+    BOOST_CHECK(delta.added.empty() && delta.removed.empty() && delta.tx_order.empty());
+
+    // Transactions spending different coinbase outputs, with fees of the given number of coins
+    auto make_tx{[&](int i, int fee) {
+        return CreateValidMempoolTransaction(m_coinbase_txns[i], /*input_vout=*/0, /*input_height=*/i + 1,
+                                             coinbaseKey, script, (50 - fee) * COIN, /*submit=*/true);
+    }};
+    const CMutableTransaction tx1{make_tx(0, 1)};
+    const CMutableTransaction tx2{make_tx(1, 2)};
+    block_template = block_template->waitNext({.timeout = MillisecondsDouble{0}, .fee_threshold = 1});
+    BOOST_REQUIRE(block_template);
+    delta = block_template->getDelta();
+    BOOST_CHECK(delta.removed.empty());
+    BOOST_REQUIRE_EQUAL(delta.added.size(), 2U);
+    BOOST_CHECK_EQUAL(delta.added[0]->GetHash(), tx2.GetHash());
+    BOOST_CHECK_EQUAL(delta.added[1]->GetHash(), tx1.GetHash());
+    BOOST_CHECK(delta.added_fees == std::vector<CAmount>({2 * COIN, COIN}));
+    BOOST_CHECK(delta.added_sigops == block_template->getTxSigops());
+    BOOST_CHECK(delta.tx_order == std::vector<uint32_t>({0, 1}));
+    BOOST_CHECK(delta.coinbase_merkle_path == block_template->getCoinbaseMerklePath());
+    BOOST_CHECK_EQUAL(delta.previous_fees, 0);
+    BOOST_CHECK_EQUAL(delta.fees, 3 * COIN);
+
+    // Replace tx1 with a transaction that has a higher fee than tx2
+    {
+        LOCK2(::cs_main, m_node.mempool->cs);
+        m_node.mempool->removeRecursive(CTransaction{tx1}, MemPoolRemovalReason::REPLACED);
+    }
+    const CMutableTransaction tx3{make_tx(2, 3)};
+    block_template = block_template->waitNext({.timeout = MillisecondsDouble{0}, .fee_threshold = 1});
+    BOOST_REQUIRE(block_template);
+    delta = block_template->getDelta();
+    BOOST_REQUIRE_EQUAL(delta.removed.size(), 1U);
+    BOOST_CHECK_EQUAL(delta.removed[0], CTransaction{tx1}.GetWitnessHash());
+    BOOST_REQUIRE_EQUAL(delta.added.size(), 1U);
+    BOOST_CHECK_EQUAL(delta.added[0]->GetHash(), tx3.GetHash());
+    // tx3 comes first, followed by tx2 from the start of the previous template
+    BOOST_CHECK(delta.tx_order == std::vector<uint32_t>({2, 0}));
+    BOOST_CHECK_EQUAL(delta.previous_fees, 3 * COIN);
+    BOOST_CHECK_EQUAL(delta.fees, 5 * COIN);
+
+    // A template on a new tip is diffed against an empty template
+    CreateAndProcessBlock({}, script);
+    block_template = block_template->waitNext({.timeout = MillisecondsDouble{0}});
+    BOOST_REQUIRE(block_template);
+    delta = block_template->getDelta();
+    BOOST_CHECK(delta.removed.empty());
+    BOOST_REQUIRE_EQUAL(delta.added.size(), 2U);
+    BOOST_CHECK_EQUAL(delta.added[0]->GetHash(), tx3.GetHash());
+    BOOST_CHECK_EQUAL(delta.added[1]->GetHash(), tx2.GetHash());
+    BOOST_CHECK(delta.tx_order == std::vector<uint32_t>({0, 1}));
+    BOOST_CHECK_EQUAL(delta.previous_fees, 0);
+    BOOST_CHECK_EQUAL(delta.fees, 5 * COIN);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
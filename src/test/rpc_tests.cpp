@@ -15,6 +15,7 @@
 #include <util/time.h>
 
 #include <any>
+#include <chrono>
 #include <string_view>
 
 #include <boost/test/unit_test.hpp>
@@ -643,4 +644,34 @@ BOOST_AUTO_TEST_CASE(rpc_arg_helper)
     CheckRpc(params, UniValue{JSON(R"([5, "hello", 4, "test", true, 1.23, "world"])")}, check_positional);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_method_counters)
+{
+    RPCMethodCounters counters;
+    BOOST_CHECK_EQUAL(counters.Snapshot().calls, 0U);
+
+    counters.BeginCall();
+    BOOST_CHECK_EQUAL(counters.Snapshot().in_flight, 1U);
+    counters.EndCall(std::chrono::microseconds{RPC_LATENCY_BUCKETS_US.front()}, /*error=*/false);
+    counters.BeginCall();
+    counters.EndCall(std::chrono::microseconds{RPC_LATENCY_BUCKETS_US.front() + 1}, /*error=*/true);
+    counters.BeginCall();
+    counters.EndCall(std::chrono::microseconds{RPC_LATENCY_BUCKETS_US.back() + 1}, /*error=*/false);
+    // A clock going backwards counts as no time spent
+    counters.BeginCall();
+    counters.EndCall(std::chrono::microseconds{-1}, /*error=*/false);
+    counters.AddTraffic(10, 20);
+
+    const RPCMethodStats stats{counters.Snapshot()};
+    BOOST_CHECK_EQUAL(stats.calls, 4U);
+    BOOST_CHECK_EQUAL(stats.errors, 1U);
+    BOOST_CHECK_EQUAL(stats.in_flight, 0U);
+    BOOST_CHECK_EQUAL(stats.bytes_in, 10U);
+    BOOST_CHECK_EQUAL(stats.bytes_out, 20U);
+    BOOST_CHECK_EQUAL(stats.latency_sum_us, uint64_t(2 * RPC_LATENCY_BUCKETS_US.front() + RPC_LATENCY_BUCKETS_US.back() + 2));
+    // Bucket bounds are inclusive, and calls slower than the last bound go into the overflow bucket
+    BOOST_CHECK_EQUAL(stats.latency_buckets[0], 2U);
+    BOOST_CHECK_EQUAL(stats.latency_buckets[1], 1U);
+    BOOST_CHECK_EQUAL(stats.latency_buckets.back(), 1U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <chain.h>
+#include <consensus/validation.h>
+#include <index/scriptindex.h>
+#include <interfaces/chain.h>
+#include <key.h>
+#include <script/script.h>
+#include <test/util/common.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <optional>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(scriptindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(scriptindex_history, TestChain100Setup)
+{
+    const CScript& coinbase_script{m_coinbase_txns[0]->vout[0].scriptPubKey};
+    const CKey key{GenerateRandomKey()};
+    const CScript script{GetScriptForDestination(WitnessV0KeyHash(key.GetPubKey()))};
+
+    // Pay to the script in one block, and spend from it in the next one
+    const CMutableTransaction funding_tx{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1,
+                                                                       coinbaseKey, script, 10 * COIN, /*submit=*/false)};
+    CreateAndProcessBlock({funding_tx}, coinbase_script);
+    const CMutableTransaction spending_tx{CreateValidMempoolTransaction(MakeTransactionRef(funding_tx), /*input_vout=*/0, /*input_height=*/101,
+                                                                        key, coinbase_script, 9 * COIN, /*submit=*/false)};
+    const uint256 tip_hash{CreateAndProcessBlock({spending_tx}, coinbase_script).GetHash()};
+
+    ScriptIndex index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(index.Init());
+    index.Sync();
+    BOOST_CHECK_EQUAL(index.GetSummary().best_block_hash, tip_hash);
+
+    std::vector<ScriptIndexEntry> entries;
+    BOOST_CHECK(!index.FindScriptHistory(script, /*after=*/std::nullopt, /*max_entries=*/10, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 2U);
+    BOOST_CHECK(entries[0].type == ScriptIndexEntry::Type::FUNDING);
+    BOOST_CHECK_EQUAL(entries[0].height, 101);
+    BOOST_CHECK(entries[0].outpoint == COutPoint(funding_tx.GetHash(), 0));
+    BOOST_CHECK_EQUAL(entries[0].amount, 10 * COIN);
+    BOOST_CHECK(entries[1].type == ScriptIndexEntry::Type::SPENDING);
+    BOOST_CHECK_EQUAL(entries[1].height, 102);
+    BOOST_CHECK(entries[1].outpoint == COutPoint(funding_tx.GetHash(), 0));
+    BOOST_CHECK_EQUAL(entries[1].amount, 10 * COIN);
+    BOOST_CHECK_EQUAL(entries[1].spending_txid, spending_tx.GetHash());
+    BOOST_CHECK_EQUAL(entries[1].spending_input, 0U);
+
+    // The coinbase script was paid by every block and by the spending
+    // transaction, and spent from by the funding transaction.
+    std::vector<ScriptIndexEntry> full_history;
+    BOOST_CHECK(!index.FindScriptHistory(coinbase_script, std::nullopt, 1000, full_history));
+    BOOST_CHECK_EQUAL(full_history.size(), 102U + 2U);
+
+    // Paging through the history with cursors returns the same entries, in height order
+    std::vector<ScriptIndexEntry> paged_history;
+    std::optional<ScriptIndexEntry> after;
+    bool more{true};
+    while (more) {
+        std::vector<ScriptIndexEntry> page;
+        more = index.FindScriptHistory(coinbase_script, after, 7, page);
+        BOOST_REQUIRE(!page.empty());
+        BOOST_CHECK(page.size() == 7 || !more);
+        after = DecodeScriptHistoryCursor(EncodeScriptHistoryCursor(page.back()));
+        BOOST_REQUIRE(after);
+        paged_history.insert(paged_history.end(), page.begin(), page.end());
+    }
+    BOOST_REQUIRE_EQUAL(paged_history.size(), full_history.size());
+    for (size_t i{0}; i < full_history.size(); ++i) {
+        BOOST_CHECK(paged_history[i].outpoint == full_history[i].outpoint);
+        BOOST_CHECK(paged_history[i].type == full_history[i].type);
+        if (i > 0) BOOST_CHECK_LE(paged_history[i - 1].height, paged_history[i].height);
+    }
+
+    BOOST_CHECK(!DecodeScriptHistoryCursor("zz"));
+    BOOST_CHECK(!DecodeScriptHistoryCursor("00"));
+    BOOST_CHECK(!DecodeScriptHistoryCursor(EncodeScriptHistoryCursor(entries[0]) + "00"));
+
+    // Entries of disconnected blocks are removed
+    {
+        BlockValidationState state;
+        CBlockIndex* tip{WITH_LOCK(::cs_main, return m_node.chainman->ActiveTip())};
+        BOOST_REQUIRE(m_node.chainman->ActiveChainstate().InvalidateBlock(state, tip));
+    }
+    CreateAndProcessBlock({}, coinbase_script);
+    BOOST_CHECK(index.BlockUntilSyncedToCurrentChain());
+    entries.clear();
+    BOOST_CHECK(!index.FindScriptHistory(script, std::nullopt, 10, entries));
+    BOOST_REQUIRE_EQUAL(entries.size(), 1U);
+    BOOST_CHECK(entries[0].type == ScriptIndexEntry::Type::FUNDING);
+
+    index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
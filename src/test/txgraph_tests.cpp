@@ -431,4 +431,70 @@ BOOST_AUTO_TEST_CASE(txgraph_staging)
     graph->SanityCheck();
 }
 
+BOOST_AUTO_TEST_CASE(txgraph_linearization_job)
+{
+    auto graph = MakeTxGraph(/*max_cluster_count=*/50, /*max_cluster_size=*/100'000, HIGH_ACCEPTABLE_COST, PointerComparator);
+
+    // Build two chains, with fees increasing towards the end, so that they are linearized into
+    // a single chunk each.
+    std::vector<TxGraph::Ref> refs;
+    refs.reserve(20);
+    for (int i = 0; i < 20; ++i) {
+        graph->AddTransaction(refs.emplace_back(), FeePerWeight{i % 10, 10});
+        if (i % 10 != 0) graph->AddDependency(/*parent=*/refs[i - 1], /*child=*/refs[i]);
+    }
+    BOOST_CHECK_EQUAL(graph->GetMainNonOptimalClusterCount(), 0);
+
+    // A job is created for one of the clusters resulting from the new dependencies.
+    auto job = graph->GetLinearizationJob();
+    BOOST_REQUIRE(job);
+    BOOST_CHECK_EQUAL(graph->GetMainNonOptimalClusterCount(), 2);
+    // Results are only applied after the job was run.
+    BOOST_CHECK(!graph->ApplyLinearizationJob(*job));
+    BOOST_CHECK(job->Run(HIGH_ACCEPTABLE_COST).second);
+    BOOST_CHECK(graph->ApplyLinearizationJob(*job));
+    graph->SanityCheck();
+    BOOST_CHECK_EQUAL(graph->GetMainNonOptimalClusterCount(), 1);
+    // Applying it again is not possible, as the cluster is optimal already.
+    BOOST_CHECK(!graph->ApplyLinearizationJob(*job));
+
+    // A job for a cluster that is modified while it runs is discarded.
+    job = graph->GetLinearizationJob();
+    BOOST_REQUIRE(job);
+    graph->SetTransactionFee(refs[9], 100);
+    graph->SetTransactionFee(refs[19], 100);
+    job->Run(HIGH_ACCEPTABLE_COST);
+    BOOST_CHECK(!graph->ApplyLinearizationJob(*job));
+    graph->SanityCheck();
+    BOOST_CHECK_EQUAL(graph->GetMainNonOptimalClusterCount(), 2);
+
+    // A new job for the modified cluster can be applied.
+    job = graph->GetLinearizationJob();
+    BOOST_REQUIRE(job);
+    job->Run(HIGH_ACCEPTABLE_COST);
+    BOOST_CHECK(graph->ApplyLinearizationJob(*job));
+    graph->SanityCheck();
+    BOOST_CHECK_EQUAL(graph->GetMainNonOptimalClusterCount(), 1);
+
+    // No jobs are created or applied while the main graph is being observed.
+    job = graph->GetLinearizationJob();
+    BOOST_REQUIRE(job);
+    job->Run(HIGH_ACCEPTABLE_COST);
+    {
+        auto builder = graph->GetBlockBuilder();
+        BOOST_CHECK(!graph->GetLinearizationJob());
+        BOOST_CHECK(!graph->ApplyLinearizationJob(*job));
+    }
+    graph->SanityCheck();
+    // Creating the block builder made all clusters acceptable, which here means optimal.
+    BOOST_CHECK_EQUAL(graph->GetMainNonOptimalClusterCount(), 0);
+    BOOST_CHECK(!graph->GetLinearizationJob());
+    BOOST_CHECK(graph->DoWork(/*max_cost=*/0));
+
+    // Both chains ended up as a single chunk.
+    for (const auto& ref : refs) {
+        BOOST_CHECK_EQUAL(graph->GetMainChunkFeerate(ref).size, 100);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
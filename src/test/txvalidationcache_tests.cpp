@@ -385,4 +385,35 @@ BOOST_FIXTURE_TEST_CASE(checkinputs_test, Dersig100Setup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(mempool_parallel_script_checks, TestChain100Setup)
+{
+    // Transactions with enough inputs have their policy script checks run on
+    // the script check queue, which must report failures the same way.
+    BOOST_REQUIRE(m_node.chainman->GetCheckQueue().HasThreads());
+    constexpr size_t NUM_INPUTS{MIN_PARALLEL_MEMPOOL_SCRIPT_CHECK_INPUTS + 8};
+    const CScript p2pk_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+
+    const CTransactionRef fan_out{MakeTransactionRef(CreateValidMempoolTransaction({m_coinbase_txns[0]}, {COutPoint{m_coinbase_txns[0]->GetHash(), 0}},
+                                                                                   /*input_height=*/1, {coinbaseKey},
+                                                                                   std::vector<CTxOut>(NUM_INPUTS, CTxOut{COIN, p2pk_script}), /*submit=*/false))};
+    CreateAndProcessBlock({CMutableTransaction{*fan_out}}, p2pk_script);
+
+    std::vector<COutPoint> inputs;
+    for (uint32_t i{0}; i < NUM_INPUTS; ++i) inputs.emplace_back(fan_out->GetHash(), i);
+    const CMutableTransaction consolidation{CreateValidMempoolTransaction({fan_out}, inputs, /*input_height=*/101, {coinbaseKey},
+                                                                          {CTxOut{(NUM_INPUTS - 1) * COIN, p2pk_script}}, /*submit=*/false)};
+
+    // A signature for another input fails the NULLFAIL rule
+    CMutableTransaction invalid{consolidation};
+    invalid.vin[NUM_INPUTS / 2].scriptSig = invalid.vin[0].scriptSig;
+    LOCK(cs_main);
+    const auto invalid_result{m_node.chainman->ProcessTransaction(MakeTransactionRef(invalid))};
+    BOOST_CHECK(invalid_result.m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK_EQUAL(invalid_result.m_state.GetRejectReason(), "mempool-script-verify-flag-failed (Signature must be zero for failed CHECK(MULTI)SIG operation)");
+
+    const auto result{m_node.chainman->ProcessTransaction(MakeTransactionRef(consolidation))};
+    BOOST_CHECK(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK(m_node.mempool->exists(consolidation.GetHash()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
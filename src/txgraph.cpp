@@ -11,6 +11,7 @@
 #include <util/feefrac.h>
 #include <util/vector.h>
 
+#include <algorithm>
 #include <compare>
 #include <functional>
 #include <memory>
@@ -29,6 +30,8 @@ static constexpr int MAX_LEVELS{2};
 
 // Forward declare the TxGraph implementation class.
 class TxGraphImpl;
+// Forward declare the TxGraph::LinearizationJob implementation class.
+class LinearizationJobImpl;
 
 /** Position of a DepGraphIndex within a Cluster::m_linearization. */
 using LinearizationIndex = uint32_t;
@@ -219,6 +222,12 @@ public:
     /** Improve the linearization of this Cluster. Returns how much work was performed and whether
      *  the Cluster's QualityLevel improved as a result. */
     virtual std::pair<uint64_t, bool> Relinearize(TxGraphImpl& graph, int level, uint64_t max_cost) noexcept = 0;
+    /** Create a job with a snapshot of this Cluster, for improving its linearization outside of
+     *  the TxGraph. The Cluster may not need splitting, and cannot be optimal already. */
+    virtual std::unique_ptr<LinearizationJobImpl> GetLinearizationJob(const TxGraphImpl& graph, uint64_t rng_seed) const noexcept = 0;
+    /** Replace the linearization with the result of a job created by GetLinearizationJob, if this
+     *  Cluster and its linearization are unchanged since. Returns whether it was replaced. */
+    virtual bool ApplyLinearizationJob(TxGraphImpl& graph, int level, LinearizationJobImpl& job) noexcept = 0;
     /** For every chunk in the cluster, append its FeeFrac to ret. */
     virtual void AppendChunkFeerates(std::vector<FeeFrac>& ret) const noexcept = 0;
     /** Add a TrimTxData entry (filling m_chunk_feerate, m_index, m_tx_size) for every
@@ -263,6 +272,10 @@ class GenericClusterImpl final : public Cluster
      *  m_depgraph.TxCount(). This is always kept topological. */
     std::vector<DepGraphIndex> m_linearization;
 
+    /** Replace m_linearization with a new linearization, found with max_cost work, and update the
+     *  quality and the Entry objects accordingly. Returns whether the quality improved. */
+    bool SetLinearization(TxGraphImpl& graph, int level, std::vector<DepGraphIndex>&& linearization, bool optimal, uint64_t max_cost) noexcept;
+
 public:
     /** The smallest number of transactions this Cluster implementation is intended for. */
     static constexpr DepGraphIndex MIN_INTENDED_TX_COUNT{2};
@@ -298,6 +311,8 @@ public:
     void Merge(TxGraphImpl& graph, int level, Cluster& cluster) noexcept final;
     void ApplyDependencies(TxGraphImpl& graph, int level, std::span<std::pair<GraphIndex, GraphIndex>> to_apply) noexcept final;
     std::pair<uint64_t, bool> Relinearize(TxGraphImpl& graph, int level, uint64_t max_cost) noexcept final;
+    std::unique_ptr<LinearizationJobImpl> GetLinearizationJob(const TxGraphImpl& graph, uint64_t rng_seed) const noexcept final;
+    bool ApplyLinearizationJob(TxGraphImpl& graph, int level, LinearizationJobImpl& job) noexcept final;
     void AppendChunkFeerates(std::vector<FeeFrac>& ret) const noexcept final;
     uint64_t AppendTrimData(std::vector<TrimTxData>& ret, std::vector<std::pair<GraphIndex, GraphIndex>>& deps) const noexcept final;
     void GetAncestorRefs(const TxGraphImpl& graph, std::span<std::pair<Cluster*, DepGraphIndex>>& args, std::vector<TxGraph::Ref*>& output) noexcept final;
@@ -355,6 +370,8 @@ public:
     void Merge(TxGraphImpl& graph, int level, Cluster& cluster) noexcept final;
     void ApplyDependencies(TxGraphImpl& graph, int level, std::span<std::pair<GraphIndex, GraphIndex>> to_apply) noexcept final;
     std::pair<uint64_t, bool> Relinearize(TxGraphImpl& graph, int level, uint64_t max_cost) noexcept final;
+    std::unique_ptr<LinearizationJobImpl> GetLinearizationJob(const TxGraphImpl& graph, uint64_t rng_seed) const noexcept final;
+    bool ApplyLinearizationJob(TxGraphImpl& graph, int level, LinearizationJobImpl& job) noexcept final;
     void AppendChunkFeerates(std::vector<FeeFrac>& ret) const noexcept final;
     uint64_t AppendTrimData(std::vector<TrimTxData>& ret, std::vector<std::pair<GraphIndex, GraphIndex>>& deps) const noexcept final;
     void GetAncestorRefs(const TxGraphImpl& graph, std::span<std::pair<Cluster*, DepGraphIndex>>& args, std::vector<TxGraph::Ref*>& output) noexcept final;
@@ -394,6 +411,7 @@ class TxGraphImpl final : public TxGraph
     friend class SingletonClusterImpl;
     friend class GenericClusterImpl;
     friend class BlockBuilderImpl;
+    friend class LinearizationJobImpl;
 private:
     /** Internal RNG. */
     FastRandomContext m_rng;
@@ -803,6 +821,9 @@ public:
     void SetTransactionFee(const Ref&, int64_t fee) noexcept final;
 
     bool DoWork(uint64_t max_cost) noexcept final;
+    std::unique_ptr<LinearizationJob> GetLinearizationJob() noexcept final;
+    bool ApplyLinearizationJob(LinearizationJob& job) noexcept final;
+    GraphIndex GetMainNonOptimalClusterCount() noexcept final;
 
     void StartStaging() noexcept final;
     void CommitStaging() noexcept final;
@@ -878,6 +899,43 @@ public:
     void Skip() noexcept final;
 };
 
+/** Implementation of the TxGraph::LinearizationJob interface. */
+class LinearizationJobImpl final : public TxGraph::LinearizationJob
+{
+    friend class TxGraphImpl;
+    friend class GenericClusterImpl;
+    using GraphIndex = TxGraph::GraphIndex;
+    using SetType = BitSet<MAX_CLUSTER_COUNT_LIMIT>;
+
+    /** Which TxGraphImpl this job was created by. Only used to check the job is applied to the
+     *  same graph; never dereferenced. */
+    const TxGraphImpl* m_graph{nullptr};
+    /** The m_sequence of the Cluster this job was created for. */
+    uint64_t m_sequence{0};
+    /** A transaction in the Cluster, used to find it back. */
+    GraphIndex m_graph_index{GraphIndex(-1)};
+    /** Copies of the Cluster's m_depgraph, m_mapping, and m_linearization. */
+    DepGraph<SetType> m_depgraph;
+    std::vector<GraphIndex> m_mapping;
+    std::vector<DepGraphIndex> m_linearization;
+    /** Whether m_linearization is topological. */
+    bool m_is_topological{true};
+    /** The position of every transaction of m_depgraph in the graph's fallback order (which
+     *  cannot be invoked from Run(), as it accesses the Refs). */
+    std::vector<DepGraphIndex> m_fallback_rank;
+    /** Random number seed for Linearize(). */
+    uint64_t m_rng_seed{0};
+    /** The linearization found by Run(). Empty if it has not been invoked. */
+    std::vector<DepGraphIndex> m_result;
+    /** Whether m_result is optimal. */
+    bool m_optimal{false};
+    /** The max_cost Run() was invoked with. */
+    uint64_t m_max_cost{0};
+
+public:
+    std::pair<uint64_t, bool> Run(uint64_t max_cost) noexcept final;
+};
+
 void TxGraphImpl::ClearChunkData(Entry& entry) noexcept
 {
     if (entry.m_main_chunkindex_iterator != m_main_chunkindex.end()) {
@@ -2177,6 +2235,12 @@ std::pair<uint64_t, bool> GenericClusterImpl::Relinearize(TxGraphImpl& graph, in
     // Postlinearize to improve the linearization (if optimal, only the sub-chunk order).
     // This also guarantees that all chunks are connected (even when non-optimal).
     PostLinearize(m_depgraph, linearization);
+    bool improved = SetLinearization(graph, level, std::move(linearization), optimal, max_cost);
+    return {cost, improved};
+}
+
+bool GenericClusterImpl::SetLinearization(TxGraphImpl& graph, int level, std::vector<DepGraphIndex>&& linearization, bool optimal, uint64_t max_cost) noexcept
+{
     // Update the linearization.
     m_linearization = std::move(linearization);
     // Update the Cluster's quality.
@@ -2193,7 +2257,80 @@ std::pair<uint64_t, bool> GenericClusterImpl::Relinearize(TxGraphImpl& graph, in
     }
     // Update the Entry objects.
     Updated(graph, /*level=*/level, /*rename=*/false);
-    return {cost, improved};
+    return improved;
+}
+
+std::unique_ptr<LinearizationJobImpl> GenericClusterImpl::GetLinearizationJob(const TxGraphImpl& graph, uint64_t rng_seed) const noexcept
+{
+    Assume(!NeedsSplitting() && !IsOptimal());
+    auto job = std::make_unique<LinearizationJobImpl>();
+    job->m_graph = &graph;
+    job->m_sequence = m_sequence;
+    job->m_graph_index = m_mapping[m_linearization.front()];
+    job->m_depgraph = m_depgraph;
+    job->m_mapping = m_mapping;
+    job->m_linearization = m_linearization;
+    job->m_is_topological = IsTopological();
+    job->m_rng_seed = rng_seed;
+    // Rank the transactions by the fallback order now, as it cannot be invoked from the job.
+    std::vector<DepGraphIndex> order(m_linearization);
+    std::sort(order.begin(), order.end(), [&](DepGraphIndex a, DepGraphIndex b) noexcept {
+        const auto ref_a = graph.m_entries[m_mapping[a]].m_ref;
+        const auto ref_b = graph.m_entries[m_mapping[b]].m_ref;
+        return graph.m_fallback_order(*ref_a, *ref_b) < 0;
+    });
+    job->m_fallback_rank.resize(m_depgraph.PositionRange());
+    for (DepGraphIndex rank = 0; rank < order.size(); ++rank) {
+        job->m_fallback_rank[order[rank]] = rank;
+    }
+    return job;
+}
+
+std::unique_ptr<LinearizationJobImpl> SingletonClusterImpl::GetLinearizationJob(const TxGraphImpl& graph, uint64_t rng_seed) const noexcept
+{
+    // All singletons are optimal, oversized, or need splitting. Each of these precludes
+    // GetLinearizationJob from being called.
+    assert(false);
+    return nullptr;
+}
+
+bool GenericClusterImpl::ApplyLinearizationJob(TxGraphImpl& graph, int level, LinearizationJobImpl& job) noexcept
+{
+    // Only accept the result if it was computed from the current state of this Cluster: the same
+    // transactions and dependencies at the same positions, and the same linearization.
+    if (NeedsSplitting() || IsOptimal() || job.m_is_topological != IsTopological()) return false;
+    if (!(job.m_depgraph == m_depgraph) || job.m_linearization != m_linearization) return false;
+    for (auto i : m_depgraph.Positions()) {
+        if (job.m_mapping[i] != m_mapping[i]) return false;
+    }
+    SetLinearization(graph, level, std::move(job.m_result), job.m_optimal, job.m_max_cost);
+    return true;
+}
+
+bool SingletonClusterImpl::ApplyLinearizationJob(TxGraphImpl& graph, int level, LinearizationJobImpl& job) noexcept
+{
+    // A singleton is never the subject of a job, so it must have been modified since.
+    return false;
+}
+
+std::pair<uint64_t, bool> LinearizationJobImpl::Run(uint64_t max_cost) noexcept
+{
+    const auto fallback_order = [&](DepGraphIndex a, DepGraphIndex b) noexcept {
+        return m_fallback_rank[a] <=> m_fallback_rank[b];
+    };
+    auto [linearization, optimal, cost] = Linearize(
+        /*depgraph=*/m_depgraph,
+        /*max_cost=*/max_cost,
+        /*rng_seed=*/m_rng_seed,
+        /*fallback_order=*/fallback_order,
+        /*old_linearization=*/m_linearization,
+        /*is_topological=*/m_is_topological);
+    // Postlinearize, like Relinearize does.
+    PostLinearize(m_depgraph, linearization);
+    m_result = std::move(linearization);
+    m_optimal = optimal;
+    m_max_cost = max_cost;
+    return {cost, optimal};
 }
 
 std::pair<uint64_t, bool> SingletonClusterImpl::Relinearize(TxGraphImpl& graph, int level, uint64_t max_cost) noexcept
@@ -3156,6 +3293,50 @@ bool TxGraphImpl::DoWork(uint64_t max_cost) noexcept
     return true;
 }
 
+std::unique_ptr<TxGraph::LinearizationJob> TxGraphImpl::GetLinearizationJob() noexcept
+{
+    // Do not modify main if it has any observers.
+    if (m_main_chunkindex_observers != 0) return nullptr;
+    ApplyDependencies(/*level=*/0);
+    auto& clusterset = GetClusterSet(/*level=*/0);
+    // Do not modify oversized levels.
+    if (clusterset.m_oversized == true) return nullptr;
+    // Like DoWork, prioritize clusters which are not acceptable yet, and pick a random one among
+    // them, so that a cluster which is hard to linearize does not prevent work on others.
+    for (QualityLevel quality : {QualityLevel::NEEDS_FIX, QualityLevel::NEEDS_RELINEARIZE, QualityLevel::ACCEPTABLE}) {
+        auto& queue = clusterset.m_clusters[int(quality)];
+        if (queue.empty()) continue;
+        auto pos = m_rng.randrange<size_t>(queue.size());
+        return queue[pos]->GetLinearizationJob(*this, m_rng.rand64());
+    }
+    return nullptr;
+}
+
+bool TxGraphImpl::ApplyLinearizationJob(LinearizationJob& job_arg) noexcept
+{
+    auto& job = static_cast<LinearizationJobImpl&>(job_arg);
+    Assume(job.m_graph == this);
+    // Nothing to apply if the job was not run.
+    if (job.m_result.empty()) return false;
+    // Do not modify main if it has any observers.
+    if (m_main_chunkindex_observers != 0) return false;
+    // Find the Cluster the job was created for, which may have been modified or destroyed since.
+    if (job.m_graph_index >= m_entries.size()) return false;
+    auto [cluster, level] = FindClusterAndLevel(job.m_graph_index, /*level=*/0);
+    if (cluster == nullptr || cluster->m_sequence != job.m_sequence) return false;
+    return cluster->ApplyLinearizationJob(*this, level, job);
+}
+
+TxGraph::GraphIndex TxGraphImpl::GetMainNonOptimalClusterCount() noexcept
+{
+    GraphIndex ret{0};
+    for (QualityLevel quality : {QualityLevel::NEEDS_SPLIT_FIX, QualityLevel::NEEDS_SPLIT, QualityLevel::NEEDS_FIX,
+                                 QualityLevel::NEEDS_RELINEARIZE, QualityLevel::ACCEPTABLE}) {
+        ret += m_main_clusterset.m_clusters[int(quality)].size();
+    }
+    return ret;
+}
+
 void BlockBuilderImpl::Next() noexcept
 {
     // Don't do anything if we're already done.
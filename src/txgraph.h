@@ -107,6 +107,38 @@ public:
      *  be invoked while oversized, but oversized graphs will be skipped by this call. */
     virtual bool DoWork(uint64_t max_cost) noexcept = 0;
 
+    /** Interface returned by GetLinearizationJob. */
+    class LinearizationJob
+    {
+    protected:
+        /** Make constructor non-public (use TxGraph::GetLinearizationJob()). */
+        LinearizationJob() noexcept = default;
+    public:
+        /** Support safe inheritance. */
+        virtual ~LinearizationJob() = default;
+        /** Linearize the snapshotted cluster, performing up to max_cost work. This only accesses
+         *  the job itself, so it can be invoked without any synchronization with the TxGraph.
+         *  Returns the amount of work performed, and whether the result is optimal. */
+        virtual std::pair<uint64_t, bool> Run(uint64_t max_cost) noexcept = 0;
+    };
+
+    /** Construct a job for improving the linearization of a non-optimal cluster in the main
+     *  graph, as an alternative to DoWork which moves the actual linearization work out of the
+     *  TxGraph. The job holds a snapshot of the cluster, so it can be Run() on another thread
+     *  while the TxGraph is being used and modified, and then handed back to
+     *  ApplyLinearizationJob. Returns nullptr if main is oversized, has observers, or all its
+     *  clusters are optimal already. The returned object may outlive the TxGraph. */
+    virtual std::unique_ptr<LinearizationJob> GetLinearizationJob() noexcept = 0;
+    /** Replace the linearization of the cluster a job (created by this TxGraph's
+     *  GetLinearizationJob, and Run() since) was created for, with the job's result. This only
+     *  happens if the cluster still exists in main unmodified and its linearization was not
+     *  changed since, and main has no observers; otherwise the result is discarded. Returns
+     *  whether the result was applied. */
+    virtual bool ApplyLinearizationJob(LinearizationJob& job) noexcept = 0;
+    /** Get the number of clusters in the main graph whose linearization is not known to be
+     *  optimal. Clusters resulting from not yet applied dependencies are not included. */
+    virtual GraphIndex GetMainNonOptimalClusterCount() noexcept = 0;
+
     /** Create a staging graph (which cannot exist already). This acts as if a full copy of
      *  the transaction graph is made, upon which further modifications are made. This copy can
      *  be inspected, and then either discarded, or the main graph can be replaced by it by
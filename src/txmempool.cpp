@@ -21,12 +21,14 @@
 #include <util/moneystr.h>
 #include <util/overflow.h>
 #include <util/result.h>
+#include <util/threadnames.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <util/translation.h>
 #include <validationinterface.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <numeric>
 #include <optional>
@@ -185,6 +187,63 @@ CTxMemPool::CTxMemPool(Options opts, bilingual_str& error)
             const Txid& txid_b = static_cast<const CTxMemPoolEntry&>(b).GetTx().GetHash();
             return txid_a <=> txid_b;
         });
+    if (m_opts.background_linearization) {
+        m_background_linearization_thread = std::thread{[this] { BackgroundLinearizationThread(); }};
+    }
+}
+
+CTxMemPool::~CTxMemPool()
+{
+    if (m_background_linearization_thread.joinable()) {
+        WITH_LOCK(m_background_linearization_mutex, m_background_linearization_interrupt = true);
+        m_background_linearization_cv.notify_one();
+        m_background_linearization_thread.join();
+    }
+}
+
+void CTxMemPool::LinearizeAfterChange(std::string_view change)
+{
+    AssertLockHeld(cs);
+    if (m_background_linearization_thread.joinable()) {
+        WITH_LOCK(m_background_linearization_mutex, m_background_linearization_pending = true);
+        m_background_linearization_cv.notify_one();
+    } else if (!m_txgraph->DoWork(/*max_cost=*/POST_CHANGE_COST)) {
+        LogDebug(BCLog::MEMPOOL, "Mempool in non-optimal ordering after %s.", change);
+    }
+}
+
+void CTxMemPool::BackgroundLinearizationThread()
+{
+    util::ThreadRename("linearize");
+    while (true) {
+        {
+            WAIT_LOCK(m_background_linearization_mutex, lock);
+            m_background_linearization_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_background_linearization_mutex) {
+                return m_background_linearization_interrupt || m_background_linearization_pending;
+            });
+            if (m_background_linearization_interrupt) return;
+            m_background_linearization_pending = false;
+        }
+        // Linearize clusters on snapshots taken from the TxGraph, so that mempool.cs is only held
+        // while creating and applying the jobs. Results are discarded if the cluster changed in
+        // the meantime.
+        uint64_t cost_done{0};
+        while (cost_done < BACKGROUND_CHANGE_COST) {
+            if (WITH_LOCK(m_background_linearization_mutex, return m_background_linearization_interrupt)) return;
+            std::unique_ptr<TxGraph::LinearizationJob> job{WITH_LOCK(cs, return m_txgraph->GetLinearizationJob())};
+            if (!job) break;
+            const auto start{SteadyClock::now()};
+            const uint64_t cost{job->Run(BACKGROUND_JOB_COST).first};
+            const auto duration{SteadyClock::now() - start};
+            // Count jobs that did no work too, so this loop always ends.
+            cost_done += std::max<uint64_t>(cost, 1);
+            LOCK(cs);
+            const bool applied{m_txgraph->ApplyLinearizationJob(*job)};
+            ++m_background_linearization_stats.jobs;
+            if (!applied) ++m_background_linearization_stats.discarded;
+            m_background_linearization_stats.duration += std::chrono::duration_cast<std::chrono::microseconds>(duration);
+        }
+    }
 }
 
 bool CTxMemPool::isSpent(const COutPoint& outpoint) const
@@ -221,9 +280,7 @@ void CTxMemPool::Apply(ChangeSet* changeset)
 
         addNewTransaction(it);
     }
-    if (!m_txgraph->DoWork(/*max_cost=*/POST_CHANGE_COST)) {
-        LogDebug(BCLog::MEMPOOL, "Mempool in non-optimal ordering after addition(s).");
-    }
+    LinearizeAfterChange("addition(s)");
 }
 
 void CTxMemPool::addNewTransaction(CTxMemPool::txiter newit)
@@ -380,9 +437,7 @@ void CTxMemPool::removeForReorg(CChain& chain, std::function<bool(txiter)> check
     for (indexed_transaction_set::const_iterator it = mapTx.begin(); it != mapTx.end(); it++) {
         assert(TestLockPointValidity(chain, it->GetLockPoints()));
     }
-    if (!m_txgraph->DoWork(/*max_cost=*/POST_CHANGE_COST)) {
-        LogDebug(BCLog::MEMPOOL, "Mempool in non-optimal ordering after reorg.");
-    }
+    LinearizeAfterChange("reorg");
 }
 
 void CTxMemPool::removeConflicts(const CTransaction &tx)
@@ -425,9 +480,7 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
     }
     lastRollingFeeUpdate = GetTime();
     blockSinceLastRollingFeeBump = true;
-    if (!m_txgraph->DoWork(/*max_cost=*/POST_CHANGE_COST)) {
-        LogDebug(BCLog::MEMPOOL, "Mempool in non-optimal ordering after block.");
-    }
+    LinearizeAfterChange("block");
 }
 
 void CTxMemPool::check(const CCoinsViewCache& active_coins_tip, int64_t spendheight) const
@@ -777,8 +830,14 @@ void CCoinsViewMemPool::Reset()
 
 size_t CTxMemPool::DynamicMemoryUsage() const {
     LOCK(cs);
-    // Estimate the overhead of mapTx to be 9 pointers (3 pointers per index) + an allocation, as no exact formula for boost::multi_index_contained is implemented.
-    return memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 9 * sizeof(void*)) * mapTx.size() + memusage::DynamicUsage(mapNextTx) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(txns_randomized) + m_txgraph->GetMainMemoryUsage() + cachedInnerUsage;
+    // Estimate the size of a mapTx node to be 9 pointers (3 pointers per index) + an entry, as no exact formula for
+    // boost::multi_index_contained is implemented. The nodes come from the memory arena, without allocation overhead.
+    return MAX_NODE_BYTES * mapTx.size() + memusage::DynamicUsage(mapNextTx) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(txns_randomized) + m_txgraph->GetMainMemoryUsage() + cachedInnerUsage;
+}
+
+size_t CTxMemPool::AllocatedMemoryUsage() const {
+    LOCK(cs);
+    return memusage::DynamicUsage(m_memory_resource) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(txns_randomized) + m_txgraph->GetMainMemoryUsage() + cachedInnerUsage;
 }
 
 void CTxMemPool::RemoveUnbroadcastTx(const Txid& txid, const bool unchecked) {
@@ -18,6 +18,7 @@
 #include <policy/packages.h>
 #include <primitives/transaction.h>
 #include <primitives/transaction_identifier.h>
+#include <support/allocators/pool.h>
 #include <sync.h>
 #include <txgraph.h>
 #include <util/feefrac.h>
@@ -32,12 +33,16 @@
 #include <boost/multi_index/tag.hpp>
 #include <boost/multi_index_container.hpp>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <map>
 #include <optional>
 #include <set>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -57,6 +62,14 @@ static constexpr uint64_t ACCEPTABLE_COST = 75'000;
  * due to a changeset being applied, a new block being found, or a reorg). */
 static constexpr uint64_t POST_CHANGE_COST = 5 * ACCEPTABLE_COST;
 
+/** How much work the background linearization thread (see
+ * -mempoolbackgroundlinearization) spends on a single cluster at a time. */
+static constexpr uint64_t BACKGROUND_JOB_COST = 4 * ACCEPTABLE_COST;
+
+/** How much work the background linearization thread does after a mempool
+ * change, before waiting for the next one. */
+static constexpr uint64_t BACKGROUND_CHANGE_COST = 20 * POST_CHANGE_COST;
+
 /**
  * Test whether the LockPoints height and time are still valid on the current chain
  */
@@ -207,10 +220,50 @@ protected:
 
     CFeeRate GetMinFee(size_t sizelimit) const;
 
+public:
+    /** Statistics of the background linearization thread. */
+    struct BackgroundLinearizationStats {
+        //! Number of linearization jobs run.
+        uint64_t jobs{0};
+        //! Number of job results discarded, because the cluster changed while the job was running.
+        uint64_t discarded{0};
+        //! Total time spent running jobs.
+        std::chrono::microseconds duration{0};
+    };
+
+protected:
+    BackgroundLinearizationStats m_background_linearization_stats GUARDED_BY(cs);
+
+    Mutex m_background_linearization_mutex;
+    std::condition_variable m_background_linearization_cv;
+    //! Whether the mempool changed since the background linearization thread last started working.
+    bool m_background_linearization_pending GUARDED_BY(m_background_linearization_mutex){false};
+    bool m_background_linearization_interrupt GUARDED_BY(m_background_linearization_mutex){false};
+    std::thread m_background_linearization_thread;
+
+    /** Improve cluster linearizations after the mempool changed, either by doing a bounded amount
+     *  of work right away, or by waking up the background linearization thread. */
+    void LinearizeAfterChange(std::string_view change) EXCLUSIVE_LOCKS_REQUIRED(cs, !m_background_linearization_mutex);
+    /** Body of the background linearization thread. */
+    void BackgroundLinearizationThread() EXCLUSIVE_LOCKS_REQUIRED(!m_background_linearization_mutex);
+
 public:
 
     static const int ROLLING_FEE_HALFLIFE = 60 * 60 * 12; // public only for testing
 
+    /**
+     * The nodes of mapTx and mapNextTx are allocated from a memory arena in
+     * large chunks, instead of one by one. This avoids the per-allocation
+     * overhead and heap fragmentation of millions of small allocations. The
+     * largest nodes are those of mapTx, which hold a CTxMemPoolEntry and the
+     * pointers of its 3 indexes.
+     */
+    static constexpr size_t MAX_NODE_BYTES{sizeof(CTxMemPoolEntry) + 9 * sizeof(void*)};
+    static constexpr size_t NODE_ALIGN_BYTES{std::max(alignof(CTxMemPoolEntry), alignof(void*))};
+    using MemoryResource = PoolResource<MAX_NODE_BYTES, NODE_ALIGN_BYTES>;
+    template <typename T>
+    using NodeAllocator = PoolAllocator<T, MAX_NODE_BYTES, NODE_ALIGN_BYTES>;
+
     using indexed_transaction_set = boost::multi_index_container<
         CTxMemPoolEntry,
         boost::multi_index::indexed_by<
@@ -228,7 +281,8 @@ public:
                 boost::multi_index::identity<CTxMemPoolEntry>,
                 CompareTxMemPoolEntryByEntryTime
             >
-        >
+        >,
+        NodeAllocator<CTxMemPoolEntry>
     >;
 
     /**
@@ -258,7 +312,9 @@ public:
     mutable RecursiveMutex cs ACQUIRED_AFTER(::cs_main);
     std::unique_ptr<TxGraph> m_txgraph GUARDED_BY(cs);
     mutable std::unique_ptr<TxGraph::BlockBuilder> m_builder GUARDED_BY(cs);
-    indexed_transaction_set mapTx GUARDED_BY(cs);
+    //! Memory arena for the nodes of mapTx and mapNextTx
+    MemoryResource m_memory_resource GUARDED_BY(cs);
+    indexed_transaction_set mapTx GUARDED_BY(cs){indexed_transaction_set::ctor_args_list{}, NodeAllocator<CTxMemPoolEntry>{&m_memory_resource}};
 
     using txiter = indexed_transaction_set::nth_index<0>::type::const_iterator;
     std::vector<std::pair<Wtxid, txiter>> txns_randomized GUARDED_BY(cs); //!< All transactions in mapTx with their wtxids, in arbitrary order
@@ -293,7 +349,7 @@ private:
     void removeConflicts(const CTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(cs);
 
 public:
-    indirectmap<COutPoint, txiter> mapNextTx GUARDED_BY(cs);
+    indirectmap<COutPoint, txiter, NodeAllocator<std::pair<const COutPoint* const, txiter>>> mapNextTx GUARDED_BY(cs){&m_memory_resource};
     std::map<Txid, CAmount> mapDeltas GUARDED_BY(cs);
 
     using Options = kernel::MemPoolOptions;
@@ -306,6 +362,7 @@ public:
      * in the pool.
      */
     explicit CTxMemPool(Options opts, bilingual_str& error);
+    ~CTxMemPool();
 
     /**
      * If sanity-checking is turned on, check makes sure the pool is
@@ -480,6 +537,15 @@ public:
      */
     void SetLoadTried(bool load_tried);
 
+    /** Whether cluster linearizations are improved on a background thread. */
+    bool HasBackgroundLinearization() const { return m_background_linearization_thread.joinable(); }
+
+    BackgroundLinearizationStats GetBackgroundLinearizationStats() const EXCLUSIVE_LOCKS_REQUIRED(cs)
+    {
+        AssertLockHeld(cs);
+        return m_background_linearization_stats;
+    }
+
     unsigned long size() const
     {
         LOCK(cs);
@@ -535,6 +601,12 @@ public:
     std::vector<TxMempoolInfo> infoAll() const;
 
     size_t DynamicMemoryUsage() const;
+    /**
+     * Like DynamicMemoryUsage(), but counting the whole memory arena the nodes of
+     * mapTx and mapNextTx are allocated from, including the space that is not in
+     * use. The arena does not shrink when transactions are removed.
+     */
+    size_t AllocatedMemoryUsage() const;
 
     /** Adds a transaction to the unbroadcast set */
     void AddUnbroadcastTx(const Txid& txid)
@@ -617,7 +689,11 @@ public:
      */
     class ChangeSet {
     public:
-        explicit ChangeSet(CTxMemPool* pool) : m_pool(pool) { m_pool->m_txgraph->StartStaging(); }
+        explicit ChangeSet(CTxMemPool* pool)
+            : m_pool(pool), m_to_add{indexed_transaction_set::ctor_args_list{}, NodeAllocator<CTxMemPoolEntry>{&pool->m_memory_resource}}
+        {
+            m_pool->m_txgraph->StartStaging();
+        }
         ~ChangeSet() EXCLUSIVE_LOCKS_REQUIRED(m_pool->cs) {
             AssertLockHeld(m_pool->cs);
             if (m_pool->m_txgraph->HaveStaging()) {
@@ -680,6 +680,14 @@ private:
     // only invoke this on transactions that have otherwise passed policy checks.
     bool PolicyScriptChecks(const ATMPArgs& args, Workspace& ws) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_pool.cs);
 
+    // Run the policy script checks of the given transactions on the script check queue,
+    // if it has worker threads and there are at least MIN_PARALLEL_MEMPOOL_SCRIPT_CHECK_INPUTS
+    // inputs. The queue is idle, as blocks are only connected under cs_main.
+    // Returns true if all checks were run and passed. Otherwise, PolicyScriptChecks()
+    // has to be called on each transaction to find the failure, which is cheap for the
+    // valid signatures that were cached.
+    bool ParallelPolicyScriptChecks(std::span<Workspace> workspaces) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_pool.cs);
+
     // Re-run the script checks, using consensus flags, and try to cache the
     // result in the scriptcache. This should be done after
     // PolicyScriptChecks(). This requires that all inputs either be in our
@@ -1152,6 +1160,26 @@ bool MemPoolAccept::PolicyScriptChecks(const ATMPArgs& args, Workspace& ws)
     return true;
 }
 
+bool MemPoolAccept::ParallelPolicyScriptChecks(std::span<Workspace> workspaces)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(m_pool.cs);
+    auto& queue{m_active_chainstate.m_chainman.GetCheckQueue()};
+    const size_t total_inputs{std::accumulate(workspaces.begin(), workspaces.end(), size_t{0},
+        [](size_t sum, const auto& ws) { return sum + ws.m_ptx->vin.size(); })};
+    if (!queue.HasThreads() || total_inputs < MIN_PARALLEL_MEMPOOL_SCRIPT_CHECK_INPUTS) return false;
+
+    CCheckQueueControl<CScriptCheck> control(queue);
+    for (Workspace& ws : workspaces) {
+        std::vector<CScriptCheck> checks;
+        if (!CheckInputScripts(*ws.m_ptx, ws.m_state, m_view, STANDARD_SCRIPT_VERIFY_FLAGS, true, false, ws.m_precomputed_txdata, GetValidationCache(), &checks)) {
+            return false;
+        }
+        control.Add(std::move(checks));
+    }
+    return !control.Complete().has_value();
+}
+
 bool MemPoolAccept::ConsensusScriptChecks(const ATMPArgs& args, Workspace& ws)
 {
     AssertLockHeld(cs_main);
@@ -1376,7 +1404,7 @@ MempoolAcceptResult MemPoolAccept::AcceptSingleTransactionInternal(const CTransa
 
     // Perform the inexpensive checks first and avoid hashing and signature verification unless
     // those checks pass, to mitigate CPU exhaustion denial-of-service attacks.
-    if (!PolicyScriptChecks(args, ws)) return MempoolAcceptResult::Failure(ws.m_state);
+    if (!ParallelPolicyScriptChecks({&ws, 1}) && !PolicyScriptChecks(args, ws)) return MempoolAcceptResult::Failure(ws.m_state);
 
     if (!ConsensusScriptChecks(args, ws)) return MempoolAcceptResult::Failure(ws.m_state);
 
@@ -1530,9 +1558,10 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptMultipleTransactionsInternal(con
         }
     }
 
+    const bool scripts_checked{ParallelPolicyScriptChecks(workspaces)};
     for (Workspace& ws : workspaces) {
         ws.m_package_feerate = package_feerate;
-        if (!PolicyScriptChecks(args, ws)) {
+        if (!scripts_checked && !PolicyScriptChecks(args, ws)) {
             // Exit early to avoid doing pointless work. Update the failed tx result; the rest are unfinished.
             package_state.Invalid(PackageValidationResult::PCKG_TX, "transaction failed");
             results.emplace(ws.m_ptx->GetWitnessHash(), MempoolAcceptResult::Failure(ws.m_state));
@@ -88,6 +88,9 @@ static const uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES{550_MiB};
 
 /** Maximum number of dedicated script-checking threads allowed */
 static constexpr int MAX_SCRIPTCHECK_THREADS{15};
+/** Minimum number of inputs of a transaction or package for its mempool policy
+ * script checks to be spread over the script-checking threads */
+static constexpr size_t MIN_PARALLEL_MEMPOOL_SCRIPT_CHECK_INPUTS{32};
 
 /** Current sync state passed to tip changed callbacks. */
 enum class SynchronizationState {
@@ -0,0 +1,233 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <wallet/chainnotifications.h>
+
+#include <interfaces/handler.h>
+#include <kernel/chain.h>
+#include <kernel/types.h>
+#include <primitives/block.h>
+#include <util/check.h>
+#include <wallet/wallet.h>
+
+#include <algorithm>
+#include <iterator>
+#include <unordered_set>
+#include <utility>
+
+namespace wallet {
+namespace {
+//! Add wallet to the wallets indexed under key, unless it is there already.
+template <typename Map, typename Key>
+void Index(Map& map, const Key& key, const CWallet* wallet)
+{
+    auto& wallets{map[key]};
+    if (std::ranges::find(wallets, wallet) == wallets.end()) wallets.push_back(wallet);
+}
+
+//! Remove the wallets in stale from every entry of map, dropping entries left empty.
+template <typename Map>
+void Unindex(Map& map, const std::unordered_set<const CWallet*>& stale)
+{
+    for (auto it{map.begin()}; it != map.end();) {
+        std::erase_if(it->second, [&](const CWallet* wallet) { return stale.contains(wallet); });
+        it = it->second.empty() ? map.erase(it) : std::next(it);
+    }
+}
+
+template <typename Map, typename Key>
+void Append(const Map& map, const Key& key, std::vector<const CWallet*>& found)
+{
+    const auto it{map.find(key)};
+    if (it != map.end()) found.insert(found.end(), it->second.begin(), it->second.end());
+}
+} // namespace
+
+std::unique_ptr<interfaces::Handler> ChainNotificationDispatcher::Register(const std::shared_ptr<CWallet>& wallet, std::span<const CScript> scripts, std::span<const Txid> txids, std::span<const COutPoint> spent)
+{
+    LOCK(m_mutex);
+    if (!m_handler) m_handler = m_chain.handleNotifications(shared_from_this());
+    // Entries left behind by an unloaded wallet at the same address must not be attributed to this one
+    if (m_stale.contains(wallet.get())) Purge();
+    m_wallets.emplace(wallet.get(), wallet);
+    IndexScripts(*wallet, scripts);
+    IndexTransactions(*wallet, txids, spent);
+    return interfaces::MakeCleanupHandler([self = shared_from_this(), wallet = wallet.get()] { self->Unregister(*wallet); });
+}
+
+void ChainNotificationDispatcher::Unregister(const CWallet& wallet)
+{
+    std::unique_ptr<interfaces::Handler> handler;
+    {
+        LOCK(m_mutex);
+        if (!m_wallets.erase(&wallet)) return;
+        if (m_wallets.empty()) {
+            m_scripts.clear();
+            m_scripts_filter.Reset(0);
+            m_txids.clear();
+            m_spent.clear();
+            m_stale.clear();
+            handler = std::move(m_handler);
+        } else {
+            // Removing the wallet's entries means walking the whole index, so only do that
+            // once as many wallets were unloaded as are still loaded. That keeps unloading
+            // all wallets at shutdown linear in the size of the index.
+            m_stale.insert(&wallet);
+            if (m_stale.size() >= m_wallets.size()) Purge();
+        }
+    }
+    // Disconnect outside of m_mutex, which notifications that are being delivered may be waiting for
+    if (handler) handler->disconnect();
+}
+
+void ChainNotificationDispatcher::Purge()
+{
+    AssertLockHeld(m_mutex);
+    Unindex(m_scripts, m_stale);
+    Unindex(m_txids, m_stale);
+    Unindex(m_spent, m_stale);
+    m_stale.clear();
+    // Scripts only disappear from the filter when it is rebuilt
+    m_scripts_filter.Reset(m_scripts.size());
+    for (const auto& [script, _] : m_scripts) m_scripts_filter.Insert(script);
+}
+
+void ChainNotificationDispatcher::AddScripts(const CWallet& wallet, std::span<const CScript> scripts)
+{
+    LOCK(m_mutex);
+    if (m_wallets.contains(&wallet)) IndexScripts(wallet, scripts);
+}
+
+void ChainNotificationDispatcher::AddTransactions(const CWallet& wallet, std::span<const Txid> txids, std::span<const COutPoint> spent)
+{
+    LOCK(m_mutex);
+    if (m_wallets.contains(&wallet)) IndexTransactions(wallet, txids, spent);
+}
+
+void ChainNotificationDispatcher::IndexScripts(const CWallet& wallet, std::span<const CScript> scripts)
+{
+    AssertLockHeld(m_mutex);
+    // Grow the prefilter geometrically, like CWallet does for its own script cache
+    const size_t needed{m_scripts.size() + scripts.size()};
+    if (needed > m_scripts_filter.Capacity()) {
+        m_scripts_filter.Reset(2 * needed);
+        for (const auto& [script, _] : m_scripts) m_scripts_filter.Insert(script);
+    }
+    for (const CScript& script : scripts) {
+        Index(m_scripts, script, &wallet);
+        m_scripts_filter.Insert(script);
+    }
+}
+
+void ChainNotificationDispatcher::IndexTransactions(const CWallet& wallet, std::span<const Txid> txids, std::span<const COutPoint> spent)
+{
+    AssertLockHeld(m_mutex);
+    for (const Txid& txid : txids) Index(m_txids, txid, &wallet);
+    for (const COutPoint& outpoint : spent) Index(m_spent, outpoint, &wallet);
+}
+
+void ChainNotificationDispatcher::Match(const CTransaction& tx, const std::unordered_map<Txid, Wallets, SaltedTxidHasher>* block_txids, Wallets& found) const
+{
+    AssertLockHeld(m_mutex);
+    // Outputs paying to a wallet, the checks done by CWallet::IsMine
+    for (const CTxOut& txout : tx.vout) {
+        if (m_scripts_filter.MayContain(txout.scriptPubKey)) Append(m_scripts, txout.scriptPubKey, found);
+    }
+    // A transaction the wallet already has, which may change state
+    Append(m_txids, tx.GetHash(), found);
+    if (tx.IsCoinBase()) return;
+    for (const CTxIn& txin : tx.vin) {
+        // Inputs spending a wallet transaction, as checked by CWallet::IsFromMe,
+        // and inputs conflicting with a wallet transaction's spends
+        Append(m_txids, txin.prevout.hash, found);
+        Append(m_spent, txin.prevout, found);
+        if (block_txids) Append(*block_txids, txin.prevout.hash, found);
+    }
+}
+
+std::vector<std::shared_ptr<CWallet>> ChainNotificationDispatcher::AllWallets() const
+{
+    LOCK(m_mutex);
+    std::vector<std::shared_ptr<CWallet>> wallets;
+    wallets.reserve(m_wallets.size());
+    for (const auto& [_, wallet] : m_wallets) wallets.push_back(wallet);
+    return wallets;
+}
+
+std::vector<std::shared_ptr<CWallet>> ChainNotificationDispatcher::WalletsFor(const CTransaction& tx) const
+{
+    LOCK(m_mutex);
+    Wallets found;
+    Match(tx, /*block_txids=*/nullptr, found);
+    std::ranges::sort(found);
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+    std::vector<std::shared_ptr<CWallet>> wallets;
+    wallets.reserve(found.size());
+    for (const CWallet* wallet : found) {
+        // Skip wallets that were unloaded but not purged from the index yet
+        const auto it{m_wallets.find(wallet)};
+        if (it != m_wallets.end()) wallets.push_back(it->second);
+    }
+    return wallets;
+}
+
+std::vector<std::pair<std::shared_ptr<CWallet>, std::vector<size_t>>> ChainNotificationDispatcher::MatchBlock(const CBlock& block) const
+{
+    LOCK(m_mutex);
+    std::unordered_map<const CWallet*, std::vector<size_t>> matches;
+    // Transactions of this block matched so far. A later transaction spending one of
+    // them is relevant to the same wallets, even though the index does not know the
+    // earlier one yet because the wallets only add it once they process the block.
+    std::unordered_map<Txid, Wallets, SaltedTxidHasher> block_txids;
+    Wallets found;
+    for (size_t index = 0; index < block.vtx.size(); ++index) {
+        found.clear();
+        Match(*block.vtx[index], &block_txids, found);
+        for (const CWallet* wallet : found) {
+            auto& indexes{matches[wallet]};
+            if (!indexes.empty() && indexes.back() == index) continue;
+            indexes.push_back(index);
+            Index(block_txids, block.vtx[index]->GetHash(), wallet);
+        }
+    }
+    std::vector<std::pair<std::shared_ptr<CWallet>, std::vector<size_t>>> ret;
+    ret.reserve(m_wallets.size());
+    for (const auto& [ptr, wallet] : m_wallets) {
+        auto it{matches.find(ptr)};
+        ret.emplace_back(wallet, it != matches.end() ? std::move(it->second) : std::vector<size_t>{});
+    }
+    return ret;
+}
+
+void ChainNotificationDispatcher::transactionAddedToMempool(const CTransactionRef& tx)
+{
+    for (const auto& wallet : WalletsFor(*tx)) wallet->transactionAddedToMempool(tx);
+}
+
+void ChainNotificationDispatcher::transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason)
+{
+    for (const auto& wallet : WalletsFor(*tx)) wallet->transactionRemovedFromMempool(tx, reason);
+}
+
+void ChainNotificationDispatcher::blockConnected(const kernel::ChainstateRole& role, const interfaces::BlockInfo& block)
+{
+    // Wallets ignore blocks connected to a background chainstate
+    if (role.historical) return;
+    for (const auto& [wallet, tx_indexes] : MatchBlock(*Assert(block.data))) {
+        wallet->ConnectBlock(role, block, tx_indexes);
+    }
+}
+
+void ChainNotificationDispatcher::blockDisconnected(const interfaces::BlockInfo& block)
+{
+    for (const auto& [wallet, tx_indexes] : MatchBlock(*Assert(block.data))) {
+        wallet->DisconnectBlock(block, tx_indexes);
+    }
+}
+
+void ChainNotificationDispatcher::updatedBlockTip()
+{
+    for (const auto& wallet : AllWallets()) wallet->updatedBlockTip();
+}
+} // namespace wallet
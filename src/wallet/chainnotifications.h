@@ -0,0 +1,107 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_WALLET_CHAINNOTIFICATIONS_H
+#define BITCOIN_WALLET_CHAINNOTIFICATIONS_H
+
+#include <interfaces/chain.h>
+#include <primitives/transaction.h>
+#include <primitives/transaction_identifier.h>
+#include <script/script.h>
+#include <sync.h>
+#include <util/hasher.h>
+#include <wallet/scriptfilter.h>
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace interfaces {
+class Handler;
+} // namespace interfaces
+
+namespace wallet {
+class CWallet;
+
+/**
+ * Single chain notification handler shared by all wallets loaded in a node.
+ *
+ * Registering every wallet with the chain separately runs one callback per
+ * wallet for every block and mempool transaction, each scanning all outputs.
+ * Instead, the dispatcher keeps a combined index of what each wallet cares
+ * about: the scripts it watches, the transactions it holds and the outpoints
+ * those spend. A transaction is looked up against that index once, and only
+ * the wallets it is relevant to are notified. Block notifications still reach
+ * every wallet so it can advance its best block, but each wallet only scans
+ * the transactions that matched it.
+ *
+ * Wallets keep the index current by reporting newly cached scripts and newly
+ * added transactions. The index is conservative: entries are never removed
+ * while a wallet is registered, so stale entries only cost a spurious
+ * notification that the wallet then ignores. The entries of unloaded wallets
+ * are removed in batches.
+ */
+class ChainNotificationDispatcher final : public interfaces::Chain::Notifications, public std::enable_shared_from_this<ChainNotificationDispatcher>
+{
+public:
+    explicit ChainNotificationDispatcher(interfaces::Chain& chain) : m_chain{chain} {}
+
+    /**
+     * Start forwarding notifications to wallet, indexing the scripts, transactions and
+     * spent outpoints it has so far. The returned handler stops forwarding when
+     * disconnected.
+     */
+    std::unique_ptr<interfaces::Handler> Register(const std::shared_ptr<CWallet>& wallet, std::span<const CScript> scripts, std::span<const Txid> txids, std::span<const COutPoint> spent) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Notify wallet about transactions paying to any of scripts.
+    void AddScripts(const CWallet& wallet, std::span<const CScript> scripts) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    //! Notify wallet about transactions spending outputs of txids, or spending any of the spent outpoints.
+    void AddTransactions(const CWallet& wallet, std::span<const Txid> txids, std::span<const COutPoint> spent) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    void transactionAddedToMempool(const CTransactionRef& tx) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void blockConnected(const kernel::ChainstateRole& role, const interfaces::BlockInfo& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void blockDisconnected(const interfaces::BlockInfo& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void updatedBlockTip() override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    using Wallets = std::vector<const CWallet*>;
+
+    void Unregister(const CWallet& wallet) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    //! Remove the entries of the wallets in m_stale from the index.
+    void Purge() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void IndexScripts(const CWallet& wallet, std::span<const CScript> scripts) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    void IndexTransactions(const CWallet& wallet, std::span<const Txid> txids, std::span<const COutPoint> spent) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    std::vector<std::shared_ptr<CWallet>> AllWallets() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    std::vector<std::shared_ptr<CWallet>> WalletsFor(const CTransaction& tx) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /**
+     * Match every transaction of block, in order, also following spends of earlier matched
+     * transactions in the block. Returns every registered wallet with the indexes of the
+     * transactions relevant to it.
+     */
+    std::vector<std::pair<std::shared_ptr<CWallet>, std::vector<size_t>>> MatchBlock(const CBlock& block) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Append the wallets tx is relevant to, as far as the index and block_txids tell, to found. */
+    void Match(const CTransaction& tx, const std::unordered_map<Txid, Wallets, SaltedTxidHasher>* block_txids, Wallets& found) const EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+
+    interfaces::Chain& m_chain;
+
+    mutable Mutex m_mutex;
+    //! Chain registration, held while any wallet is registered.
+    std::unique_ptr<interfaces::Handler> m_handler GUARDED_BY(m_mutex);
+    std::unordered_map<const CWallet*, std::shared_ptr<CWallet>> m_wallets GUARDED_BY(m_mutex);
+    std::unordered_map<CScript, Wallets, SaltedSipHasher> m_scripts GUARDED_BY(m_mutex);
+    //! Prefilter over the keys of m_scripts, so outputs paying to no loaded wallet are rejected without probing the map
+    ScriptPubKeyFilter m_scripts_filter GUARDED_BY(m_mutex);
+    std::unordered_map<Txid, Wallets, SaltedTxidHasher> m_txids GUARDED_BY(m_mutex);
+    std::unordered_map<COutPoint, Wallets, SaltedOutpointHasher> m_spent GUARDED_BY(m_mutex);
+    //! Unregistered wallets that may still have entries in the index. Lookups ignore them.
+    std::unordered_set<const CWallet*> m_stale GUARDED_BY(m_mutex);
+};
+} // namespace wallet
+
+#endif // BITCOIN_WALLET_CHAINNOTIFICATIONS_H
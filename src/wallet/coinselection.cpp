@@ -85,13 +85,23 @@ struct {
  * @param const CAmount& cost_of_change This is the cost of creating and spending a change output.
  *        This plus selection_target is the upper bound of the range.
  * @param int max_selection_weight The maximum allowed weight for a selection result to be valid.
+ * @param const SelectionInterrupt* interrupt Optionally stops the search early, keeping the best solution found so far.
  * @returns The result of this coin selection algorithm, or std::nullopt
  */
 
 static const size_t TOTAL_TRIES = 100000;
 
+//! How many search steps to take between checks of a SelectionInterrupt, which reads the clock.
+static constexpr size_t INTERRUPT_CHECK_INTERVAL{1024};
+
+/** Check the interrupt on every INTERRUPT_CHECK_INTERVAL-th search step, starting with the first one (step 0). */
+static bool IsInterrupted(const SelectionInterrupt* interrupt, size_t step, bool has_solution)
+{
+    return interrupt && step % INTERRUPT_CHECK_INTERVAL == 0 && (*interrupt)(has_solution);
+}
+
 util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, const CAmount& cost_of_change,
-                                             int max_selection_weight)
+                                             int max_selection_weight, const SelectionInterrupt* interrupt)
 {
     SelectionResult result(selection_target, SelectionAlgorithm::BNB);
     CAmount curr_value = 0;
@@ -121,7 +131,12 @@ util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool
     bool max_tx_weight_exceeded = false;
 
     // Depth First search loop for choosing the UTXOs
+    bool interrupted = false;
     for (size_t curr_try = 0, utxo_pool_index = 0; curr_try < TOTAL_TRIES; ++curr_try, ++utxo_pool_index) {
+        if (IsInterrupted(interrupt, curr_try, !best_selection.empty())) {
+            interrupted = true;
+            break;
+        }
         // Conditions for starting a backtrack
         bool backtrack = false;
         if (curr_value + curr_available_value < selection_target || // Cannot possibly reach target with the amount remaining in the curr_available_value.
@@ -196,6 +211,7 @@ util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool
     }
     result.RecalculateWaste(cost_of_change, cost_of_change, CAmount{0});
     assert(best_waste == result.GetWaste());
+    if (interrupted) result.SetAlgoCompleted(false);
 
     return result;
 }
@@ -322,7 +338,8 @@ util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool
  * @param int max_selection_weight The maximum allowed weight for a selection result to be valid.
  * @returns The result of this coin selection algorithm, or std::nullopt
  */
-util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight)
+util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight,
+                                          const SelectionInterrupt* interrupt)
 {
     std::sort(utxo_pool.begin(), utxo_pool.end(), descending_effval_weight);
     // The sum of UTXO amounts after this UTXO index, e.g. lookahead[5] = Σ(UTXO[6+].amount)
@@ -463,8 +480,8 @@ util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, c
             }
         }
 
-        if (curr_try >= TOTAL_TRIES) {
-            // Solution is not guaranteed to be optimal if `curr_try` hit TOTAL_TRIES
+        if (curr_try >= TOTAL_TRIES || IsInterrupted(interrupt, curr_try - 1, !best_selection.empty())) {
+            // Solution is not guaranteed to be optimal if `curr_try` hit TOTAL_TRIES or the search was interrupted
             result.SetAlgoCompleted(false);
             break;
         }
@@ -597,11 +614,13 @@ util::Result<SelectionResult> SelectCoinsSRD(const std::vector<OutputGroup>& utx
  *                              entry is true, that means the ith group in groups was selected.
  * @param[out]  nBest           Total amount of subset chosen that is closest to nTargetValue.
  * @param[in]   max_selection_weight  The maximum allowed weight for a selection result to be valid.
+ * @param[in]   interrupt       Optionally stops the approximation early, keeping the best subset found so far.
  * @param[in]   iterations      Maximum number of tries.
  */
 static void ApproximateBestSubset(FastRandomContext& insecure_rand, const std::vector<OutputGroup>& groups,
                                   const CAmount& nTotalLower, const CAmount& nTargetValue,
-                                  std::vector<char>& vfBest, CAmount& nBest, int max_selection_weight, int iterations = 1000)
+                                  std::vector<char>& vfBest, CAmount& nBest, int max_selection_weight,
+                                  const SelectionInterrupt* interrupt, int iterations = 1000)
 {
     std::vector<char> vfIncluded;
 
@@ -609,7 +628,7 @@ static void ApproximateBestSubset(FastRandomContext& insecure_rand, const std::v
     vfBest.assign(groups.size(), true);
     nBest = nTotalLower;
 
-    for (int nRep = 0; nRep < iterations && nBest != nTargetValue; nRep++)
+    for (int nRep = 0; nRep < iterations && nBest != nTargetValue && !(interrupt && (*interrupt)(/*has_solution=*/nRep > 0)); nRep++)
     {
         vfIncluded.assign(groups.size(), false);
         CAmount nTotal = 0;
@@ -650,7 +669,8 @@ static void ApproximateBestSubset(FastRandomContext& insecure_rand, const std::v
 }
 
 util::Result<SelectionResult> KnapsackSolver(std::vector<OutputGroup>& groups, const CAmount& nTargetValue,
-                                             CAmount change_target, FastRandomContext& rng, int max_selection_weight)
+                                             CAmount change_target, FastRandomContext& rng, int max_selection_weight,
+                                             const SelectionInterrupt* interrupt)
 {
     SelectionResult result(nTargetValue, SelectionAlgorithm::KNAPSACK);
 
@@ -705,9 +725,9 @@ util::Result<SelectionResult> KnapsackSolver(std::vector<OutputGroup>& groups, c
     std::vector<char> vfBest;
     CAmount nBest;
 
-    ApproximateBestSubset(rng, applicable_groups, nTotalLower, nTargetValue, vfBest, nBest, max_selection_weight);
+    ApproximateBestSubset(rng, applicable_groups, nTotalLower, nTargetValue, vfBest, nBest, max_selection_weight, interrupt);
     if (nBest != nTargetValue && nTotalLower >= nTargetValue + change_target) {
-        ApproximateBestSubset(rng, applicable_groups, nTotalLower, nTargetValue + change_target, vfBest, nBest, max_selection_weight);
+        ApproximateBestSubset(rng, applicable_groups, nTotalLower, nTargetValue + change_target, vfBest, nBest, max_selection_weight, interrupt);
     }
 
     // If we have a bigger coin and (either the stochastic approximation didn't find a good solution,
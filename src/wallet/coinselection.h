@@ -15,8 +15,11 @@
 #include <util/insert.h>
 #include <util/result.h>
 
+#include <atomic>
+#include <chrono>
 #include <optional>
 
+class ThreadPool;
 
 namespace wallet {
 //! lower bound for randomly-chosen target change amount
@@ -174,6 +177,12 @@ struct CoinSelectionParams {
     uint32_t m_version{CTransaction::CURRENT_VERSION};
     /** The maximum weight for this transaction. */
     std::optional<int> m_max_tx_weight{std::nullopt};
+    /** Pool the selection algorithms may run on concurrently with the calling thread. Without one,
+     * they run one after another. */
+    ThreadPool* m_selection_pool{nullptr};
+    /** Wall-clock budget shared by the selection algorithms of one attempt. Once it is spent, every
+     * algorithm still running returns the best solution it has found so far, or the first one it finds. */
+    std::optional<std::chrono::milliseconds> m_selection_timeout{std::nullopt};
 
     CoinSelectionParams(FastRandomContext& rng_fast, int change_output_size, int change_spend_size,
                         CAmount min_change_target, CFeeRate effective_feerate,
@@ -320,6 +329,30 @@ enum class SelectionAlgorithm : uint8_t
 
 std::string GetAlgorithmName(SelectionAlgorithm algo);
 
+/** Stops a running coin selection algorithm early, so that it returns the best solution it has found
+ * so far. Triggers when Cancel() is called, possibly from another thread, or once the deadline passes
+ * and the algorithm has a solution to return, so that running out of time never makes selection fail. */
+class SelectionInterrupt
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit SelectionInterrupt(std::optional<Clock::time_point> deadline = std::nullopt) : m_deadline{deadline} {}
+
+    void Cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+
+    bool Cancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+    bool operator()(bool has_solution) const
+    {
+        return Cancelled() || (has_solution && m_deadline && Clock::now() >= *m_deadline);
+    }
+
+private:
+    std::atomic<bool> m_cancelled{false};
+    const std::optional<Clock::time_point> m_deadline;
+};
+
 struct OutputPtrComparator {
     bool operator()(const std::shared_ptr<COutput>& a, const std::shared_ptr<COutput>& b) const {
         return *a < *b;
@@ -450,9 +483,10 @@ public:
 };
 
 util::Result<SelectionResult> SelectCoinsBnB(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, const CAmount& cost_of_change,
-                                             int max_selection_weight);
+                                             int max_selection_weight, const SelectionInterrupt* interrupt = nullptr);
 
-util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight);
+util::Result<SelectionResult> CoinGrinder(std::vector<OutputGroup>& utxo_pool, const CAmount& selection_target, CAmount change_target, int max_selection_weight,
+                                          const SelectionInterrupt* interrupt = nullptr);
 
 /** Select coins by Single Random Draw (SRD). SRD selects eligible OutputGroups from a shuffled
  * ordering until the effective value of the input set suffices to create the recipient outputs and a
@@ -473,7 +507,8 @@ util::Result<SelectionResult> SelectCoinsSRD(const std::vector<OutputGroup>& utx
 
 // Original coin selection algorithm as a fallback
 util::Result<SelectionResult> KnapsackSolver(std::vector<OutputGroup>& groups, const CAmount& nTargetValue,
-                                             CAmount change_target, FastRandomContext& rng, int max_selection_weight);
+                                             CAmount change_target, FastRandomContext& rng, int max_selection_weight,
+                                             const SelectionInterrupt* interrupt = nullptr);
 } // namespace wallet
 
 #endif // BITCOIN_WALLET_COINSELECTION_H
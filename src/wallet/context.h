@@ -20,6 +20,7 @@ class Wallet;
 } // namespace interfaces
 
 namespace wallet {
+class ChainNotificationDispatcher;
 class CWallet;
 using LoadWalletFn = std::function<void(std::unique_ptr<interfaces::Wallet> wallet)>;
 
@@ -42,6 +43,8 @@ struct WalletContext {
     Mutex wallets_mutex;
     std::vector<std::shared_ptr<CWallet>> wallets GUARDED_BY(wallets_mutex);
     std::list<LoadWalletFn> wallet_load_fns GUARDED_BY(wallets_mutex);
+    //! Chain notification handler shared by the wallets, created when the first one is attached to the chain
+    std::shared_ptr<ChainNotificationDispatcher> notification_dispatcher GUARDED_BY(wallets_mutex);
 
     //! Declare default constructor and destructor that are not inline, so code
     //! instantiating the WalletContext struct doesn't need to #include class
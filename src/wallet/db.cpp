@@ -10,6 +10,8 @@
 #include <wallet/db.h>
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <exception>
 #include <fstream>
 #include <string>
@@ -154,6 +156,9 @@ void ReadDatabaseArgs(const ArgsManager& args, DatabaseOptions& options)
 {
     // Override current options with args values, if any were specified
     options.use_unsafe_sync = args.GetBoolArg("-unsafesqlitesync", options.use_unsafe_sync);
+    if (const auto window{args.GetIntArg("-walletgroupcommit")}) {
+        options.group_commit_window = std::chrono::milliseconds{std::max<int64_t>(*window, 0)};
+    }
 }
 
 } // namespace wallet
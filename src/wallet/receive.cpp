@@ -242,51 +242,49 @@ bool CachedTxIsTrusted(const CWallet& wallet, const CWalletTx& wtx)
     return CachedTxIsTrusted(wallet, wtx, trusted_parents);
 }
 
-Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse, bool include_nonmempool)
+static Balance ComputeBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse, bool include_nonmempool) EXCLUSIVE_LOCKS_REQUIRED(wallet.cs_wallet)
 {
+    AssertLockHeld(wallet.cs_wallet);
     Balance ret;
     bool allow_used_addresses = !avoid_reuse || !wallet.IsWalletFlagSet(WALLET_FLAG_AVOID_REUSE);
-    {
-        LOCK(wallet.cs_wallet);
-        std::set<Txid> trusted_parents;
-        for (const auto& [outpoint, txo] : wallet.GetTXOs()) {
-            const CWalletTx& wtx = txo.GetWalletTx();
+    std::set<Txid> trusted_parents;
+    for (const auto& [outpoint, txo] : wallet.GetTXOs()) {
+        const CWalletTx& wtx = txo.GetWalletTx();
+
+        const bool is_trusted{CachedTxIsTrusted(wallet, wtx, trusted_parents)};
+        const int tx_depth{wallet.GetTxDepthInMainChain(wtx)};
+
+        bool nonmempool_spent = false;
+        switch (wallet.HowSpent(outpoint)) {
+        case CWallet::SpendType::CONFIRMED:
+        case CWallet::SpendType::MEMPOOL:
+            // treat as spent; ignore
+            break;
+        case CWallet::SpendType::NONMEMPOOL:
+            if (!include_nonmempool) break;
+            nonmempool_spent = true;
+            [[fallthrough]];
+        case CWallet::SpendType::UNSPENT:
+            CAmount* bucket = nullptr;
+
+            // Set the amounts in the return object
+            if (wallet.IsTxImmatureCoinBase(wtx) && wtx.isConfirmed()) {
+                bucket = &ret.m_mine_immature;
+            } else if (is_trusted && tx_depth >= min_depth) {
+                bucket = &ret.m_mine_trusted;
+            } else if (!is_trusted && wtx.InMempool()) {
+                bucket = &ret.m_mine_untrusted_pending;
+            }
+            if (bucket) {
+                // Get the amounts for mine
+                CAmount credit_mine = txo.GetTxOut().nValue;
 
-            const bool is_trusted{CachedTxIsTrusted(wallet, wtx, trusted_parents)};
-            const int tx_depth{wallet.GetTxDepthInMainChain(wtx)};
-
-            bool nonmempool_spent = false;
-            switch (wallet.HowSpent(outpoint)) {
-            case CWallet::SpendType::CONFIRMED:
-            case CWallet::SpendType::MEMPOOL:
-                // treat as spent; ignore
-                break;
-            case CWallet::SpendType::NONMEMPOOL:
-                if (!include_nonmempool) break;
-                nonmempool_spent = true;
-                [[fallthrough]];
-            case CWallet::SpendType::UNSPENT:
-                CAmount* bucket = nullptr;
-
-                // Set the amounts in the return object
-                if (wallet.IsTxImmatureCoinBase(wtx) && wtx.isConfirmed()) {
-                    bucket = &ret.m_mine_immature;
-                } else if (is_trusted && tx_depth >= min_depth) {
-                    bucket = &ret.m_mine_trusted;
-                } else if (!is_trusted && wtx.InMempool()) {
-                    bucket = &ret.m_mine_untrusted_pending;
+                if (!allow_used_addresses && wallet.IsSpentKey(txo.GetTxOut().scriptPubKey)) {
+                    bucket = &ret.m_mine_used;
                 }
-                if (bucket) {
-                    // Get the amounts for mine
-                    CAmount credit_mine = txo.GetTxOut().nValue;
-
-                    if (!allow_used_addresses && wallet.IsSpentKey(txo.GetTxOut().scriptPubKey)) {
-                        bucket = &ret.m_mine_used;
-                    }
-                    *bucket += credit_mine;
-                    if (nonmempool_spent) {
-                        ret.m_mine_nonmempool -= credit_mine;
-                    }
+                *bucket += credit_mine;
+                if (nonmempool_spent) {
+                    ret.m_mine_nonmempool -= credit_mine;
                 }
             }
         }
@@ -294,6 +292,21 @@ Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse,
     return ret;
 }
 
+Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse, bool include_nonmempool)
+{
+    LOCK(wallet.cs_wallet);
+    if (const Balance* cached{wallet.GetCachedBalance(min_depth, avoid_reuse, include_nonmempool)}) {
+        if constexpr (G_ABORT_ON_FAILED_ASSUME) {
+            // A stale entry means some wallet or chain state change missed InvalidateCachedBalances
+            Assume(*cached == ComputeBalance(wallet, min_depth, avoid_reuse, include_nonmempool));
+        }
+        return *cached;
+    }
+    const Balance ret{ComputeBalance(wallet, min_depth, avoid_reuse, include_nonmempool)};
+    wallet.CacheBalance(min_depth, avoid_reuse, include_nonmempool, ret);
+    return ret;
+}
+
 std::map<CTxDestination, CAmount> GetAddressBalances(const CWallet& wallet)
 {
     std::map<CTxDestination, CAmount> balances;
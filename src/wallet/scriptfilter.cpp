@@ -0,0 +1,72 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <wallet/scriptfilter.h>
+
+#include <crypto/siphash.h>
+#include <random.h>
+#include <util/fastrange.h>
+
+#include <algorithm>
+
+namespace wallet {
+// Odd multipliers used to derive one bit position per word from a single
+// 32-bit key, as in the Parquet split block Bloom filter specification.
+static constexpr std::array<uint32_t, 8> BLOCK_SALTS{
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+};
+
+ScriptPubKeyFilter::ScriptPubKeyFilter() :
+    m_k0{FastRandomContext().rand64()},
+    m_k1{FastRandomContext().rand64()}
+{}
+
+void ScriptPubKeyFilter::Reset(size_t capacity)
+{
+    m_blocks.assign(std::max<size_t>(1, (capacity + ELEMENTS_PER_BLOCK - 1) / ELEMENTS_PER_BLOCK), Block{});
+}
+
+uint64_t ScriptPubKeyFilter::Hash(std::span<const unsigned char> script) const
+{
+    return CSipHasher(m_k0, m_k1).Write(script).Finalize();
+}
+
+ScriptPubKeyFilter::Block ScriptPubKeyFilter::Mask(uint32_t key)
+{
+    Block mask;
+    for (size_t i{0}; i < WORDS_PER_BLOCK; ++i) {
+        mask[i] = uint32_t{1} << ((key * BLOCK_SALTS[i]) >> 27);
+    }
+    return mask;
+}
+
+size_t ScriptPubKeyFilter::BlockIndex(uint64_t hash) const
+{
+    return FastRange32(static_cast<uint32_t>(hash >> 32), static_cast<uint32_t>(m_blocks.size()));
+}
+
+void ScriptPubKeyFilter::Insert(std::span<const unsigned char> script)
+{
+    if (m_blocks.empty()) Reset(ELEMENTS_PER_BLOCK);
+    const uint64_t hash{Hash(script)};
+    Block& block{m_blocks[BlockIndex(hash)]};
+    const Block mask{Mask(static_cast<uint32_t>(hash))};
+    for (size_t i{0}; i < WORDS_PER_BLOCK; ++i) {
+        block[i] |= mask[i];
+    }
+}
+
+bool ScriptPubKeyFilter::MayContain(std::span<const unsigned char> script) const
+{
+    if (m_blocks.empty()) return false;
+    const uint64_t hash{Hash(script)};
+    const Block& block{m_blocks[BlockIndex(hash)]};
+    const Block mask{Mask(static_cast<uint32_t>(hash))};
+    for (size_t i{0}; i < WORDS_PER_BLOCK; ++i) {
+        if ((block[i] & mask[i]) == 0) return false;
+    }
+    return true;
+}
+} // namespace wallet
@@ -0,0 +1,60 @@
+// Copyright (c) 2026-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_WALLET_SCRIPTFILTER_H
+#define BITCOIN_WALLET_SCRIPTFILTER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace wallet {
+/**
+ * Split block Bloom filter over scriptPubKeys.
+ *
+ * Answers "is this script possibly in the set?" with no false negatives and a
+ * false positive rate of roughly 0.1% while the filter is within capacity.
+ * Every lookup touches a single 32-byte block, so a miss costs one cache line
+ * instead of a hash table probe, which matters for wallets whose script cache
+ * holds millions of entries.
+ *
+ * Elements can only be added. Once more than Capacity() elements have been
+ * inserted the false positive rate degrades, so callers are expected to Reset()
+ * with a larger capacity and insert everything again.
+ */
+class ScriptPubKeyFilter
+{
+public:
+    ScriptPubKeyFilter();
+
+    /** Drop all elements and size the filter for the given number of them. */
+    void Reset(size_t capacity);
+
+    /** Number of elements the filter can hold at its target false positive rate. */
+    size_t Capacity() const { return m_blocks.size() * ELEMENTS_PER_BLOCK; }
+
+    void Insert(std::span<const unsigned char> script);
+    bool MayContain(std::span<const unsigned char> script) const;
+
+private:
+    //! Bits set per element; one in each word of a block.
+    static constexpr size_t WORDS_PER_BLOCK{8};
+    //! 256-bit blocks at 16 elements each give 16 bits per element.
+    static constexpr size_t ELEMENTS_PER_BLOCK{16};
+
+    using Block = std::array<uint32_t, WORDS_PER_BLOCK>;
+
+    uint64_t Hash(std::span<const unsigned char> script) const;
+    static Block Mask(uint32_t key);
+    size_t BlockIndex(uint64_t hash) const;
+
+    /** Salt */
+    const uint64_t m_k0, m_k1;
+    std::vector<Block> m_blocks;
+};
+} // namespace wallet
+
+#endif // BITCOIN_WALLET_SCRIPTFILTER_H
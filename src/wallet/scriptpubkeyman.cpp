@@ -15,10 +15,13 @@
 #include <util/check.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <wallet/scriptpubkeyman.h>
 
+#include <algorithm>
+#include <future>
 #include <optional>
 
 using common::PSBTError;
@@ -998,6 +1001,44 @@ bool DescriptorScriptPubKeyMan::TopUp(unsigned int size)
     return res;
 }
 
+//! Fewest indexes worth handing to a thread of their own when topping up
+static constexpr int32_t MIN_TOPUP_INDEXES_PER_THREAD{250};
+
+namespace {
+/** Scripts and pubkeys derived for a run of consecutive descriptor indexes */
+struct ExpandedIndexes {
+    std::vector<std::vector<CScript>> scripts;
+    std::vector<std::vector<CPubKey>> pubkeys;
+    //! Cache items of the indexes that could not be expanded from the descriptor cache
+    DescriptorCache cache;
+    //! False if the run stopped early because an index could not be expanded
+    bool complete{true};
+};
+} // namespace
+
+static ExpandedIndexes ExpandIndexes(const WalletDescriptor& w_desc, const SigningProvider& provider, int32_t begin, int32_t end)
+{
+    ExpandedIndexes ret;
+    for (int32_t i = begin; i < end; ++i) {
+        FlatSigningProvider out_keys;
+        std::vector<CScript> scripts_temp;
+        // Maybe we have a cached xpub and we can expand from the cache first
+        if (!w_desc.descriptor->ExpandFromCache(i, w_desc.cache, scripts_temp, out_keys) &&
+            !w_desc.descriptor->ExpandFromCache(i, ret.cache, scripts_temp, out_keys)) {
+            DescriptorCache temp_cache;
+            if (!w_desc.descriptor->Expand(i, provider, scripts_temp, out_keys, &temp_cache)) {
+                ret.complete = false;
+                break;
+            }
+            ret.cache.MergeAndDiff(temp_cache);
+        }
+        std::vector<CPubKey>& pubkeys{ret.pubkeys.emplace_back()};
+        for (const auto& [_, pubkey] : out_keys.pubkeys) pubkeys.push_back(pubkey);
+        ret.scripts.push_back(std::move(scripts_temp));
+    }
+    return ret;
+}
+
 bool DescriptorScriptPubKeyMan::TopUpWithDB(WalletBatch& batch, unsigned int size)
 {
     LOCK(cs_desc_man);
@@ -1023,35 +1064,71 @@ bool DescriptorScriptPubKeyMan::TopUpWithDB(WalletBatch& batch, unsigned int siz
     provider.keys = GetKeys();
 
     uint256 id = GetID();
-    for (int32_t i = m_max_cached_index + 1; i < new_range_end; ++i) {
-        FlatSigningProvider out_keys;
-        std::vector<CScript> scripts_temp;
-        DescriptorCache temp_cache;
-        // Maybe we have a cached xpub and we can expand from the cache first
-        if (!m_wallet_descriptor.descriptor->ExpandFromCache(i, m_wallet_descriptor.cache, scripts_temp, out_keys)) {
-            if (!m_wallet_descriptor.descriptor->Expand(i, provider, scripts_temp, out_keys, &temp_cache)) return false;
-        }
-        // Add all of the scriptPubKeys to the scriptPubKey set
-        new_spks.insert(scripts_temp.begin(), scripts_temp.end());
-        for (const CScript& script : scripts_temp) {
-            m_map_script_pub_keys[script] = i;
-        }
-        for (const auto& pk_pair : out_keys.pubkeys) {
-            const CPubKey& pubkey = pk_pair.second;
-            if (m_map_pubkeys.contains(pubkey)) {
-                // We don't need to give an error here.
-                // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and its private key
-                continue;
+    // Cache items of all new indexes, written at once
+    DescriptorCache new_items;
+    const auto apply{[&](const ExpandedIndexes& run) EXCLUSIVE_LOCKS_REQUIRED(cs_desc_man) {
+        for (size_t k = 0; k < run.scripts.size(); ++k) {
+            const int32_t i{m_max_cached_index + 1};
+            // Add all of the scriptPubKeys to the scriptPubKey set
+            new_spks.insert(run.scripts[k].begin(), run.scripts[k].end());
+            for (const CScript& script : run.scripts[k]) {
+                m_map_script_pub_keys[script] = i;
             }
-            m_map_pubkeys[pubkey] = i;
+            for (const CPubKey& pubkey : run.pubkeys[k]) {
+                if (m_map_pubkeys.contains(pubkey)) {
+                    // We don't need to give an error here.
+                    // It doesn't matter which of many valid indexes the pubkey has, we just need an index where we can derive it and its private key
+                    continue;
+                }
+                m_map_pubkeys[pubkey] = i;
+            }
+            m_max_cached_index++;
+        }
+        new_items.MergeAndDiff(m_wallet_descriptor.cache.MergeAndDiff(run.cache));
+        return run.complete;
+    }};
+
+    // Derive the first new index on its own, so that the others can be expanded from the
+    // xpubs it caches. Derive the rest on up to TopUpThreads() threads, each taking a run of
+    // consecutive indexes, and apply the runs in index order.
+    bool complete{true};
+    const int32_t begin{m_max_cached_index + 1};
+    if (begin < new_range_end) {
+        complete = apply(ExpandIndexes(m_wallet_descriptor, provider, begin, begin + 1));
+    }
+    const int32_t rest{new_range_end - begin - 1};
+    if (complete && rest > 0) {
+        const int threads{std::clamp<int>(rest / MIN_TOPUP_INDEXES_PER_THREAD, 1, m_storage.TopUpThreads())};
+        std::vector<ExpandedIndexes> runs(threads);
+        const WalletDescriptor& w_desc{m_wallet_descriptor};
+        const auto expand_run{[&](int t) {
+            runs[t] = ExpandIndexes(w_desc, provider, begin + 1 + int64_t{rest} * t / threads, begin + 1 + int64_t{rest} * (t + 1) / threads);
+        }};
+        if (threads > 1) {
+            ThreadPool pool{"topup"};
+            pool.Start(threads - 1);
+            std::vector<std::future<void>> futures;
+            for (int t = 1; t < threads; ++t) {
+                auto future{pool.Submit([&expand_run, t] { expand_run(t); })};
+                if (future) {
+                    futures.push_back(std::move(*future));
+                } else {
+                    expand_run(t);
+                }
+            }
+            expand_run(0);
+            for (auto& future : futures) future.get();
+        } else {
+            expand_run(0);
         }
-        // Merge and write the cache
-        DescriptorCache new_items = m_wallet_descriptor.cache.MergeAndDiff(temp_cache);
-        if (!batch.WriteDescriptorCacheItems(id, new_items)) {
-            throw std::runtime_error(std::string(__func__) + ": writing cache items failed");
+        for (const ExpandedIndexes& run : runs) {
+            if (!(complete = apply(run))) break;
         }
-        m_max_cached_index++;
     }
+    if (!batch.WriteDescriptorCacheItems(id, new_items)) {
+        throw std::runtime_error(std::string(__func__) + ": writing cache items failed");
+    }
+    if (!complete) return false;
     m_wallet_descriptor.range_end = new_range_end;
     batch.WriteDescriptor(GetID(), m_wallet_descriptor);
 
@@ -53,6 +53,8 @@ public:
     virtual bool IsLocked() const = 0;
     //! Callback function for after TopUp completes containing any scripts that were added by a SPKMan
     virtual void TopUpCallback(const std::set<CScript>&, ScriptPubKeyMan*) = 0;
+    //! Number of threads to derive new scriptPubKeys with when topping up
+    virtual int TopUpThreads() const = 0;
 };
 
 //! Constant representing an unknown spkm creation time
@@ -60,6 +62,8 @@ static constexpr int64_t UNKNOWN_TIME = std::numeric_limits<int64_t>::max();
 
 //! Default for -keypool
 static const unsigned int DEFAULT_KEYPOOL_SIZE = 1000;
+//! Default for -keypoolthreads
+static constexpr int DEFAULT_KEYPOOL_THREADS{4};
 
 std::vector<CKeyID> GetAffectedKeys(const CScript& spk, const SigningProvider& provider);
 
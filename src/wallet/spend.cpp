@@ -21,6 +21,8 @@
 #include <util/check.h>
 #include <util/moneystr.h>
 #include <util/rbf.h>
+#include <util/threadpool.h>
+#include <util/time.h>
 #include <util/trace.h>
 #include <util/translation.h>
 #include <wallet/coincontrol.h>
@@ -31,6 +33,9 @@
 #include <wallet/wallet.h>
 
 #include <cmath>
+#include <functional>
+#include <future>
+#include <list>
 
 using common::StringForFeeReason;
 using common::TransactionErrorString;
@@ -726,6 +731,49 @@ util::Result<SelectionResult> AttemptSelection(interfaces::Chain& chain, const C
     return util::Error();
 };
 
+namespace {
+/** One coin selection algorithm scheduled by ChooseSelectionResult, and its outcome once it has run. */
+struct SelectionRun {
+    using Select = std::function<util::Result<SelectionResult>(const SelectionInterrupt&)>;
+
+    SelectionRun(SelectionAlgorithm algo, Select select, std::optional<SelectionInterrupt::Clock::time_point> deadline)
+        : algo{algo}, select{std::move(select)}, interrupt{deadline} {}
+
+    const SelectionAlgorithm algo;
+    const Select select;
+    SelectionInterrupt interrupt;
+    std::optional<util::Result<SelectionResult>> result{};
+    std::chrono::microseconds duration{0};
+
+    void operator()()
+    {
+        // Skip algorithms that were cancelled before they got to start. Running out of time is
+        // not a reason to skip: every algorithm still gets the chance to return a first solution.
+        if (interrupt.Cancelled()) return;
+        const auto start{SteadyClock::now()};
+        result.emplace(select(interrupt));
+        duration = std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - start);
+    }
+};
+} // namespace
+
+//! Smallest number of output groups for which ChooseSelectionResult runs the algorithms concurrently.
+static constexpr size_t MIN_GROUPS_CONCURRENT_SELECTION{1000};
+
+/** Lower bound for the waste of any input set from these groups that pays for a change output. */
+static CAmount MinWasteWithChange(const std::vector<OutputGroup>& groups, const CoinSelectionParams& coin_selection_params)
+{
+    CAmount min_waste{coin_selection_params.m_cost_of_change};
+    for (const OutputGroup& group : groups) {
+        // Inputs only lower the waste below its change cost if they are cheaper to spend now than
+        // later, or if the discount for overlapping ancestry can cancel out their bump fees.
+        CAmount bump_fees{0};
+        for (const auto& output : group.m_outputs) bump_fees += output->ancestor_bump_fees;
+        min_waste += std::min<CAmount>(0, group.fee - group.long_term_fee - bump_fees);
+    }
+    return min_waste;
+}
+
 util::Result<SelectionResult> ChooseSelectionResult(interfaces::Chain& chain, const CAmount& nTargetValue, Groups& groups, const CoinSelectionParams& coin_selection_params)
 {
     // Vector of results. We will choose the best one based on waste.
@@ -746,38 +794,99 @@ util::Result<SelectionResult> ChooseSelectionResult(interfaces::Chain& chain, co
     if (max_selection_weight <= 0) {
         return util::Error{_("Maximum transaction weight is less than transaction weight without inputs")};
     }
+    // Deduct change weight for all algorithms but BnB, because they can create a change output
+    int change_outputs_weight = coin_selection_params.change_output_size * WITNESS_SCALE_FACTOR;
+    const int bnb_max_selection_weight{max_selection_weight};
+    max_selection_weight -= change_outputs_weight;
+
+    // The algorithms can run concurrently on large pools, which then requires each of them to work on
+    // its own copy of the groups it reorders and to draw from its own randomness.
+    const bool concurrent{coin_selection_params.m_selection_pool && groups.positive_group.size() + groups.mixed_group.size() >= MIN_GROUPS_CONCURRENT_SELECTION};
+    std::optional<FastRandomContext> knapsack_rng, srd_rng;
+    if (concurrent) {
+        knapsack_rng.emplace(coin_selection_params.rng_fast.rand256());
+        srd_rng.emplace(coin_selection_params.rng_fast.rand256());
+    }
+    FastRandomContext& knapsack_rng_ref{knapsack_rng ? *knapsack_rng : coin_selection_params.rng_fast};
+    FastRandomContext& srd_rng_ref{srd_rng ? *srd_rng : coin_selection_params.rng_fast};
+    std::optional<SelectionInterrupt::Clock::time_point> deadline;
+    if (coin_selection_params.m_selection_timeout) deadline = SelectionInterrupt::Clock::now() + *coin_selection_params.m_selection_timeout;
+
+    std::list<SelectionRun> runs;
+    SelectionRun* cg_run{nullptr};
+    SelectionRun* srd_run{nullptr};
+    std::vector<OutputGroup> bnb_pool, cg_pool;
 
     // SFFO frequently causes issues in the context of changeless input sets: skip BnB when SFFO is active
     if (!coin_selection_params.m_subtract_fee_outputs) {
-        if (auto bnb_result{SelectCoinsBnB(groups.positive_group, nTargetValue, coin_selection_params.m_cost_of_change, max_selection_weight)}) {
-            results.push_back(*bnb_result);
-        } else append_error(std::move(bnb_result));
-    }
+        if (concurrent) bnb_pool = groups.positive_group;
+        const CAmount min_waste_with_change{MinWasteWithChange(groups.positive_group, coin_selection_params)};
+        runs.emplace_back(SelectionAlgorithm::BNB, [&, pool = concurrent ? &bnb_pool : &groups.positive_group, min_waste_with_change](const SelectionInterrupt& interrupt) {
+            auto bnb_result{SelectCoinsBnB(*pool, nTargetValue, coin_selection_params.m_cost_of_change, bnb_max_selection_weight, &interrupt)};
+            // A changeless solution that is less wasteful than any input set paying for change can
+            // be, cannot lose against the algorithms that always create change: stop them.
+            if (bnb_result && bnb_result->GetWaste() < min_waste_with_change) {
+                if (cg_run) cg_run->interrupt.Cancel();
+                if (srd_run) srd_run->interrupt.Cancel();
+            }
+            return bnb_result;
+        }, deadline);
+    }
+
+    if (max_selection_weight >= 0) {
+        // The knapsack solver has some legacy behavior where it will spend dust outputs. We retain this behavior, so don't filter for positive only here.
+        runs.emplace_back(SelectionAlgorithm::KNAPSACK, [&](const SelectionInterrupt& interrupt) {
+            return KnapsackSolver(groups.mixed_group, nTargetValue, coin_selection_params.m_min_change_target, knapsack_rng_ref, max_selection_weight, &interrupt);
+        }, deadline);
+
+        if (coin_selection_params.m_effective_feerate > CFeeRate{3 * coin_selection_params.m_long_term_feerate}) { // Minimize input set for feerates of at least 3×LTFRE (default: 30 ṩ/vB+)
+            if (concurrent) cg_pool = groups.positive_group;
+            cg_run = &runs.emplace_back(SelectionAlgorithm::CG, [&, pool = concurrent ? &cg_pool : &groups.positive_group](const SelectionInterrupt& interrupt) {
+                auto cg_result{CoinGrinder(*pool, nTargetValue, coin_selection_params.m_min_change_target, max_selection_weight, &interrupt)};
+                if (cg_result) cg_result->RecalculateWaste(coin_selection_params.min_viable_change, coin_selection_params.m_cost_of_change, coin_selection_params.m_change_fee);
+                return cg_result;
+            }, deadline);
+        }
 
-    // Deduct change weight because remaining Coin Selection algorithms can create change output
-    int change_outputs_weight = coin_selection_params.change_output_size * WITNESS_SCALE_FACTOR;
-    max_selection_weight -= change_outputs_weight;
-    if (max_selection_weight < 0 && results.empty()) {
-        return util::Error{_("Maximum transaction weight is too low, can not accommodate change output")};
+        srd_run = &runs.emplace_back(SelectionAlgorithm::SRD, [&](const SelectionInterrupt&) {
+            return SelectCoinsSRD(groups.positive_group, nTargetValue, coin_selection_params.m_change_fee, srd_rng_ref, max_selection_weight);
+        }, deadline);
     }
 
-    // The knapsack solver has some legacy behavior where it will spend dust outputs. We retain this behavior, so don't filter for positive only here.
-    if (auto knapsack_result{KnapsackSolver(groups.mixed_group, nTargetValue, coin_selection_params.m_min_change_target, coin_selection_params.rng_fast, max_selection_weight)}) {
-        results.push_back(*knapsack_result);
-    } else append_error(std::move(knapsack_result));
+    if (concurrent && runs.size() > 1) {
+        // Hand all but the first algorithm to the pool, and run that one on this thread
+        std::vector<std::future<void>> futures;
+        for (auto it{std::next(runs.begin())}; it != runs.end(); ++it) {
+            auto future{coin_selection_params.m_selection_pool->Submit([&run = *it] { run(); })};
+            if (future) {
+                futures.push_back(std::move(*future));
+            } else {
+                (*it)();
+            }
+        }
+        runs.front()();
+        for (auto& future : futures) future.get();
+    } else {
+        for (SelectionRun& run : runs) run();
+    }
 
-    if (coin_selection_params.m_effective_feerate > CFeeRate{3 * coin_selection_params.m_long_term_feerate}) { // Minimize input set for feerates of at least 3×LTFRE (default: 30 ṩ/vB+)
-        if (auto cg_result{CoinGrinder(groups.positive_group, nTargetValue, coin_selection_params.m_min_change_target, max_selection_weight)}) {
-            cg_result->RecalculateWaste(coin_selection_params.min_viable_change, coin_selection_params.m_cost_of_change, coin_selection_params.m_change_fee);
-            results.push_back(*cg_result);
+    for (SelectionRun& run : runs) {
+        if (!run.result) {
+            LogDebug(BCLog::SELECTCOINS, "%s cancelled before it started\n", GetAlgorithmName(run.algo));
+            continue;
+        }
+        LogDebug(BCLog::SELECTCOINS, "%s %s in %dus%s\n", GetAlgorithmName(run.algo), *run.result ? "found a selection" : "failed",
+                 count_microseconds(run.duration), *run.result && !(*run.result)->GetAlgoCompleted() ? " (search incomplete)" : "");
+        if (*run.result) {
+            results.push_back(**run.result);
         } else {
-            append_error(std::move(cg_result));
+            append_error(std::move(*run.result));
         }
     }
 
-    if (auto srd_result{SelectCoinsSRD(groups.positive_group, nTargetValue, coin_selection_params.m_change_fee, coin_selection_params.rng_fast, max_selection_weight)}) {
-        results.push_back(*srd_result);
-    } else append_error(std::move(srd_result));
+    if (max_selection_weight < 0 && results.empty()) {
+        return util::Error{_("Maximum transaction weight is too low, can not accommodate change output")};
+    }
 
     if (results.empty()) {
         // No solution found, retrieve the first explicit error (if any).
@@ -1079,6 +1188,8 @@ static util::Result<CreatedTransactionResult> CreateTransactionInternal(
     coin_selection_params.m_include_unsafe_inputs = coin_control.m_include_unsafe_inputs;
     coin_selection_params.m_max_tx_weight = coin_control.m_max_tx_weight.value_or(MAX_STANDARD_TX_WEIGHT);
     coin_selection_params.m_version = coin_control.m_version;
+    coin_selection_params.m_selection_pool = wallet.GetCoinSelectionPool();
+    coin_selection_params.m_selection_timeout = wallet.m_coin_selection_timeout;
     int minimum_tx_weight = MIN_STANDARD_TX_NONWITNESS_SIZE * WITNESS_SCALE_FACTOR;
     if (coin_selection_params.m_max_tx_weight.value() < minimum_tx_weight || coin_selection_params.m_max_tx_weight.value() > MAX_STANDARD_TX_WEIGHT) {
         return util::Error{strprintf(_("Maximum transaction weight must be between %d and %d"), minimum_tx_weight, MAX_STANDARD_TX_WEIGHT)};
@@ -13,6 +13,7 @@
 #include <util/check.h>
 #include <util/fs_helpers.h>
 #include <util/strencodings.h>
+#include <util/thread.h>
 #include <util/translation.h>
 #include <wallet/db.h>
 
@@ -116,7 +117,7 @@ SQLiteDatabase::SQLiteDatabase(const fs::path& dir_path, const fs::path& file_pa
 {}
 
 SQLiteDatabase::SQLiteDatabase(const fs::path& dir_path, const fs::path& file_path, const DatabaseOptions& options, int additional_flags)
-    : WalletDatabase(), m_dir_path(dir_path), m_file_path(fs::PathToString(file_path)), m_write_semaphore(1), m_use_unsafe_sync(options.use_unsafe_sync)
+    : WalletDatabase(), m_dir_path(dir_path), m_file_path(fs::PathToString(file_path)), m_group_commit_window(options.group_commit_window), m_write_semaphore(1), m_use_unsafe_sync(options.use_unsafe_sync)
 {
     {
         LOCK(g_sqlite_mutex);
@@ -145,6 +146,10 @@ SQLiteDatabase::SQLiteDatabase(const fs::path& dir_path, const fs::path& file_pa
         Cleanup();
         throw;
     }
+
+    if (m_group_commit_window > 0ms) {
+        m_group_thread = std::thread(&util::TraceThread, "sqlitecommit", [this] { ThreadGroupCommit(); });
+    }
 }
 
 void SQLiteBatch::SetupSQLStatements()
@@ -177,6 +182,7 @@ void SQLiteDatabase::Cleanup() noexcept
 {
     AssertLockNotHeld(g_sqlite_mutex);
 
+    StopGroupCommit();
     Close();
 
     LOCK(g_sqlite_mutex);
@@ -345,6 +351,8 @@ void SQLiteDatabase::Open(int additional_flags)
 
 bool SQLiteDatabase::Rewrite()
 {
+    // VACUUM cannot run within a transaction
+    if (!FlushGroupCommit()) return false;
     // Rewrite the database using the VACUUM command: https://sqlite.org/lang_vacuum.html
     int ret = sqlite3_exec(m_db, "VACUUM", nullptr, nullptr, nullptr);
     return ret == SQLITE_OK;
@@ -352,6 +360,8 @@ bool SQLiteDatabase::Rewrite()
 
 bool SQLiteDatabase::Backup(const std::string& dest) const
 {
+    // Make sure the backup has the writes made so far
+    if (!FlushGroupCommit()) return false;
     sqlite3* db_copy;
     int res = sqlite3_open(dest.c_str(), &db_copy);
     if (res != SQLITE_OK) {
@@ -379,6 +389,9 @@ bool SQLiteDatabase::Backup(const std::string& dest) const
 
 void SQLiteDatabase::Close()
 {
+    // Nothing else may be using the database when it is closed, so the group
+    // transaction can be committed without waiting for m_write_semaphore.
+    CommitGroup();
     int res = sqlite3_close(m_db);
     if (res != SQLITE_OK) {
         throw std::runtime_error(strprintf("SQLiteDatabase: Failed to close database: %s\n", sqlite3_errstr(res)));
@@ -392,6 +405,79 @@ bool SQLiteDatabase::HasActiveTxn()
     return m_db && sqlite3_get_autocommit(m_db) == 0;
 }
 
+void SQLiteDatabase::JoinGroupCommit()
+{
+    if (m_group_commit_window == 0ms || !m_db) return;
+    LOCK(m_group_mutex);
+    if (m_group_deadline) {
+        ++m_group_writes;
+        return;
+    }
+    // If the group transaction cannot be opened, the write runs in its own transaction as usual
+    if (sqlite3_exec(m_db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        LogWarning("SQLiteDatabase: Failed to begin a group transaction: %s", sqlite3_errmsg(m_db));
+        return;
+    }
+    m_group_deadline = SteadyClock::now() + m_group_commit_window;
+    m_group_writes = 1;
+    m_group_cv.notify_one();
+}
+
+bool SQLiteDatabase::CommitGroup() const
+{
+    LOCK(m_group_mutex);
+    if (!m_group_deadline) return true;
+    int res = sqlite3_exec(m_db, "COMMIT TRANSACTION", nullptr, nullptr, nullptr);
+    if (res != SQLITE_OK) {
+        if (m_db && sqlite3_get_autocommit(m_db) == 0) {
+            // The transaction is still open, try again once the next window has passed
+            LogWarning("SQLiteDatabase: Failed to commit the group transaction, will retry: %s", sqlite3_errstr(res));
+            m_group_deadline = SteadyClock::now() + m_group_commit_window;
+            return false;
+        }
+        LogError("SQLiteDatabase: Failed to commit the group transaction, %u writes to %s were lost: %s", m_group_writes, m_file_path, sqlite3_errstr(res));
+    } else {
+        LogDebug(BCLog::WALLETDB, "Committed %u grouped writes to %s\n", m_group_writes, m_file_path);
+    }
+    m_group_deadline.reset();
+    m_group_writes = 0;
+    return res == SQLITE_OK;
+}
+
+bool SQLiteDatabase::FlushGroupCommit() const
+{
+    if (m_group_commit_window == 0ms) return true;
+    m_write_semaphore.acquire();
+    const bool ret{CommitGroup()};
+    m_write_semaphore.release();
+    return ret;
+}
+
+void SQLiteDatabase::ThreadGroupCommit()
+{
+    WAIT_LOCK(m_group_mutex, lock);
+    while (!m_group_stop) {
+        if (!m_group_deadline) {
+            m_group_cv.wait(lock);
+        } else if (SteadyClock::now() < *m_group_deadline) {
+            m_group_cv.wait_until(lock, *m_group_deadline);
+        } else {
+            REVERSE_LOCK(lock, m_group_mutex);
+            m_write_semaphore.acquire();
+            CommitGroup();
+            m_write_semaphore.release();
+        }
+    }
+}
+
+void SQLiteDatabase::StopGroupCommit()
+{
+    if (!m_group_thread.joinable()) return;
+    WITH_LOCK(m_group_mutex, m_group_stop = true);
+    m_group_cv.notify_one();
+    m_group_thread.join();
+}
+
 int SQliteExecHandler::Exec(SQLiteDatabase& database, const std::string& statement)
 {
     return sqlite3_exec(database.m_db, statement.data(), nullptr, nullptr, nullptr);
@@ -505,7 +591,11 @@ bool SQLiteBatch::WriteKey(DataStream&& key, DataStream&& value, bool overwrite)
     if (!BindBlobToStatement(stmt, 2, value, "value")) return false;
 
     // Acquire semaphore if not previously acquired when creating a transaction.
-    if (!m_txn) m_database.m_write_semaphore.acquire();
+    // Outside of a transaction, the write may join the group transaction.
+    if (!m_txn) {
+        m_database.m_write_semaphore.acquire();
+        m_database.JoinGroupCommit();
+    }
 
     // Execute
     int res = sqlite3_step(stmt);
@@ -529,7 +619,11 @@ bool SQLiteBatch::ExecStatement(sqlite3_stmt* stmt, std::span<const std::byte> b
     if (!BindBlobToStatement(stmt, 1, blob, "key")) return false;
 
     // Acquire semaphore if not previously acquired when creating a transaction.
-    if (!m_txn) m_database.m_write_semaphore.acquire();
+    // Outside of a transaction, the write may join the group transaction.
+    if (!m_txn) {
+        m_database.m_write_semaphore.acquire();
+        m_database.JoinGroupCommit();
+    }
 
     // Execute
     int res = sqlite3_step(stmt);
@@ -659,6 +753,11 @@ bool SQLiteBatch::TxnBegin()
 {
     if (!m_database.m_db || m_txn) return false;
     m_database.m_write_semaphore.acquire();
+    // Commit pending grouped writes, so that they do not depend on the outcome of this transaction
+    if (!m_database.CommitGroup()) {
+        m_database.m_write_semaphore.release();
+        return false;
+    }
     Assert(!m_database.HasActiveTxn());
     int res = Assert(m_exec_handler)->Exec(m_database, "BEGIN TRANSACTION");
     if (res != SQLITE_OK) {
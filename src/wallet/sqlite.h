@@ -6,9 +6,15 @@
 #define BITCOIN_WALLET_SQLITE_H
 
 #include <sync.h>
+#include <util/time.h>
 #include <wallet/db.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <optional>
 #include <semaphore>
+#include <thread>
 
 struct bilingual_str;
 
@@ -99,6 +105,19 @@ public:
 };
 
 /** An instance of this class represents one SQLite3 database.
+ *
+ * With a group commit window configured, writes made outside of a batch
+ * transaction do not each run in their own autocommit transaction. The first
+ * of them opens a group transaction that the following ones join, and a
+ * background thread commits it once the window has passed since that first
+ * write, so a burst of writes costs a single sync. Grouped writes are
+ * visible to every batch right away, but only durable once the group is
+ * committed. As SQLite transactions are atomic, a crash loses a suffix of the
+ * write history and never a write from the middle of it.
+ *
+ * Batch transactions (TxnBegin/TxnCommit) first commit the pending group,
+ * and are durable when TxnCommit returns as before. Closing, rewriting and
+ * backing up the database also commit the group first.
  **/
 class SQLiteDatabase : public WalletDatabase
 {
@@ -107,6 +126,20 @@ private:
 
     const std::string m_file_path;
 
+    //! How long writes outside of batch transactions are coalesced, zero if they are not
+    const std::chrono::milliseconds m_group_commit_window;
+    mutable Mutex m_group_mutex;
+    std::condition_variable m_group_cv;
+    //! When the open group transaction must be committed, if there is one
+    mutable std::optional<SteadyClock::time_point> m_group_deadline GUARDED_BY(m_group_mutex);
+    //! Number of writes that joined the open group transaction
+    mutable uint64_t m_group_writes GUARDED_BY(m_group_mutex){0};
+    bool m_group_stop GUARDED_BY(m_group_mutex){false};
+    std::thread m_group_thread;
+
+    void ThreadGroupCommit() EXCLUSIVE_LOCKS_REQUIRED(!m_group_mutex);
+    void StopGroupCommit() EXCLUSIVE_LOCKS_REQUIRED(!m_group_mutex);
+
     /**
      * This mutex protects SQLite initialization and shutdown.
      * sqlite3_config() and sqlite3_shutdown() are not thread-safe (sqlite3_initialize() is).
@@ -116,7 +149,7 @@ private:
     static Mutex g_sqlite_mutex;
     static int g_sqlite_count GUARDED_BY(g_sqlite_mutex);
 
-    void Cleanup() noexcept EXCLUSIVE_LOCKS_REQUIRED(!g_sqlite_mutex);
+    void Cleanup() noexcept EXCLUSIVE_LOCKS_REQUIRED(!g_sqlite_mutex, !m_group_mutex);
 
     void Open(int additional_flags);
 
@@ -133,7 +166,16 @@ public:
 
     // Batches must acquire this semaphore on writing, and release when done writing.
     // This ensures that only one batch is modifying the database at a time.
-    std::binary_semaphore m_write_semaphore;
+    mutable std::binary_semaphore m_write_semaphore;
+
+    /** Before a write outside of a batch transaction, with m_write_semaphore held: open the
+     *  group transaction if group commit is enabled and none is open, so the write joins it. */
+    void JoinGroupCommit() EXCLUSIVE_LOCKS_REQUIRED(!m_group_mutex);
+    /** Commit the group transaction if one is open. Must be called with m_write_semaphore held. */
+    bool CommitGroup() const EXCLUSIVE_LOCKS_REQUIRED(!m_group_mutex);
+    /** Commit the group transaction now instead of at the end of the window, for callers
+     *  that need the writes made so far to be durable. */
+    bool FlushGroupCommit() const EXCLUSIVE_LOCKS_REQUIRED(!m_group_mutex);
 
     bool Verify(bilingual_str& error);
 
@@ -141,14 +183,14 @@ public:
     void Open() override;
 
     /** Close the database */
-    void Close() override;
+    void Close() override EXCLUSIVE_LOCKS_REQUIRED(!m_group_mutex);
 
     /** Rewrite the entire database on disk */
-    bool Rewrite() override;
+    bool Rewrite() override EXCLUSIVE_LOCKS_REQUIRED(!m_group_mutex);
 
     /** Back up the entire database to a file.
      */
-    bool Backup(const std::string& dest) const override;
+    bool Backup(const std::string& dest) const override EXCLUSIVE_LOCKS_REQUIRED(!m_group_mutex);
 
     std::string Filename() override { return m_file_path; }
     /** Return paths to all database created files */
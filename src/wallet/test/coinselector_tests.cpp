@@ -709,6 +709,94 @@ BOOST_AUTO_TEST_CASE(SelectCoins_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(selection_interrupt_test)
+{
+    std::unique_ptr<CWallet> wallet = NewWallet(m_node);
+    CoinsResult available_coins;
+    for (int i = 1; i <= 20; ++i) {
+        add_coin(available_coins, *wallet, i * CENT + 1);
+    }
+    const CAmount target{35 * CENT};
+
+    SelectionInterrupt none;
+    BOOST_CHECK(!none(/*has_solution=*/true));
+    SelectionInterrupt expired{SelectionInterrupt::Clock::now()};
+    BOOST_CHECK(!expired(/*has_solution=*/false));
+    BOOST_CHECK(expired(/*has_solution=*/true));
+    BOOST_CHECK(!expired.Cancelled());
+    SelectionInterrupt cancelled;
+    cancelled.Cancel();
+    BOOST_CHECK(cancelled(/*has_solution=*/false));
+    BOOST_CHECK(cancelled.Cancelled());
+
+    const auto bnb{SelectCoinsBnB(KnapsackGroupOutputs(available_coins, *wallet, filter_standard), target, /*cost_of_change=*/CENT, MAX_STANDARD_TX_WEIGHT, &none)};
+    BOOST_REQUIRE(bnb);
+    BOOST_CHECK(bnb->GetAlgoCompleted());
+
+    // Cancelled searches give up before finding a solution...
+    BOOST_CHECK(!SelectCoinsBnB(KnapsackGroupOutputs(available_coins, *wallet, filter_standard), target, /*cost_of_change=*/CENT, MAX_STANDARD_TX_WEIGHT, &cancelled));
+    BOOST_CHECK(!CoinGrinder(KnapsackGroupOutputs(available_coins, *wallet, filter_standard), target, /*change_target=*/CENT, MAX_STANDARD_TX_WEIGHT, &cancelled));
+
+    // ...while searches out of time still run until their first solution
+    const auto bnb_expired{SelectCoinsBnB(KnapsackGroupOutputs(available_coins, *wallet, filter_standard), target, /*cost_of_change=*/CENT, MAX_STANDARD_TX_WEIGHT, &expired)};
+    BOOST_REQUIRE(bnb_expired);
+    BOOST_CHECK_GE(bnb_expired->GetSelectedValue(), target);
+    const auto cg_expired{CoinGrinder(KnapsackGroupOutputs(available_coins, *wallet, filter_standard), target, /*change_target=*/CENT, MAX_STANDARD_TX_WEIGHT, &expired)};
+    BOOST_REQUIRE(cg_expired);
+    BOOST_CHECK_GE(cg_expired->GetSelectedValue(), target);
+
+    // The knapsack solver always returns at least its worst case approximation
+    FastRandomContext rand;
+    const auto knapsack{KnapsackSolver(KnapsackGroupOutputs(available_coins, *wallet, filter_standard), target, /*change_target=*/CENT, rand, MAX_STANDARD_TX_WEIGHT, &cancelled)};
+    BOOST_REQUIRE(knapsack);
+    BOOST_CHECK_GE(knapsack->GetSelectedValue(), target);
+}
+
+BOOST_AUTO_TEST_CASE(SelectCoins_concurrent_test)
+{
+    std::unique_ptr<CWallet> wallet = NewWallet(m_node);
+    LOCK(wallet->cs_wallet);
+
+    FastRandomContext rand;
+    const CFeeRate feerate{10'000};
+    CoinsResult available_coins;
+    CAmount balance{0};
+    for (int i = 0; i < 2000; ++i) {
+        const CAmount val = rand.randrange(COIN) + CENT;
+        add_coin(available_coins, *wallet, val, feerate);
+        balance += val;
+    }
+
+    CoinSelectionParams cs_params{
+        rand,
+        /*change_output_size=*/ 31,
+        /*change_spend_size=*/ 68,
+        /*min_change_target=*/ CENT,
+        /*effective_feerate=*/ feerate,
+        /*long_term_feerate=*/ CFeeRate(1'000),
+        /*discard_feerate=*/ CFeeRate(3'000),
+        /*tx_noinputs_size=*/ 72,
+        /*avoid_partial=*/ false,
+    };
+    cs_params.m_change_fee = cs_params.m_effective_feerate.GetFee(cs_params.change_output_size);
+    cs_params.m_cost_of_change = cs_params.m_discard_feerate.GetFee(cs_params.change_spend_size) + cs_params.m_change_fee;
+    cs_params.min_viable_change = cs_params.m_discard_feerate.GetFee(cs_params.change_spend_size);
+    wallet->m_coin_selection_threads = 4;
+    cs_params.m_selection_pool = wallet->GetCoinSelectionPool();
+    CCoinControl cc;
+
+    for (const auto timeout : {std::chrono::milliseconds{10'000}, std::chrono::milliseconds{0}}) {
+        // Running out of time must not make the selection fail: every algorithm returns the best it found
+        cs_params.m_selection_timeout = timeout;
+        for (int i = 0; i < 10; ++i) {
+            const CAmount target{rand.randrange(balance / 2) + CENT};
+            const auto result = SelectCoins(*wallet, available_coins, /*pre_set_inputs=*/{}, target, cc, cs_params);
+            BOOST_REQUIRE(result);
+            BOOST_CHECK_GE(result->GetSelectedEffectiveValue(), target);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(waste_test)
 {
     const CAmount fee{100};
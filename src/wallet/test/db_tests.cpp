@@ -8,12 +8,14 @@
 #include <test/util/setup_common.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/time.h>
 #include <util/translation.h>
 #include <wallet/sqlite.h>
 #include <wallet/migrate.h>
 #include <wallet/test/util.h>
 #include <wallet/walletutil.h>
 
+#include <chrono>
 #include <cstddef>
 #include <memory>
 #include <span>
@@ -297,5 +299,59 @@ BOOST_AUTO_TEST_CASE(concurrent_txn_dont_interfere)
     BOOST_CHECK_EQUAL(read_value, value2);
 }
 
+BOOST_AUTO_TEST_CASE(group_commit)
+{
+    const std::string key1{"key1"}, key2{"key2"}, key3{"key3"}, value{"value"};
+    DatabaseOptions options;
+    // Long enough that the group is only committed explicitly below
+    options.group_commit_window = 1h;
+    DatabaseStatus status;
+    bilingual_str error;
+    {
+        const auto database{MakeSQLiteDatabase(m_path_root / "sqlite", options, status, error)};
+        std::unique_ptr<DatabaseBatch> batch{Assert(database)->MakeBatch()};
+
+        // Writes outside of a transaction join a group transaction and are visible right away
+        BOOST_CHECK(batch->Write(key1, value));
+        BOOST_CHECK(database->HasActiveTxn());
+        BOOST_CHECK(batch->Write(key2, value));
+        BOOST_CHECK(database->MakeBatch()->Exists(key1));
+
+        // A batch transaction commits the group first, so aborting it keeps the grouped writes
+        BOOST_CHECK(batch->TxnBegin());
+        BOOST_CHECK(batch->Write(key3, value));
+        BOOST_CHECK(batch->TxnAbort());
+        BOOST_CHECK(!database->HasActiveTxn());
+        BOOST_CHECK(batch->Exists(key1));
+        BOOST_CHECK(!batch->Exists(key3));
+
+        // Closing the database commits a pending group
+        BOOST_CHECK(batch->Erase(key2));
+        BOOST_CHECK(database->HasActiveTxn());
+    }
+    const auto database{MakeSQLiteDatabase(m_path_root / "sqlite", DatabaseOptions{}, status, error)};
+    std::unique_ptr<DatabaseBatch> batch{Assert(database)->MakeBatch()};
+    BOOST_CHECK(batch->Exists(key1));
+    BOOST_CHECK(!batch->Exists(key2));
+}
+
+BOOST_AUTO_TEST_CASE(group_commit_window)
+{
+    DatabaseOptions options;
+    options.group_commit_window = 10ms;
+    DatabaseStatus status;
+    bilingual_str error;
+    const auto database{MakeSQLiteDatabase(m_path_root / "sqlite", options, status, error)};
+    std::unique_ptr<DatabaseBatch> batch{Assert(database)->MakeBatch()};
+
+    // The background thread commits the group once the window has passed
+    BOOST_CHECK(batch->Write(std::string{"key"}, std::string{"value"}));
+    for (int i{0}; i < 1000 && database->HasActiveTxn(); ++i) {
+        UninterruptibleSleep(10ms);
+    }
+    BOOST_CHECK(!database->HasActiveTxn());
+    BOOST_CHECK(batch->Exists(std::string{"key"}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
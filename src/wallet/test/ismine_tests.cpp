@@ -9,6 +9,8 @@
 #include <script/solver.h>
 #include <script/signingprovider.h>
 #include <test/util/setup_common.h>
+#include <uint256.h>
+#include <wallet/scriptfilter.h>
 #include <wallet/types.h>
 #include <wallet/wallet.h>
 #include <wallet/test/util.h>
@@ -282,5 +284,59 @@ BOOST_AUTO_TEST_CASE(ismine_standard)
     }
 }
 
+BOOST_AUTO_TEST_CASE(ismine_script_filter)
+{
+    const auto random_script{[&] { return GetScriptForDestination(WitnessV0KeyHash{uint160{m_rng.randbytes(uint160::size())}}); }};
+
+    ScriptPubKeyFilter filter;
+    BOOST_CHECK_EQUAL(filter.Capacity(), 0U);
+    BOOST_CHECK(!filter.MayContain(random_script()));
+
+    filter.Reset(1000);
+    BOOST_CHECK_GE(filter.Capacity(), 1000U);
+    std::vector<CScript> inserted;
+    for (int i = 0; i < 1000; ++i) {
+        inserted.push_back(random_script());
+        filter.Insert(inserted.back());
+    }
+    // No false negatives
+    for (const CScript& script : inserted) {
+        BOOST_CHECK(filter.MayContain(script));
+    }
+    // False positives stay well below 1% within capacity
+    int false_positives{0};
+    for (int i = 0; i < 10000; ++i) {
+        false_positives += filter.MayContain(random_script());
+    }
+    BOOST_CHECK_LT(false_positives, 100);
+}
+
+BOOST_AUTO_TEST_CASE(ismine_cache_filter_topup)
+{
+    CWallet wallet(m_node.chain.get(), "", CreateMockableWalletDatabase());
+    wallet.m_keypool_size = 10;
+    LOCK(wallet.cs_wallet);
+    wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+    wallet.SetupDescriptorScriptPubKeyMans();
+
+    const auto check_all_mine{[&] {
+        for (const ScriptPubKeyMan* spkm : wallet.GetAllScriptPubKeyMans()) {
+            for (const CScript& script : spkm->GetScriptPubKeys()) {
+                BOOST_CHECK(wallet.IsMine(script));
+            }
+        }
+    }};
+    check_all_mine();
+
+    // Topping up repeatedly outgrows the prefilter, which must be rebuilt without losing scripts
+    for (const unsigned int size : {100, 500, 2000}) {
+        for (ScriptPubKeyMan* spkm : wallet.GetAllScriptPubKeyMans()) {
+            BOOST_CHECK(spkm->TopUp(size));
+        }
+        check_all_mine();
+    }
+    BOOST_CHECK(!wallet.IsMine(GetScriptForDestination(WitnessV0KeyHash{uint160{}})));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
@@ -10,6 +10,10 @@
 #include <wallet/wallet.h>
 #include <wallet/test/util.h>
 
+#include <set>
+#include <string>
+#include <vector>
+
 #include <boost/test/unit_test.hpp>
 
 namespace wallet {
@@ -37,5 +41,34 @@ BOOST_AUTO_TEST_CASE(DescriptorScriptPubKeyManTests)
     BOOST_CHECK(signprov_keypath_nums_h == nullptr);
 }
 
+BOOST_AUTO_TEST_CASE(DescriptorScriptPubKeyManTopUpThreads)
+{
+    std::unique_ptr<interfaces::Chain>& chain = m_node.chain;
+    CExtKey master_key;
+    master_key.SetSeed(m_rng.randbytes<std::byte>(32));
+    const std::string xprv{EncodeExtKey(master_key)};
+
+    // Topping up on several threads must derive the same scripts at the same indexes as on one,
+    // including for hardened derivation that goes through the descriptor cache
+    for (const std::string& desc_str : {"wpkh(" + xprv + "/0/*)", "tr(" + xprv + "/1h/*h)"}) {
+        std::vector<std::set<CScript>> all_spks, upper_spks;
+        for (const int threads : {1, 4}) {
+            CWallet keystore(chain.get(), "", CreateMockableWalletDatabase());
+            keystore.m_keypool_size = 1;
+            keystore.m_keypool_threads = threads;
+            auto spk_man = CreateDescriptor(keystore, desc_str, true);
+            BOOST_CHECK(spk_man->TopUp(2000));
+            const auto spks{spk_man->GetScriptPubKeys()};
+            const auto upper{spk_man->GetScriptPubKeys(/*minimum_index=*/1000)};
+            all_spks.emplace_back(spks.begin(), spks.end());
+            upper_spks.emplace_back(upper.begin(), upper.end());
+        }
+        BOOST_CHECK_EQUAL(all_spks[0].size(), 2000U);
+        BOOST_CHECK_EQUAL(upper_spks[0].size(), 1000U);
+        BOOST_CHECK(all_spks[0] == all_spks[1]);
+        BOOST_CHECK(upper_spks[0] == upper_spks[1]);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
@@ -213,6 +213,40 @@ BOOST_FIXTURE_TEST_CASE(scan_for_wallet_transactions, TestChain100Setup)
     }
 }
 
+// Rescans skip transactions paying to none of the wallet scripts, unless they
+// involve wallet transactions, like one sending a wallet coin elsewhere.
+BOOST_FIXTURE_TEST_CASE(rescan_finds_spends_to_other_scripts, TestChain100Setup)
+{
+    CKey other_key{GenerateRandomKey()};
+    const CScript other_script{GetScriptForDestination(WitnessV0KeyHash{other_key.GetPubKey()})};
+    const CMutableTransaction spend{CreateValidMempoolTransaction(m_coinbase_txns[0], /*input_vout=*/0, /*input_height=*/1, coinbaseKey,
+                                                                  other_script, /*output_amount=*/49 * COIN, /*submit=*/false)};
+    CreateAndProcessBlock({spend}, other_script);
+    const CBlockIndex* tip{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())};
+
+    for (const int threads : {1, 4}) {
+        CWallet wallet(m_node.chain.get(), "", CreateMockableWalletDatabase());
+        wallet.m_rescan_threads = threads;
+        {
+            LOCK(wallet.cs_wallet);
+            wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+            wallet.SetLastBlockProcessed(tip->nHeight, tip->GetBlockHash());
+        }
+        AddKey(wallet, coinbaseKey);
+        WalletRescanReserver reserver(wallet);
+        reserver.reserve();
+        const uint256 genesis_hash{m_node.chainman->GetParams().GenesisBlock().GetHash()};
+        const auto result{wallet.ScanForWalletTransactions(genesis_hash, /*start_height=*/0, /*max_height=*/{}, reserver, /*fUpdate=*/false, /*save_progress=*/false)};
+        BOOST_CHECK_EQUAL(result.status, CWallet::ScanResult::SUCCESS);
+        LOCK(wallet.cs_wallet);
+        BOOST_CHECK(wallet.GetWalletTx(spend.GetHash()));
+        // The only mature coinbase output is spent
+        const auto balance{GetBalance(wallet)};
+        BOOST_CHECK_EQUAL(balance.m_mine_trusted, 0);
+        BOOST_CHECK_EQUAL(balance.m_mine_immature, 99 * 50 * COIN);
+    }
+}
+
 // This test verifies that wallet settings can be added and removed
 // concurrently, ensuring no race conditions occur during either process.
 BOOST_FIXTURE_TEST_CASE(write_wallet_settings_concurrently, TestingSetup)
@@ -449,6 +483,37 @@ BOOST_FIXTURE_TEST_CASE(ListCoinsTest, ListCoinsTestingSetup)
     BOOST_CHECK_EQUAL(list.begin()->second.size(), 2U);
 }
 
+BOOST_FIXTURE_TEST_CASE(cached_balance_follows_wallet_changes, ListCoinsTestingSetup)
+{
+    const auto check_balance{[&] {
+        // Call twice, so the second call is served from the cache
+        const Balance first{GetBalance(*wallet)};
+        const Balance second{GetBalance(*wallet)};
+        BOOST_CHECK(first == second);
+        BOOST_CHECK_EQUAL(second.m_mine_trusted, WITH_LOCK(wallet->cs_wallet, return AvailableCoins(*wallet).GetTotalAmount()));
+        return second;
+    }};
+    const Balance initial{check_balance()};
+    BOOST_CHECK_EQUAL(initial.m_mine_trusted, 50 * COIN);
+
+    // A confirmed spend and a new tip must both be reflected
+    AddTx(CRecipient{PubKeyDestination{{}}, 1 * COIN, /*subtract_fee=*/false});
+    const Balance confirmed{check_balance()};
+    BOOST_CHECK(confirmed != initial);
+
+    // So must an unconfirmed spend
+    CCoinControl coin_control;
+    auto res{CreateTransaction(*wallet, {CRecipient{PubKeyDestination{{}}, 1 * COIN, /*subtract_fee=*/false}}, /*change_pos=*/std::nullopt, coin_control)};
+    BOOST_REQUIRE(res);
+    wallet->CommitTransaction(res->tx, {}, {});
+    const Balance unconfirmed{check_balance()};
+    BOOST_CHECK(unconfirmed != confirmed);
+
+    // And explicitly marking the wallet dirty drops the cache
+    wallet->MarkDirty();
+    BOOST_CHECK(GetBalance(*wallet) == unconfirmed);
+}
+
 void TestCoinsResult(ListCoinsTest& context, OutputType out_type, CAmount amount,
                      std::map<OutputType, size_t>& expected_coins_sizes)
 {
@@ -723,5 +788,104 @@ BOOST_FIXTURE_TEST_CASE(RemoveTxs, TestChain100Setup)
     TestUnloadWallet(std::move(wallet));
 }
 
+BOOST_FIXTURE_TEST_CASE(shared_notification_dispatch, TestChain100Setup)
+{
+    m_args.ForceSetArg("-unsafesqlitesync", "1");
+    WalletContext context;
+    context.args = &m_args;
+    context.chain = m_node.chain.get();
+    auto wallet_a = TestCreateWallet(CreateMockableWalletDatabase(), context, WALLET_FLAG_DESCRIPTORS);
+    auto wallet_b = TestCreateWallet(CreateMockableWalletDatabase(), context, WALLET_FLAG_DESCRIPTORS);
+    CKey key_a = GenerateRandomKey();
+    CKey key_b = GenerateRandomKey();
+    AddKey(*wallet_a, key_a);
+    AddKey(*wallet_b, key_b);
+
+    // A block paying to wallet A, and spending that output to a foreign script in the
+    // same block. The spend has no output of A's, it is only relevant as A's debit.
+    const CTransaction receive_tx{TestSimpleSpend(*m_coinbase_txns[0], 0, coinbaseKey, GetScriptForRawPubKey(key_a.GetPubKey()))};
+    const CTransaction spend_tx{TestSimpleSpend(receive_tx, 0, key_a, GetScriptForRawPubKey(coinbaseKey.GetPubKey()))};
+    CreateAndProcessBlock({CMutableTransaction{receive_tx}, CMutableTransaction{spend_tx}}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+
+    // A mempool transaction paying to wallet B
+    std::string error;
+    const CTransactionRef mempool_tx{MakeTransactionRef(TestSimpleSpend(*m_coinbase_txns[1], 0, coinbaseKey, GetScriptForRawPubKey(key_b.GetPubKey())))};
+    BOOST_CHECK(m_node.chain->broadcastTransaction(mempool_tx, DEFAULT_TRANSACTION_MAXFEE, node::TxBroadcast::MEMPOOL_NO_BROADCAST, error));
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    const int tip_height{WITH_LOCK(::cs_main, return m_node.chainman->ActiveChain().Height())};
+    {
+        LOCK(wallet_a->cs_wallet);
+        BOOST_CHECK(wallet_a->mapWallet.contains(receive_tx.GetHash()));
+        BOOST_CHECK(wallet_a->mapWallet.contains(spend_tx.GetHash()));
+        BOOST_CHECK(!wallet_a->mapWallet.contains(mempool_tx->GetHash()));
+        BOOST_CHECK_EQUAL(wallet_a->GetLastBlockHeight(), tip_height);
+    }
+    {
+        LOCK(wallet_b->cs_wallet);
+        // Wallet B was only told about its own transaction, but still follows the tip
+        BOOST_CHECK_EQUAL(wallet_b->mapWallet.size(), 1U);
+        BOOST_CHECK(wallet_b->mapWallet.contains(mempool_tx->GetHash()));
+        BOOST_CHECK_EQUAL(wallet_b->GetLastBlockHeight(), tip_height);
+    }
+
+    TestUnloadWallet(std::move(wallet_a));
+
+    // Confirming wallet B's transaction after A was unloaded still reaches B
+    CreateAndProcessBlock({CMutableTransaction{*mempool_tx}}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    {
+        LOCK(wallet_b->cs_wallet);
+        BOOST_CHECK(wallet_b->GetWalletTx(mempool_tx->GetHash())->isConfirmed());
+        BOOST_CHECK_EQUAL(wallet_b->GetLastBlockHeight(), tip_height + 1);
+    }
+
+    TestUnloadWallet(std::move(wallet_b));
+}
+
+BOOST_FIXTURE_TEST_CASE(shared_notification_dispatch_gap_limit, TestChain100Setup)
+{
+    m_args.ForceSetArg("-unsafesqlitesync", "1");
+    m_args.ForceSetArg("-keypool", "2");
+    WalletContext context;
+    context.args = &m_args;
+    context.chain = m_node.chain.get();
+    auto wallet = TestCreateWallet(CreateMockableWalletDatabase(), context, WALLET_FLAG_DESCRIPTORS);
+
+    // A ranged descriptor with scripts cached up to index 1
+    FlatSigningProvider provider;
+    std::string error;
+    auto descs{Parse("wpkh(tprv8ZgxMBicQKsPd1QwsGgzfu2pcPYbBosZhJknqreRHgsWx32nNEhMjGQX2cgFL8n6wz9xdDYwLcs78N4nsCo32cxEX8RBtwGsEGgybLiQJfk/0/*)", provider, error, /*require_checksum=*/false)};
+    BOOST_REQUIRE_EQUAL(descs.size(), 1U);
+    std::vector<CScript> scripts_1, scripts_3;
+    FlatSigningProvider out;
+    BOOST_REQUIRE(descs[0]->Expand(1, provider, scripts_1, out));
+    BOOST_REQUIRE(descs[0]->Expand(3, provider, scripts_3, out));
+    WalletDescriptor w_desc{std::move(descs[0]), 0, 0, 0, 0};
+    {
+        LOCK(wallet->cs_wallet);
+        BOOST_REQUIRE(wallet->AddWalletDescriptor(w_desc, provider, "", false));
+        BOOST_CHECK(wallet->IsMine(scripts_1.at(0)));
+        BOOST_CHECK(!wallet->IsMine(scripts_3.at(0)));
+    }
+
+    // Mature the second coinbase output spent below
+    CreateAndProcessBlock({}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+
+    // One block paying to index 1, which tops up the keypool past index 3, and then to index 3.
+    // The dispatcher matched the block before the wallet knew the second script.
+    const CTransaction tx_1{TestSimpleSpend(*m_coinbase_txns[0], 0, coinbaseKey, scripts_1.at(0))};
+    const CTransaction tx_3{TestSimpleSpend(*m_coinbase_txns[1], 0, coinbaseKey, scripts_3.at(0))};
+    CreateAndProcessBlock({CMutableTransaction{tx_1}, CMutableTransaction{tx_3}}, GetScriptForRawPubKey(coinbaseKey.GetPubKey()));
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    {
+        LOCK(wallet->cs_wallet);
+        BOOST_CHECK(wallet->mapWallet.contains(tx_1.GetHash()));
+        BOOST_CHECK(wallet->mapWallet.contains(tx_3.GetHash()));
+    }
+
+    TestUnloadWallet(std::move(wallet));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
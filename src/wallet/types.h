@@ -31,6 +31,16 @@ enum class AddressPurpose {
     REFUND, //!< Never set in current code may be present in older wallet databases
 };
 
+struct Balance {
+    CAmount m_mine_trusted{0};           //!< Trusted, at depth=GetBalance.min_depth or more
+    CAmount m_mine_untrusted_pending{0}; //!< Untrusted, but in mempool (pending)
+    CAmount m_mine_immature{0};          //!< Immature coinbases in the main chain
+    CAmount m_mine_used{0};              //!< Trusted/untrusted/immature funds in utxos that have already been spent from (only populated if AVOID REUSE wallet flag is set)
+    CAmount m_mine_nonmempool{0};        //!< Coins spent by wallet txs that are not in the mempool
+
+    friend bool operator==(const Balance&, const Balance&) = default;
+};
+
 struct CreatedTransactionResult
 {
     CTransactionRef tx;
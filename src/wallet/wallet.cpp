@@ -58,8 +58,10 @@
 #include <util/moneystr.h>
 #include <util/result.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
+#include <wallet/chainnotifications.h>
 #include <wallet/coincontrol.h>
 #include <wallet/context.h>
 #include <wallet/crypter.h>
@@ -74,7 +76,11 @@
 #include <algorithm>
 #include <cassert>
 #include <condition_variable>
+#include <deque>
 #include <exception>
+#include <future>
+#include <map>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <thread>
@@ -305,59 +311,183 @@ std::shared_ptr<CWallet> LoadWalletInternal(WalletContext& context, const std::s
     }
 }
 
-class FastWalletRescanFilter
+/**
+ * The scripts of a wallet during a rescan. They are published as immutable
+ * snapshots, so that rescan workers can match blocks against them without
+ * holding cs_wallet. A new snapshot is taken whenever a keypool top-up derived
+ * new scripts or a ScriptPubKeyMan was added.
+ */
+class RescanScriptSet
 {
 public:
-    FastWalletRescanFilter(const CWallet& wallet) : m_wallet(wallet)
+    using Snapshot = std::shared_ptr<const GCSFilter::ElementSet>;
+
+    explicit RescanScriptSet(const CWallet& wallet) : m_wallet(wallet)
     {
-        // create initial filter with scripts from all ScriptPubKeyMans
-        for (auto spkm : m_wallet.GetAllScriptPubKeyMans()) {
-            auto desc_spkm{dynamic_cast<DescriptorScriptPubKeyMan*>(spkm)};
-            assert(desc_spkm != nullptr);
-            AddScriptPubKeys(desc_spkm);
-            // save each range descriptor's end for possible future filter updates
-            if (desc_spkm->IsHDEnabled()) {
-                m_last_range_ends.emplace(desc_spkm->GetID(), desc_spkm->GetEndRange());
-            }
-        }
+        Rebuild();
     }
 
-    void UpdateIfNeeded()
+    /** Take a new snapshot if scripts were added since the last one. Returns whether one was taken. */
+    bool UpdateIfNeeded()
     {
+        if (m_wallet.GetAllScriptPubKeyMans().size() != m_spkm_count) {
+            Rebuild();
+            return true;
+        }
         // repopulate filter with new scripts if top-up has happened since last iteration
-        for (const auto& [desc_spkm_id, last_range_end] : m_last_range_ends) {
+        bool updated{false};
+        for (auto& [desc_spkm_id, last_range_end] : m_last_range_ends) {
             auto desc_spkm{dynamic_cast<DescriptorScriptPubKeyMan*>(m_wallet.GetScriptPubKeyMan(desc_spkm_id))};
             assert(desc_spkm != nullptr);
             int32_t current_range_end{desc_spkm->GetEndRange()};
             if (current_range_end > last_range_end) {
-                AddScriptPubKeys(desc_spkm, last_range_end);
-                m_last_range_ends.at(desc_spkm->GetID()) = current_range_end;
+                // Prefetch workers may still be matching blocks against the snapshot,
+                // so only copy it while they hold it and add to it in place otherwise.
+                if (!updated && m_snapshot.use_count() > 1) m_snapshot = std::make_shared<GCSFilter::ElementSet>(*m_snapshot);
+                updated = true;
+                AddScriptPubKeys(*m_snapshot, desc_spkm, last_range_end);
+                last_range_end = current_range_end;
             }
         }
+        return updated;
     }
 
-    std::optional<bool> MatchesBlock(const uint256& block_hash) const
-    {
-        return m_wallet.chain().blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, m_filter_set);
-    }
+    Snapshot Current() const { return m_snapshot; }
 
 private:
     const CWallet& m_wallet;
     /** Map for keeping track of each range descriptor's last seen end range.
       * This information is used to detect whether new addresses were derived
       * (that is, if the current end range is larger than the saved end range)
-      * after processing a block and hence a filter set update is needed to
+      * after processing a block and hence a snapshot update is needed to
       * take possible keypool top-ups into account.
       */
     std::map<uint256, int32_t> m_last_range_ends;
-    GCSFilter::ElementSet m_filter_set;
+    size_t m_spkm_count{0};
+    std::shared_ptr<GCSFilter::ElementSet> m_snapshot;
+
+    void Rebuild()
+    {
+        // create initial snapshot with scripts from all ScriptPubKeyMans
+        auto scripts{std::make_shared<GCSFilter::ElementSet>()};
+        m_last_range_ends.clear();
+        const auto spkms{m_wallet.GetAllScriptPubKeyMans()};
+        for (auto spkm : spkms) {
+            auto desc_spkm{dynamic_cast<DescriptorScriptPubKeyMan*>(spkm)};
+            assert(desc_spkm != nullptr);
+            AddScriptPubKeys(*scripts, desc_spkm);
+            // save each range descriptor's end for possible future snapshot updates
+            if (desc_spkm->IsHDEnabled()) {
+                m_last_range_ends.emplace(desc_spkm->GetID(), desc_spkm->GetEndRange());
+            }
+        }
+        m_spkm_count = spkms.size();
+        m_snapshot = std::move(scripts);
+    }
 
-    void AddScriptPubKeys(const DescriptorScriptPubKeyMan* desc_spkm, int32_t last_range_end = 0)
+    static void AddScriptPubKeys(GCSFilter::ElementSet& scripts, const DescriptorScriptPubKeyMan* desc_spkm, int32_t last_range_end = 0)
     {
         for (const auto& script_pub_key : desc_spkm->GetScriptPubKeys(last_range_end)) {
-            m_filter_set.emplace(script_pub_key.begin(), script_pub_key.end());
+            scripts.emplace(script_pub_key.begin(), script_pub_key.end());
+        }
+    }
+};
+
+/** A block read and matched against a snapshot of the wallet scripts ahead of a rescan. */
+struct PrefetchedBlock {
+    uint256 hash;
+    //! The snapshot the block was matched against.
+    RescanScriptSet::Snapshot scripts;
+    //! Result of the block filter check, if the block filter index was used.
+    std::optional<bool> filter_match;
+    //! The block, null if the block filter ruled it out or it could not be read.
+    CBlock block;
+    //! For every transaction of block, whether one of its outputs pays to scripts.
+    std::vector<bool> pays_to_scripts;
+};
+
+PrefetchedBlock PrefetchBlock(interfaces::Chain& chain, const uint256& block_hash, RescanScriptSet::Snapshot scripts, bool use_block_filter)
+{
+    PrefetchedBlock result{.hash = block_hash, .scripts = std::move(scripts), .filter_match = std::nullopt, .block = {}, .pays_to_scripts = {}};
+    if (use_block_filter) {
+        result.filter_match = chain.blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, *result.scripts);
+        if (result.filter_match == false) return result;
+    }
+    chain.findBlock(block_hash, FoundBlock().data(result.block));
+    result.pays_to_scripts.reserve(result.block.vtx.size());
+    for (const CTransactionRef& tx : result.block.vtx) {
+        result.pays_to_scripts.push_back(std::ranges::any_of(tx->vout, [&](const CTxOut& txout) {
+            return result.scripts->contains(GCSFilter::Element(txout.scriptPubKey.begin(), txout.scriptPubKey.end()));
+        }));
+    }
+    return result;
+}
+
+/**
+ * Reads and matches the blocks of a rescan on a thread pool, up to a window of
+ * blocks ahead of the one being applied to the wallet. Prefetched blocks are
+ * only used if they were matched against the current script snapshot and are
+ * still on the path the rescan takes; otherwise the block is prefetched again
+ * inline.
+ */
+class RescanPrefetcher
+{
+public:
+    RescanPrefetcher(interfaces::Chain& chain, int threads, bool use_block_filter, std::optional<int> max_height)
+        : m_chain{chain}, m_use_block_filter{use_block_filter}, m_max_height{max_height}, m_window{threads > 1 ? 2 * size_t(threads) : 0}
+    {
+        if (m_window > 0) m_pool.emplace("walletscan").Start(threads);
+    }
+
+    PrefetchedBlock Get(const uint256& block_hash, int block_height, const RescanScriptSet::Snapshot& scripts)
+    {
+        std::optional<PrefetchedBlock> result;
+        if (!m_queue.empty() && m_queue.front().hash == block_hash && m_queue.front().scripts == scripts) {
+            result = m_queue.front().result.get();
+            m_queue.pop_front();
+        } else {
+            m_queue.clear();
+            result = PrefetchBlock(m_chain, block_hash, scripts, m_use_block_filter);
+        }
+        Refill(block_hash, block_height, scripts);
+        return std::move(*result);
+    }
+
+private:
+    struct Pending {
+        uint256 hash;
+        int height;
+        RescanScriptSet::Snapshot scripts;
+        std::future<PrefetchedBlock> result;
+    };
+
+    void Refill(uint256 block_hash, int block_height, const RescanScriptSet::Snapshot& scripts)
+    {
+        if (!m_queue.empty()) {
+            block_hash = m_queue.back().hash;
+            block_height = m_queue.back().height;
+        }
+        while (m_queue.size() < m_window && (!m_max_height || block_height < *m_max_height)) {
+            bool next_block{false};
+            uint256 next_hash;
+            m_chain.findBlock(block_hash, FoundBlock().nextBlock(FoundBlock().inActiveChain(next_block).hash(next_hash)));
+            if (!next_block) break;
+            auto future{m_pool->Submit([&chain = m_chain, next_hash, scripts, use_block_filter = m_use_block_filter] {
+                return PrefetchBlock(chain, next_hash, scripts, use_block_filter);
+            })};
+            if (!future) break;
+            block_hash = next_hash;
+            ++block_height;
+            m_queue.push_back({.hash = block_hash, .height = block_height, .scripts = scripts, .result = std::move(*future)});
         }
     }
+
+    interfaces::Chain& m_chain;
+    const bool m_use_block_filter;
+    const std::optional<int> m_max_height;
+    const size_t m_window;
+    std::optional<ThreadPool> m_pool;
+    std::deque<Pending> m_queue;
 };
 } // namespace
 
@@ -686,6 +816,8 @@ void CWallet::SetLastBlockProcessedInMem(int block_height, uint256 block_hash)
 
     m_last_block_processed = block_hash;
     m_last_block_processed_height = block_height;
+    // Depths, and with them trust and coinbase maturity, are relative to the tip
+    InvalidateCachedBalances();
 }
 
 void CWallet::SetLastBlockProcessed(int block_height, uint256 block_hash)
@@ -820,6 +952,7 @@ CWallet::SpendType CWallet::HowSpent(const COutPoint& outpoint) const
 void CWallet::AddToSpends(const COutPoint& outpoint, const Txid& txid)
 {
     mapTxSpends.insert(std::make_pair(outpoint, txid));
+    InvalidateCachedBalances();
 
     UnlockCoin(outpoint);
 
@@ -831,6 +964,14 @@ void CWallet::AddToSpends(const COutPoint& outpoint, const Txid& txid)
 
 void CWallet::AddToSpends(const CWalletTx& wtx)
 {
+    if (m_notification_dispatcher) {
+        std::vector<COutPoint> spent;
+        if (!wtx.IsCoinBase()) {
+            for (const CTxIn& txin : wtx.tx->vin) spent.push_back(txin.prevout);
+        }
+        m_notification_dispatcher->AddTransactions(*this, std::span{&wtx.tx->GetHash(), 1}, spent);
+    }
+
     if (wtx.IsCoinBase()) // Coinbases don't spend anything!
         return;
 
@@ -988,6 +1129,7 @@ void CWallet::MarkDirty()
         LOCK(cs_wallet);
         for (auto& [_, wtx] : mapWallet)
             wtx.MarkDirty();
+        InvalidateCachedBalances();
     }
 }
 
@@ -1009,6 +1151,7 @@ bool CWallet::MarkReplaced(const Txid& originalHash, const Txid& newHash)
 
     // Refresh mempool status without waiting for transactionRemovedFromMempool or transactionAddedToMempool
     RefreshMempoolStatus(wtx, chain());
+    InvalidateCachedBalances();
 
     WalletBatch batch(GetDatabase());
 
@@ -1322,6 +1465,7 @@ void CWallet::MarkInputsDirty(const CTransactionRef& tx)
             it->second.MarkDirty();
         }
     }
+    InvalidateCachedBalances();
 }
 
 bool CWallet::AbandonTransaction(const Txid& hashTx)
@@ -1455,6 +1599,7 @@ void CWallet::transactionAddedToMempool(const CTransactionRef& tx) {
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         RefreshMempoolStatus(it->second, chain());
+        InvalidateCachedBalances();
     }
 
     const Txid& txid = tx->GetHash();
@@ -1496,6 +1641,7 @@ void CWallet::transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRe
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         RefreshMempoolStatus(it->second, chain());
+        InvalidateCachedBalances();
     }
     // Handle transactions that were removed from the mempool because they
     // conflict with transactions in a newly connected block.
@@ -1561,6 +1707,11 @@ void CWallet::transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRe
 }
 
 void CWallet::blockConnected(const ChainstateRole& role, const interfaces::BlockInfo& block)
+{
+    ConnectBlock(role, block, /*tx_indexes=*/std::nullopt);
+}
+
+void CWallet::ConnectBlock(const ChainstateRole& role, const interfaces::BlockInfo& block, std::optional<std::span<const size_t>> tx_indexes)
 {
     if (role.historical) {
         return;
@@ -1578,10 +1729,10 @@ void CWallet::blockConnected(const ChainstateRole& role, const interfaces::Block
 
     // Scan block
     bool wallet_updated = false;
-    for (size_t index = 0; index < block.data->vtx.size(); index++) {
+    ForEachBlockTx(*block.data, tx_indexes, [&](size_t index) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) {
         wallet_updated |= SyncTransaction(block.data->vtx[index], TxStateConfirmed{block.hash, block.height, static_cast<int>(index)});
         transactionRemovedFromMempool(block.data->vtx[index], MemPoolRemovalReason::BLOCK);
-    }
+    });
 
     // Update on disk if this block resulted in us updating a tx, or periodically every 144 blocks (~1 day)
     if (wallet_updated || block.height % 144 == 0) {
@@ -1590,6 +1741,11 @@ void CWallet::blockConnected(const ChainstateRole& role, const interfaces::Block
 }
 
 void CWallet::blockDisconnected(const interfaces::BlockInfo& block)
+{
+    DisconnectBlock(block, /*tx_indexes=*/std::nullopt);
+}
+
+void CWallet::DisconnectBlock(const interfaces::BlockInfo& block, std::optional<std::span<const size_t>> tx_indexes)
 {
     assert(block.data);
     LOCK(cs_wallet);
@@ -1600,7 +1756,7 @@ void CWallet::blockDisconnected(const interfaces::BlockInfo& block)
     // future with a stickier abandoned state or even removing abandontransaction call.
     int disconnect_height = block.height;
 
-    for (size_t index = 0; index < block.data->vtx.size(); index++) {
+    ForEachBlockTx(*block.data, tx_indexes, [&](size_t index) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) {
         const CTransactionRef& ptx = block.data->vtx[index];
         // Coinbase transactions are not only inactive but also abandoned,
         // meaning they should never be relayed standalone via the p2p protocol.
@@ -1630,12 +1786,30 @@ void CWallet::blockDisconnected(const interfaces::BlockInfo& block)
                 RecursiveUpdateTxState(wtx.tx->GetHash(), try_updating_state);
             }
         }
-    }
+    });
 
     // Update the best block
     SetLastBlockProcessed(block.height - 1, *Assert(block.prev_hash));
 }
 
+void CWallet::ForEachBlockTx(const CBlock& block, std::optional<std::span<const size_t>> tx_indexes, const std::function<void(size_t)>& fn)
+{
+    AssertLockHeld(cs_wallet);
+    if (!tx_indexes) {
+        for (size_t index = 0; index < block.vtx.size(); ++index) fn(index);
+        return;
+    }
+    const size_t num_scripts{m_cached_spks.size()};
+    for (const size_t index : *tx_indexes) {
+        fn(index);
+        if (m_cached_spks.size() != num_scripts) {
+            // The dispatcher could not match later transactions against the new scripts
+            for (size_t later = index + 1; later < block.vtx.size(); ++later) fn(later);
+            return;
+        }
+    }
+}
+
 void CWallet::updatedBlockTip()
 {
     m_best_block_time = GetTime();
@@ -1679,6 +1853,9 @@ bool CWallet::IsMine(const CScript& script) const
 {
     AssertLockHeld(cs_wallet);
 
+    // Most scripts seen in blocks and the mempool are not ours, reject them without probing the cache
+    if (!m_cached_spks_filter.MayContain(script)) return false;
+
     // Search the cache so that IsMine is called only on the relevant SPKMs instead of on everything in m_spk_managers
     const auto& it = m_cached_spks.find(script);
     if (it != m_cached_spks.end()) {
@@ -1715,6 +1892,16 @@ bool CWallet::IsMine(const COutPoint& outpoint) const
     return IsMine(wtx->tx->vout[outpoint.n]);
 }
 
+bool CWallet::IsInvolvingWalletTxs(const CTransaction& tx) const
+{
+    AssertLockHeld(cs_wallet);
+    if (mapWallet.contains(tx.GetHash())) return true;
+    for (const CTxIn& txin : tx.vin) {
+        if (mapTxSpends.contains(txin.prevout) || GetTXO(txin.prevout)) return true;
+    }
+    return false;
+}
+
 bool CWallet::IsFromMe(const CTransaction& tx) const
 {
     LOCK(cs_wallet);
@@ -1770,6 +1957,7 @@ void CWallet::SetWalletFlagWithDB(WalletBatch& batch, uint64_t flags)
 {
     LOCK(cs_wallet);
     m_wallet_flags |= flags;
+    InvalidateCachedBalances();
     if (!batch.WriteWalletFlags(m_wallet_flags))
         throw std::runtime_error(std::string(__func__) + ": writing wallet flags failed");
 }
@@ -1784,6 +1972,7 @@ void CWallet::UnsetWalletFlagWithDB(WalletBatch& batch, uint64_t flag)
 {
     LOCK(cs_wallet);
     m_wallet_flags &= ~flag;
+    InvalidateCachedBalances();
     if (!batch.WriteWalletFlags(m_wallet_flags))
         throw std::runtime_error(std::string(__func__) + ": writing wallet flags failed");
 }
@@ -1902,11 +2091,15 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     uint256 block_hash = start_block;
     ScanResult result;
 
-    std::unique_ptr<FastWalletRescanFilter> fast_rescan_filter;
-    if (chain().hasBlockFilterIndex(BlockFilterType::BASIC)) fast_rescan_filter = std::make_unique<FastWalletRescanFilter>(*this);
+    const bool use_block_filter{chain().hasBlockFilterIndex(BlockFilterType::BASIC)};
+    RescanScriptSet scripts{*this};
+    // Blocks are read and matched against the wallet scripts by up to
+    // m_rescan_threads threads ahead of this loop, which applies them to the
+    // wallet in height order.
+    RescanPrefetcher prefetcher{chain(), m_rescan_threads, use_block_filter, max_height};
 
     WalletLogPrintf("Rescan started from block %s... (%s)\n", start_block.ToString(),
-                    fast_rescan_filter ? "fast variant using block filters" : "slow variant inspecting all blocks");
+                    use_block_filter ? "fast variant using block filters" : "slow variant inspecting all blocks");
 
     fAbortRescan = false;
     ShowProgress(strprintf("[%s] %s", DisplayName(), _("Rescanning…")), 0); // show rescan progress in GUI as dialog or on splashscreen, if rescan required on startup (e.g. due to corruption)
@@ -1933,21 +2126,19 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
             WalletLogPrintf("Still rescanning. At block %d. Progress=%f\n", block_height, progress_current);
         }
 
+        scripts.UpdateIfNeeded();
+        PrefetchedBlock prefetched{prefetcher.Get(block_hash, block_height, scripts.Current())};
         bool fetch_block{true};
-        if (fast_rescan_filter) {
-            fast_rescan_filter->UpdateIfNeeded();
-            auto matches_block{fast_rescan_filter->MatchesBlock(block_hash)};
-            if (matches_block.has_value()) {
-                if (*matches_block) {
-                    LogDebug(BCLog::SCAN, "Fast rescan: inspect block %d [%s] (filter matched)\n", block_height, block_hash.ToString());
-                } else {
-                    result.last_scanned_block = block_hash;
-                    result.last_scanned_height = block_height;
-                    fetch_block = false;
-                }
+        if (prefetched.filter_match.has_value()) {
+            if (*prefetched.filter_match) {
+                LogDebug(BCLog::SCAN, "Fast rescan: inspect block %d [%s] (filter matched)\n", block_height, block_hash.ToString());
             } else {
-                LogDebug(BCLog::SCAN, "Fast rescan: inspect block %d [%s] (WARNING: block filter not found!)\n", block_height, block_hash.ToString());
+                result.last_scanned_block = block_hash;
+                result.last_scanned_height = block_height;
+                fetch_block = false;
             }
+        } else if (use_block_filter) {
+            LogDebug(BCLog::SCAN, "Fast rescan: inspect block %d [%s] (WARNING: block filter not found!)\n", block_height, block_hash.ToString());
         }
 
         // Find next block separately from reading data above, because reading
@@ -1958,13 +2149,10 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
         chain().findBlock(block_hash, FoundBlock().inActiveChain(block_still_active).nextBlock(FoundBlock().inActiveChain(next_block).hash(next_block_hash)));
 
         if (fetch_block) {
-            // Read block data and locator if needed (the locator is usually null unless we need to save progress)
-            CBlock block;
+            const CBlock& block{prefetched.block};
+            // Read locator if needed (the locator is usually null unless we need to save progress)
             CBlockLocator loc;
-            // Find block
-            FoundBlock found_block{FoundBlock().data(block)};
-            if (save_progress && next_interval) found_block.locator(loc);
-            chain().findBlock(block_hash, found_block);
+            if (save_progress && next_interval) chain().findBlock(block_hash, FoundBlock().locator(loc));
 
             if (!block.IsNull()) {
                 LOCK(cs_wallet);
@@ -1975,8 +2163,16 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
                     result.status = ScanResult::FAILURE;
                     break;
                 }
+                // The script snapshot is only complete until a transaction is
+                // added, which may top up the keypool.
+                bool snapshot_current{true};
                 for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
-                    SyncTransaction(block.vtx[posInBlock], TxStateConfirmed{block_hash, block_height, static_cast<int>(posInBlock)}, fUpdate, /*rescanning_old_block=*/true);
+                    // A transaction that pays to none of the wallet scripts can
+                    // only be ours if it touches the wallet's transactions.
+                    if (snapshot_current && !prefetched.pays_to_scripts[posInBlock] && !IsInvolvingWalletTxs(*block.vtx[posInBlock])) continue;
+                    if (SyncTransaction(block.vtx[posInBlock], TxStateConfirmed{block_hash, block_height, static_cast<int>(posInBlock)}, fUpdate, /*rescanning_old_block=*/true)) {
+                        snapshot_current = false;
+                    }
                 }
                 // scan succeeded, record block as most recent successfully scanned
                 result.last_scanned_block = block_hash;
@@ -2081,7 +2277,10 @@ bool CWallet::SubmitTxMemoryPoolAndRelay(CWalletTx& wtx,
     // If transaction was previously in the mempool, it should be updated when
     // TransactionRemovedFromMempool fires.
     bool ret = chain().broadcastTransaction(wtx.tx, m_default_max_tx_fee, broadcast_method, err_string);
-    if (ret) wtx.m_state = TxStateInMempool{};
+    if (ret) {
+        wtx.m_state = TxStateInMempool{};
+        InvalidateCachedBalances();
+    }
     return ret;
 }
 
@@ -2891,6 +3090,7 @@ bool CWallet::SetAddressPreviouslySpent(WalletBatch& batch, const CTxDestination
     if (std::get_if<CNoDestination>(&dest))
         return false;
 
+    InvalidateCachedBalances();
     if (!used) {
         if (auto* data{common::FindKey(m_address_book, dest)}) data->previously_spent = false;
         return batch.WriteAddressPreviouslySpent(dest, false);
@@ -3107,12 +3307,31 @@ bool CWallet::LoadWalletArgs(std::shared_ptr<CWallet> wallet, const WalletContex
     wallet->m_signal_rbf = args.GetBoolArg("-walletrbf", DEFAULT_WALLET_RBF);
 
     wallet->m_keypool_size = std::max(args.GetIntArg("-keypool", DEFAULT_KEYPOOL_SIZE), int64_t{1});
+    wallet->m_keypool_threads = std::max(args.GetIntArg("-keypoolthreads", DEFAULT_KEYPOOL_THREADS), int64_t{1});
+    wallet->m_rescan_threads = std::max(args.GetIntArg("-rescanthreads", DEFAULT_RESCAN_THREADS), int64_t{1});
+    wallet->m_coin_selection_threads = std::max(args.GetIntArg("-coinselectionthreads", DEFAULT_COIN_SELECTION_THREADS), int64_t{1});
+    if (const int64_t timeout{args.GetIntArg("-coinselectiontimeout", count_milliseconds(DEFAULT_COIN_SELECTION_TIMEOUT))}; timeout > 0) {
+        wallet->m_coin_selection_timeout = std::chrono::milliseconds{timeout};
+    } else {
+        wallet->m_coin_selection_timeout.reset();
+    }
     wallet->m_notify_tx_changed_script = args.GetArg("-walletnotify", "");
     wallet->SetBroadcastTransactions(args.GetBoolArg("-walletbroadcast", DEFAULT_WALLETBROADCAST));
 
     return true;
 }
 
+ThreadPool* CWallet::GetCoinSelectionPool()
+{
+    AssertLockHeld(cs_wallet);
+    if (m_coin_selection_threads <= 1) return nullptr;
+    if (!m_coin_selection_pool) {
+        m_coin_selection_pool = std::make_unique<ThreadPool>("coinselect");
+        m_coin_selection_pool->Start(m_coin_selection_threads - 1);
+    }
+    return m_coin_selection_pool.get();
+}
+
 std::shared_ptr<CWallet> CWallet::CreateNew(WalletContext& context, const std::string& name, std::unique_ptr<WalletDatabase> database, uint64_t wallet_creation_flags, bilingual_str& error, std::vector<bilingual_str>& warnings)
 {
     interfaces::Chain* chain = context.chain;
@@ -3159,7 +3378,7 @@ std::shared_ptr<CWallet> CWallet::CreateNew(WalletContext& context, const std::s
     // Try to top up keypool. No-op if the wallet is locked.
     walletInstance->TopUpKeyPool();
 
-    if (chain && !AttachChain(walletInstance, *chain, /*rescan_required=*/false, error, warnings)) {
+    if (chain && !AttachChain(walletInstance, context, *chain, /*rescan_required=*/false, error, warnings)) {
         walletInstance->DisconnectChainNotifications();
         return nullptr;
     }
@@ -3200,7 +3419,7 @@ std::shared_ptr<CWallet> CWallet::LoadExisting(WalletContext& context, const std
     // Try to top up keypool. No-op if the wallet is locked.
     walletInstance->TopUpKeyPool();
 
-    if (chain && !AttachChain(walletInstance, *chain, rescan_required, error, warnings)) {
+    if (chain && !AttachChain(walletInstance, context, *chain, rescan_required, error, warnings)) {
         walletInstance->DisconnectChainNotifications();
         return nullptr;
     }
@@ -3211,8 +3430,13 @@ std::shared_ptr<CWallet> CWallet::LoadExisting(WalletContext& context, const std
 }
 
 
-bool CWallet::AttachChain(const std::shared_ptr<CWallet>& walletInstance, interfaces::Chain& chain, const bool rescan_required, bilingual_str& error, std::vector<bilingual_str>& warnings)
+bool CWallet::AttachChain(const std::shared_ptr<CWallet>& walletInstance, WalletContext& context, interfaces::Chain& chain, const bool rescan_required, bilingual_str& error, std::vector<bilingual_str>& warnings)
 {
+    const auto dispatcher{WITH_LOCK(context.wallets_mutex, {
+        if (!context.notification_dispatcher) context.notification_dispatcher = std::make_shared<ChainNotificationDispatcher>(chain);
+        return context.notification_dispatcher;
+    })};
+
     LOCK(walletInstance->cs_wallet);
     // allow setting the chain if it hasn't been set already but prevent changing it
     assert(!walletInstance->m_chain || walletInstance->m_chain == &chain);
@@ -3238,7 +3462,21 @@ bool CWallet::AttachChain(const std::shared_ptr<CWallet>& walletInstance, interf
     // be pending on the validation-side until lock release. Blocks that are connected while the
     // rescan is ongoing will not be processed in the rescan but with the block connected notifications,
     // so the wallet will only be completeley synced after the notifications delivery.
-    walletInstance->m_chain_notifications_handler = walletInstance->chain().handleNotifications(walletInstance);
+    // Notifications are delivered through a dispatcher shared by all wallets, which only
+    // passes on the transactions relevant to this one.
+    {
+        std::vector<CScript> scripts;
+        scripts.reserve(walletInstance->m_cached_spks.size());
+        for (const auto& [script, _] : walletInstance->m_cached_spks) scripts.push_back(script);
+        std::vector<Txid> txids;
+        txids.reserve(walletInstance->mapWallet.size());
+        for (const auto& [txid, _] : walletInstance->mapWallet) txids.push_back(txid);
+        std::vector<COutPoint> spent;
+        spent.reserve(walletInstance->mapTxSpends.size());
+        for (const auto& [outpoint, _] : walletInstance->mapTxSpends) spent.push_back(outpoint);
+        walletInstance->m_notification_dispatcher = dispatcher;
+        walletInstance->m_chain_notifications_handler = dispatcher->Register(walletInstance, scripts, txids, spent);
+    }
 
     // If rescan_required = true, rescan_height remains equal to 0
     int rescan_height = 0;
@@ -4014,6 +4252,7 @@ util::Result<void> CWallet::ApplyMigrationData(WalletBatch& local_wallet_batch,
 
     // Update m_txos to match the descriptors remaining in this wallet
     m_txos.clear();
+    InvalidateCachedBalances();
     RefreshAllTXOs();
 
     // Check if the transactions in the wallet are still ours. Either they belong here, or they belong in the watchonly wallet.
@@ -4531,8 +4770,20 @@ util::Result<MigrationResult> MigrateLegacyToDescriptor(std::shared_ptr<CWallet>
 
 void CWallet::CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyMan* spkm)
 {
+    // Grow the prefilter geometrically, so rebuilding it stays amortized constant time per script
+    const size_t needed{m_cached_spks.size() + spks.size()};
+    if (needed > m_cached_spks_filter.Capacity()) {
+        m_cached_spks_filter.Reset(2 * needed);
+        for (const auto& [script, _] : m_cached_spks) {
+            m_cached_spks_filter.Insert(script);
+        }
+    }
     for (const auto& script : spks) {
         m_cached_spks[script].push_back(spkm);
+        m_cached_spks_filter.Insert(script);
+    }
+    if (m_notification_dispatcher) {
+        m_notification_dispatcher->AddScripts(*this, std::vector<CScript>(spks.begin(), spks.end()));
     }
 }
 
@@ -4596,6 +4847,7 @@ void CWallet::WriteBestBlock() const
 void CWallet::RefreshTXOsFromTx(const CWalletTx& wtx)
 {
     AssertLockHeld(cs_wallet);
+    InvalidateCachedBalances();
     for (uint32_t i = 0; i < wtx.tx->vout.size(); ++i) {
         const CTxOut& txout = wtx.tx->vout.at(i);
         if (!IsMine(txout)) continue;
@@ -4625,6 +4877,25 @@ std::optional<WalletTXO> CWallet::GetTXO(const COutPoint& outpoint) const
     return it->second;
 }
 
+const Balance* CWallet::GetCachedBalance(int min_depth, bool avoid_reuse, bool include_nonmempool) const
+{
+    AssertLockHeld(cs_wallet);
+    const auto it{m_cached_balances.find({min_depth, avoid_reuse, include_nonmempool})};
+    return it == m_cached_balances.end() ? nullptr : &it->second;
+}
+
+void CWallet::CacheBalance(int min_depth, bool avoid_reuse, bool include_nonmempool, const Balance& balance) const
+{
+    AssertLockHeld(cs_wallet);
+    m_cached_balances.insert_or_assign({min_depth, avoid_reuse, include_nonmempool}, balance);
+}
+
+void CWallet::InvalidateCachedBalances() const
+{
+    AssertLockHeld(cs_wallet);
+    m_cached_balances.clear();
+}
+
 void CWallet::DisconnectChainNotifications()
 {
     if (m_chain_notifications_handler) {
@@ -28,10 +28,12 @@
 #include <util/hasher.h>
 #include <util/result.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/ui_change_type.h>
 #include <wallet/crypter.h>
 #include <wallet/db.h>
+#include <wallet/scriptfilter.h>
 #include <wallet/scriptpubkeyman.h>
 #include <wallet/transaction.h>
 #include <wallet/types.h>
@@ -47,11 +49,14 @@
 #include <memory>
 #include <optional>
 #include <set>
+#include <span>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+class CBlock;
 class CKey;
 class CKeyID;
 class CPubKey;
@@ -82,6 +87,7 @@ using LoadWalletFn = std::function<void(std::unique_ptr<interfaces::Wallet> wall
 struct bilingual_str;
 
 namespace wallet {
+class ChainNotificationDispatcher;
 struct WalletContext;
 
 //! Explicitly delete the wallet.
@@ -130,6 +136,12 @@ static const unsigned int DEFAULT_TX_CONFIRM_TARGET = 6;
 //! -walletrbf default
 static const bool DEFAULT_WALLET_RBF = true;
 static const bool DEFAULT_WALLETBROADCAST = true;
+//! -rescanthreads default. Reading ahead has only been measured to pay off with several cores and block reads from disk.
+static constexpr int DEFAULT_RESCAN_THREADS{1};
+//! -coinselectionthreads default
+static constexpr int DEFAULT_COIN_SELECTION_THREADS{4};
+//! -coinselectiontimeout default
+static constexpr std::chrono::milliseconds DEFAULT_COIN_SELECTION_TIMEOUT{2000};
 static const bool DEFAULT_DISABLE_WALLET = false;
 static const bool DEFAULT_WALLETCROSSCHAIN = false;
 //! -maxtxfee default
@@ -377,6 +389,13 @@ private:
 
     bool SyncTransaction(const CTransactionRef& tx, const SyncTxState& state, bool update_tx = true, bool rescanning_old_block = false) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /**
+     * Call fn with the index of every transaction of block at tx_indexes, or of all of them if
+     * unset. tx_indexes was matched against the scripts the wallet had before the block, so once
+     * a transaction adds scripts, e.g. by topping up the keypool, all later ones are scanned.
+     */
+    void ForEachBlockTx(const CBlock& block, std::optional<std::span<const size_t>> tx_indexes, const std::function<void(size_t)>& fn) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     /** WalletFlags set on this wallet. */
     std::atomic<uint64_t> m_wallet_flags{0};
 
@@ -432,16 +451,24 @@ private:
 
     //! Cache of descriptor ScriptPubKeys used for IsMine. Maps ScriptPubKey to set of spkms
     std::unordered_map<CScript, std::vector<ScriptPubKeyMan*>, SaltedSipHasher> m_cached_spks;
+    //! Prefilter over the keys of m_cached_spks, so IsMine can reject foreign scripts without probing the map
+    ScriptPubKeyFilter m_cached_spks_filter;
 
     //! Set of both spent and unspent transaction outputs owned by this wallet
     std::unordered_map<COutPoint, WalletTXO, SaltedOutpointHasher> m_txos GUARDED_BY(cs_wallet);
 
+    //! Workers for concurrent coin selection, see GetCoinSelectionPool
+    std::unique_ptr<ThreadPool> m_coin_selection_pool GUARDED_BY(cs_wallet);
+
+    //! Results of GetBalance by (min_depth, avoid_reuse, include_nonmempool), valid until InvalidateCachedBalances
+    mutable std::map<std::tuple<int, bool, bool>, Balance> m_cached_balances GUARDED_BY(cs_wallet);
+
     /**
      * Catch wallet up to current chain, scanning new blocks, updating the best
      * block locator and m_last_block_processed, and registering for
      * notifications about new blocks and transactions.
      */
-    static bool AttachChain(const std::shared_ptr<CWallet>& wallet, interfaces::Chain& chain, bool rescan_required, bilingual_str& error, std::vector<bilingual_str>& warnings);
+    static bool AttachChain(const std::shared_ptr<CWallet>& wallet, WalletContext& context, interfaces::Chain& chain, bool rescan_required, bilingual_str& error, std::vector<bilingual_str>& warnings);
 
     static NodeClock::time_point GetDefaultNextResend();
 
@@ -514,6 +541,8 @@ public:
 
     /** Registered interfaces::Chain::Notifications handler. */
     std::unique_ptr<interfaces::Handler> m_chain_notifications_handler;
+    /** Dispatcher delivering chain notifications to this wallet, which is told about new scripts and transactions. Set once by AttachChain. */
+    std::shared_ptr<ChainNotificationDispatcher> m_notification_dispatcher;
 
     /** Interface for accessing chain state. */
     interfaces::Chain& chain() const { assert(m_chain); return *m_chain; }
@@ -525,6 +554,11 @@ public:
     const std::unordered_map<COutPoint, WalletTXO, SaltedOutpointHasher>& GetTXOs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) { AssertLockHeld(cs_wallet); return m_txos; };
     std::optional<WalletTXO> GetTXO(const COutPoint& outpoint) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    const Balance* GetCachedBalance(int min_depth, bool avoid_reuse, bool include_nonmempool) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    void CacheBalance(int min_depth, bool avoid_reuse, bool include_nonmempool, const Balance& balance) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Drop cached balances. Must be called on any change to wallet transactions, their states or spends, or the chain tip */
+    void InvalidateCachedBalances() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     /** Cache outputs that belong to the wallet from a single transaction */
     void RefreshTXOsFromTx(const CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     /** Cache outputs that belong to the wallet for all transactions in the wallet */
@@ -634,6 +668,13 @@ public:
     void transactionAddedToMempool(const CTransactionRef& tx) override;
     void blockConnected(const kernel::ChainstateRole& role, const interfaces::BlockInfo& block) override;
     void blockDisconnected(const interfaces::BlockInfo& block) override;
+    /**
+     * Process a connected or disconnected block, only scanning its transactions at
+     * tx_indexes. Used by ChainNotificationDispatcher, which already determined that
+     * the other transactions are not relevant to this wallet.
+     */
+    void ConnectBlock(const kernel::ChainstateRole& role, const interfaces::BlockInfo& block, std::optional<std::span<const size_t>> tx_indexes);
+    void DisconnectBlock(const interfaces::BlockInfo& block, std::optional<std::span<const size_t>> tx_indexes);
     void updatedBlockTip() override;
     int64_t RescanFromTime(int64_t startTime, const WalletRescanReserver& reserver, bool update);
 
@@ -742,6 +783,19 @@ public:
 
     /** Number of pre-generated keys/scripts by each spkm (part of the look-ahead process, used to detect payments) */
     int64_t m_keypool_size{DEFAULT_KEYPOOL_SIZE};
+    /** Number of threads deriving new keys/scripts when topping up the keypool */
+    int m_keypool_threads{DEFAULT_KEYPOOL_THREADS};
+
+    /** Number of threads reading blocks during a rescan */
+    int m_rescan_threads{DEFAULT_RESCAN_THREADS};
+
+    /** Number of threads the coin selection algorithms may run on concurrently */
+    int m_coin_selection_threads{DEFAULT_COIN_SELECTION_THREADS};
+    /** Pool of m_coin_selection_threads - 1 workers shared by all coin selections of this wallet,
+     * started the first time it is needed. Returns nullptr if selection runs on one thread. */
+    ThreadPool* GetCoinSelectionPool() EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Time budget of each coin selection attempt, none if unset */
+    std::optional<std::chrono::milliseconds> m_coin_selection_timeout{DEFAULT_COIN_SELECTION_TIMEOUT};
 
     /** Notify external script when a wallet transaction comes in or is updated (handled by -walletnotify) */
     std::string m_notify_tx_changed_script;
@@ -790,6 +844,8 @@ public:
     bool IsMine(const CTxOut& txout) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     bool IsMine(const CTransaction& tx) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     bool IsMine(const COutPoint& outpoint) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Whether tx is, spends from or conflicts with a wallet transaction */
+    bool IsInvolvingWalletTxs(const CTransaction& tx) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     /** should probably be renamed to IsRelevantToMe */
     bool IsFromMe(const CTransaction& tx) const;
     CAmount GetDebit(const CTransaction& tx) const;
@@ -1065,6 +1121,7 @@ public:
     void CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyMan* spkm);
 
     void TopUpCallback(const std::set<CScript>& spks, ScriptPubKeyMan* spkm) override;
+    int TopUpThreads() const override { return m_keypool_threads; }
 
     //! Retrieve the xpubs in use by the active descriptors
     std::set<CExtPubKey> GetActiveHDPubKeys() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
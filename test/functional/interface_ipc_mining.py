@@ -278,6 +278,18 @@ class IPCMiningTest(BitcoinTestFramework):
                 block4 = await mining_get_block(template6, ctx)
                 assert_equal(len(block4.vtx), 3)
 
+                self.log.debug("The delta to the previous template only contains the new transaction")
+                delta = (await template6.getDelta(ctx)).result
+                assert_equal(len(delta.removed), 0)
+                assert_equal(len(delta.added), 1)
+                added_tx = CTransaction()
+                added_tx.deserialize(BytesIO(bytes(delta.added[0])))
+                assert added_tx.txid_hex in [tx.txid_hex for tx in block4.vtx[1:]]
+                assert_equal(sorted(delta.txOrder), [0, 1])
+                assert_equal(delta.fees, delta.previousFees + delta.addedFees[0])
+                merkle_path = (await template6.getCoinbaseMerklePath(ctx)).result
+                assert_equal([bytes(h) for h in delta.coinbaseMerklePath], [bytes(h) for h in merkle_path])
+
                 self.log.debug("Wait for another, but time out, since the fee threshold is set now")
                 template7 = await mining_wait_next_template(template6, stack, ctx, waitoptions)
                 assert template7 is None
@@ -17,6 +17,7 @@ from test_framework.messages import (
     BLOCK_HEADER_SIZE,
     COIN,
     deser_block_spent_outputs,
+    deser_compact_size,
 )
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import (
@@ -457,6 +458,30 @@ class RESTTest (BitcoinTestFramework):
                 expected = [(p["scriptPubKey"], p["value"]) for p in prevouts]
                 assert_equal(expected, actual)
 
+        self.log.info("Test the /spenttxouts URI with a block count")
+        # Request more blocks than there are left, so the range ends at the tip
+        start_height = max(0, block_count - 49)
+        start_hash = self.nodes[0].getblockhash(start_height)
+        batch_bin = self.test_rest_request(f"/spenttxouts/{start_hash}", req_type=ReqType.BIN, ret_type=RetType.BYTES, query_params={"count": 60})
+        batch_json = self.test_rest_request(f"/spenttxouts/{start_hash}", query_params={"count": 60})
+        assert_equal(len(batch_json), block_count - start_height + 1)
+        f = BytesIO(batch_bin)
+        assert_equal(deser_compact_size(f), block_count - start_height + 1)
+        for height, entry in enumerate(batch_json, start=start_height):
+            blockhash = self.nodes[0].getblockhash(height)
+            assert_equal(entry["blockhash"], blockhash)
+            assert_equal(entry["height"], height)
+            assert_equal(entry["spenttxouts"], self.test_rest_request(f"/spenttxouts/{blockhash}"))
+            assert_equal(f.read(32)[::-1].hex(), blockhash)
+            single_bin = self.test_rest_request(f"/spenttxouts/{blockhash}", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+            batch_spent = [[txout.serialize() for txout in tx] for tx in deser_block_spent_outputs(f)]
+            single_spent = [[txout.serialize() for txout in tx] for tx in deser_block_spent_outputs(BytesIO(single_bin))]
+            assert_equal(batch_spent, single_spent)
+        assert_equal(f.read(), b"")
+        for invalid_count in ["0", "101", "abc"]:
+            resp = self.test_rest_request(f"/spenttxouts/{start_hash}", status=400, ret_type=RetType.OBJ, query_params={"count": invalid_count})
+            assert_equal(resp.read().decode('utf-8').rstrip(), f"Block count is invalid or out of acceptable range (1-100): {invalid_count}")
+
         self.log.info("Test the /blockpart URI")
 
         blockhash = self.nodes[0].getbestblockhash()
@@ -523,5 +548,19 @@ class RESTTest (BitcoinTestFramework):
         resp = self.test_rest_request(f"/deploymentinfo/{INVALID_PARAM}", ret_type=RetType.OBJ, status=400)
         assert_equal(resp.read().decode('utf-8').rstrip(), f"Invalid hash: {INVALID_PARAM}")
 
+        self.log.info("Test that large JSON responses are streamed in chunks")
+        large_tx = self.wallet.send_self_transfer_multi(from_node=self.nodes[0], num_outputs=600)
+        resp = self.test_rest_request(f"/tx/{large_tx['txid']}", ret_type=RetType.OBJ)
+        assert_equal(resp.getheader('transfer-encoding'), 'chunked')
+        assert_equal(json.loads(resp.read().decode('utf-8'), parse_float=Decimal), self.nodes[0].getrawtransaction(large_tx['txid'], True))
+        large_blockhash = self.generate(self.nodes[0], 1)[0]
+        resp = self.test_rest_request(f"/block/{large_blockhash}", ret_type=RetType.OBJ)
+        assert_equal(resp.getheader('transfer-encoding'), 'chunked')
+        assert_equal(json.loads(resp.read().decode('utf-8'), parse_float=Decimal), self.nodes[0].getblock(large_blockhash, 3))
+        # Small responses are still sent in one piece
+        resp = self.test_rest_request("/chaininfo", ret_type=RetType.OBJ)
+        assert_equal(resp.getheader('transfer-encoding'), None)
+        assert resp.getheader('content-length') is not None
+
 if __name__ == '__main__':
     RESTTest(__file__).main()
@@ -7,11 +7,14 @@
 import json
 import os
 from dataclasses import dataclass
+from test_framework.address import ADDRESS_BCRT1_UNSPENDABLE
 from test_framework.test_framework import BitcoinTestFramework
-from test_framework.util import assert_equal, assert_greater_than_or_equal
+from test_framework.util import assert_equal, assert_greater_than_or_equal, str_to_b64str
 from threading import Thread
 from typing import Optional
+import http.client
 import subprocess
+import urllib.parse
 
 
 RPC_INVALID_PARAMETER      = -8
@@ -177,6 +180,40 @@ class RPCInterfaceTest(BitcoinTestFramework):
             request_fields={"jsonrpc": "2.1"},
             response_fields={"result": None, "error": {"code": RPC_INVALID_REQUEST, "message": "JSON-RPC version not supported"}}))
 
+    def test_dependent_batch_request(self):
+        self.log.info("Testing that batch elements run in order by default...")
+        start_height = self.nodes[0].getblockcount()
+        request = []
+        for idx in range(10):
+            request.append({"jsonrpc": "2.0", "id": 2 * idx, "method": "generatetoaddress", "params": [1, ADDRESS_BCRT1_UNSPENDABLE]})
+            request.append({"jsonrpc": "2.0", "id": 2 * idx + 1, "method": "getblockcount"})
+        rpc_response, http_status = send_json_rpc(self.nodes[0], request)
+        assert_equal(http_status, 200)
+        # Every getblockcount sees the block generated right before it
+        assert_equal([r["result"] for r in rpc_response[1::2]], list(range(start_height + 1, start_height + 11)))
+        # Later tests expect the chain they started with
+        self.nodes[0].invalidateblock(self.nodes[0].getblockhash(start_height + 1))
+
+    def test_parallel_batch_request(self):
+        self.log.info("Testing large batch request executed on several threads...")
+        self.restart_node(0, ['-rpcbatchthreads=4', '-rpcthreads=4'])
+        genesis_hash = self.nodes[0].getblockhash(0)
+        request = []
+        response = []
+        for idx in range(500):
+            if idx % 7 == 0:
+                request.append({"jsonrpc": "2.0", "id": idx, "method": "invalidmethod"})
+                response.append({"jsonrpc": "2.0", "id": idx, "error": {"code": RPC_METHOD_NOT_FOUND, "message": "Method not found"}})
+            elif idx % 11 == 0:
+                request.append({"jsonrpc": "2.0", "method": "getblockcount"})
+            else:
+                request.append({"jsonrpc": "2.0", "id": idx, "method": "getblockhash", "params": [0]})
+                response.append({"jsonrpc": "2.0", "id": idx, "result": genesis_hash})
+        rpc_response, http_status = send_json_rpc(self.nodes[0], request)
+        assert_equal(http_status, 200)
+        # Responses are returned in request order
+        assert_equal(rpc_response, response)
+
     def test_http_status_codes(self):
         self.log.info("Testing HTTP status codes for JSON-RPC 1.1 requests...")
         # OK
@@ -238,10 +275,76 @@ class RPCInterfaceTest(BitcoinTestFramework):
         for t in threads:
             t.join()
 
+    def http_request(self, method, path, body=None, auth=True):
+        url = urllib.parse.urlparse(self.nodes[0].url)
+        headers = {"Authorization": f"Basic {str_to_b64str(f'{url.username}:{url.password}')}"} if auth else {}
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request(method, path, body, headers)
+        response = conn.getresponse()
+        data = response.read()
+        conn.close()
+        return response, data
+
+    def test_rpc_stats(self):
+        self.log.info("Testing getrpcstats...")
+        self.restart_node(0, ['-rpcmetrics'])
+        node = self.nodes[0]
+        node.getblockhash(0)
+        node.getblockhash(0)
+        expect_http_rpc_status(500, -8, node, "getblockhash", [1000])
+        stats = node.getrpcstats()
+        buckets = stats["latency_buckets"]
+        assert_equal(buckets, sorted(buckets))
+        getblockhash = stats["methods"]["getblockhash"]
+        assert_equal(getblockhash["calls"], 3)
+        assert_equal(getblockhash["errors"], 1)
+        assert_equal(getblockhash["in_flight"], 0)
+        assert_equal(len(getblockhash["latency_histogram"]), len(buckets) + 1)
+        assert_equal(sum(getblockhash["latency_histogram"]), 3)
+        # The call asking for the stats is still executing
+        assert_equal(stats["methods"]["getrpcstats"]["calls"], 0)
+        assert_equal(stats["methods"]["getrpcstats"]["in_flight"], 1)
+        # Methods that were never called are left out
+        assert "getchaintips" not in stats["methods"]
+
+        self.log.info("Testing that traffic is attributed to single requests only...")
+        body = json.dumps({"jsonrpc": "2.0", "method": "getbestblockhash", "params": [], "id": 1}).encode("utf-8")
+        response, data = self.http_request("POST", "/", body)
+        assert_equal(response.status, 200)
+        batch = [{"jsonrpc": "2.0", "method": "getbestblockhash", "params": [], "id": i} for i in range(2)]
+        send_json_rpc(node, batch)
+        getbestblockhash = node.getrpcstats()["methods"]["getbestblockhash"]
+        assert_equal(getbestblockhash["calls"], 3)
+        assert_equal(getbestblockhash["bytes_in"], len(body))
+        assert_equal(getbestblockhash["bytes_out"], len(data))
+
+        self.log.info("Testing /metrics...")
+        response, data = self.http_request("GET", "/metrics")
+        assert_equal(response.status, 200)
+        assert response.getheader("Content-Type").startswith("text/plain")
+        metrics = data.decode("utf-8").splitlines()
+        assert 'bitcoin_rpc_calls_total{method="getblockhash"} 3' in metrics
+        assert 'bitcoin_rpc_errors_total{method="getblockhash"} 1' in metrics
+        assert 'bitcoin_rpc_in_flight{method="getblockhash"} 0' in metrics
+        assert 'bitcoin_rpc_latency_seconds_bucket{method="getblockhash",le="+Inf"} 3' in metrics
+        assert 'bitcoin_rpc_latency_seconds_count{method="getblockhash"} 3' in metrics
+        # Buckets are cumulative
+        counts = [int(line.split()[-1]) for line in metrics if line.startswith('bitcoin_rpc_latency_seconds_bucket{method="getblockhash"')]
+        assert_equal(len(counts), len(buckets) + 1)
+        assert_equal(counts, sorted(counts))
+        assert_equal(self.http_request("GET", "/metrics", auth=False)[0].status, 401)
+        assert_equal(self.http_request("POST", "/metrics", b"")[0].status, 405)
+
+        self.restart_node(0)
+        assert_equal(self.http_request("GET", "/metrics")[0].status, 404)
+
     def run_test(self):
         self.test_getrpcinfo()
         self.test_batch_requests()
+        self.test_dependent_batch_request()
+        self.test_parallel_batch_request()
         self.test_http_status_codes()
+        self.test_rpc_stats()
         self.test_work_queue_exceeded()
 
 
@@ -388,6 +388,28 @@ class MempoolClusterTest(BitcoinTestFramework):
         first_chunk_info = node.getmempoolcluster(first_chunk_tx["txid"])
         assert_equal(first_chunk_info, {'clusterweight': first_chunkweight + second_chunkweight + third_chunkweight, 'txcount': 3, 'chunks': [{'chunkfee': first_chunk_tx["fee"], 'chunkweight': first_chunkweight, 'txs': [first_chunk_tx["txid"]]}, {'chunkfee': second_chunk_tx["fee"] + 2*third_chunk_tx["fee"] + Decimal("0.00000001"), 'chunkweight': second_chunkweight + third_chunkweight, 'txs': [second_chunk_tx["txid"], third_chunk_tx["txid"]]}]})
 
+    def test_background_linearization(self):
+        node = self.nodes[0]
+        self.log.info("Test improving cluster linearizations on a background thread")
+        self.generate(node, 1)
+        assert "backgroundlinearization" not in node.getmempoolinfo()
+        self.restart_node(0, extra_args=["-mempoolbackgroundlinearization"])
+        assert_equal(node.getmempoolinfo()["backgroundlinearization"], {"jobs": 0, "discarded": 0, "duration": 0})
+
+        # Create a cluster whose linearization is left to the background thread
+        parent = self.wallet.send_self_transfer_multi(from_node=node, num_outputs=5)
+        for utxo in parent["new_utxos"]:
+            self.wallet.send_self_transfer_chain(from_node=node, utxo_to_spend=utxo, chain_length=5)
+        assert_equal(node.getmempoolinfo()["size"], 26)
+        self.wait_until(lambda: node.getmempoolinfo()["optimal"])
+        info = node.getmempoolinfo()
+        assert_equal(info["nonoptimalclusters"], 0)
+        assert_greater_than_or_equal(info["backgroundlinearization"]["jobs"], info["backgroundlinearization"]["discarded"])
+
+        # The mempool is still usable for block building
+        self.generate(node, 1)
+        assert_equal(node.getmempoolinfo()["size"], 0)
+
     def run_test(self):
         node = self.nodes[0]
         self.wallet = MiniWallet(node)
@@ -413,6 +435,8 @@ class MempoolClusterTest(BitcoinTestFramework):
             if cluster_count_limit > 10:
                 self.test_cluster_merging(cluster_count_limit)
 
+        self.test_background_linearization()
+
 
 if __name__ == '__main__':
     MempoolClusterTest(__file__).main()
@@ -126,7 +126,7 @@ class EphemeralDustTest(BitcoinTestFramework):
         assert_equal(self.nodes[0].getrawmempool(), [])
 
     def test_node_restart(self):
-        self.log.info("Test that an ephemeral package is rejected on restart due to individual evaluation")
+        self.log.info("Test that an ephemeral package is reloaded as a package on restart")
 
         assert_equal(self.nodes[0].getrawmempool(), [])
         dusty_tx, sweep_tx = self.create_ephemeral_dust_package(tx_version=3)
@@ -136,13 +136,16 @@ class EphemeralDustTest(BitcoinTestFramework):
         assert_equal(len(self.nodes[0].getrawmempool()), 2)
         assert_mempool_contents(self, self.nodes[0], expected=[dusty_tx["tx"], sweep_tx["tx"]])
 
-        # Node restart; doesn't allow ephemeral transaction back in due to individual submission
-        # resulting in 0-fee. Supporting re-submission of CPFP packages on restart is desired but not
-        # yet implemented.
+        # Node restart; the 0-fee parent would be rejected on its own, but mempool.dat loading
+        # submits it together with its sweeping child as a package.
         self.restart_node(0)
         self.restart_node(1)
         self.connect_nodes(0, 1)
-        assert_mempool_contents(self, self.nodes[0], expected=[])
+        assert_mempool_contents(self, self.nodes[0], expected=[dusty_tx["tx"], sweep_tx["tx"]])
+
+        # Leave the mempool empty for the following tests
+        self.generate(self.nodes[0], 1)
+        assert_equal(self.nodes[0].getrawmempool(), [])
 
     def test_fee_having_parent(self):
         self.log.info("Test that a transaction with ephemeral dust may not have non-0 base fee")
@@ -15,6 +15,7 @@ from test_framework.util import (
     assert_equal,
     assert_fee_amount,
     assert_greater_than,
+    assert_greater_than_or_equal,
     assert_raises_rpc_error,
 )
 from test_framework.wallet import (
@@ -279,6 +280,11 @@ class MempoolLimitTest(BitcoinTestFramework):
         for wtxid in [tx_parent_just_below["wtxid"], tx_child_just_above["wtxid"]]:
             assert_equal(res["tx-results"][wtxid]["error"], "mempool full")
 
+        self.log.info("Check that the memory arena of evicted entries is still allocated")
+        mempool_info = node.getmempoolinfo()
+        assert_greater_than_or_equal(mempool_info["maxmempool"], mempool_info["usage"])
+        assert_greater_than(mempool_info["allocated"], mempool_info["usage"])
+
         self.log.info('Test passing a value below the minimum (5 MB) to -maxmempool throws an error')
         self.stop_node(0)
         self.nodes[0].assert_start_raises_init_error(["-maxmempool=4"], "Error: -maxmempool must be at least 5 MB")
@@ -195,6 +195,7 @@ class MempoolPersistTest(BitcoinTestFramework):
         os.rmdir(mempooldotnew1)
 
         self.test_importmempool_union()
+        self.test_importmempool_package()
         self.test_persist_unbroadcast()
 
     def test_persist_unbroadcast(self):
@@ -259,6 +260,26 @@ class MempoolPersistTest(BitcoinTestFramework):
         assert_equal(entry_node01_secret["fees"]["base"] + 5, entry_node01_secret["fees"]["modified"])
         self.stop_nodes()
 
+    def test_importmempool_package(self):
+        self.log.debug("Check that a low fee parent is loaded as a package with its child")
+        self.start_node(0)
+        # Pre-verify the scripts on a worker thread
+        self.start_node(1, extra_args=["-par=2"])
+        self.start_node(2)
+        parent = self.mini_wallet.create_self_transfer(fee=0, fee_rate=0, confirmed_only=True, version=3)
+        child = self.mini_wallet.create_self_transfer(utxo_to_spend=parent["new_utxo"], fee_rate=Decimal("0.0005"), version=3)
+        # The parent is only accepted on its own because of its prioritisation
+        self.nodes[0].prioritisetransaction(parent["txid"], 0, COIN)
+        self.nodes[0].sendrawtransaction(parent["hex"])
+        self.nodes[0].sendrawtransaction(child["hex"])
+
+        mempooldat0 = self.nodes[0].savemempool()["filename"]
+        with self.nodes[1].assert_debug_log(["succeeded (2 in packages)"]):
+            assert_equal({}, self.nodes[1].importmempool(mempooldat0))
+        assert parent["txid"] in self.nodes[1].getrawmempool()
+        assert child["txid"] in self.nodes[1].getrawmempool()
+        self.stop_nodes()
+
 
 if __name__ == "__main__":
     MempoolPersistTest(__file__).main()
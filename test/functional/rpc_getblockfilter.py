@@ -54,6 +54,16 @@ class GetBlockFilterTest(BitcoinTestFramework):
         genesis_hash = self.nodes[0].getblockhash(0)
         assert_raises_rpc_error(-5, "Unknown filtertype", self.nodes[0].getblockfilter, genesis_hash, "unknown")
 
+        self.log.info("Test building the index with parallel index workers")
+        self.generate(self.nodes[0], 20)
+        self.stop_node(1)
+        self.nodes[1].assert_start_raises_init_error(["-indexworkers=-1"], "Error: Invalid -indexworkers value -1, must be between 0 and 64.")
+        self.start_node(1, extra_args=["-blockfilterindex", "-indexworkers=2"])
+        self.wait_until(lambda: self.nodes[1].getindexinfo()["basic block filter index"]["synced"])
+        for height in range(self.nodes[0].getblockcount() + 1):
+            block_hash = self.nodes[0].getblockhash(height)
+            assert_equal(self.nodes[1].getblockfilter(block_hash), self.nodes[0].getblockfilter(block_hash))
+
         # Test getblockfilter fails on node without compact block filter index
         self.restart_node(0, extra_args=["-blockfilterindex=0"])
         for filter_type in FILTER_TYPES:
@@ -74,6 +74,24 @@ class RpcMiscTest(BitcoinTestFramework):
 
         assert_raises_rpc_error(-8, "unknown mode foobar", node.getmemoryinfo, mode="foobar")
 
+        self.log.info("test getmemoryinfo block cache statistics")
+        assert "blockcache" not in node.getmemoryinfo()
+        self.restart_node(0, ["-blockcachesize=10"])
+        blockhash = node.getbestblockhash()
+        before = node.getmemoryinfo()["blockcache"]
+        for _ in range(3):
+            node.getblock(blockhash)  # serialized read
+            node.getblockstats(blockhash)  # deserialized read
+        cache = node.getmemoryinfo()["blockcache"]
+        assert_equal(cache["max_usage"], 10 * 1024 * 1024)
+        assert_greater_than(cache["entries"], 0)
+        assert_greater_than(cache["usage"], 0)
+        for kind in ["", "raw_"]:
+            hits = cache[f"{kind}hits"] - before[f"{kind}hits"]
+            misses = cache[f"{kind}misses"] - before[f"{kind}misses"]
+            assert_equal(hits + misses, 3)
+            assert_greater_than_or_equal(hits, 2)
+
         self.log.info("test logging rpc and help")
 
         # Test toggling a logging category on/off/on with the logging RPC.
@@ -100,7 +118,7 @@ class RpcMiscTest(BitcoinTestFramework):
         assert_equal(node.getindexinfo(), {})
 
         # Restart the node with indices and wait for them to sync
-        self.restart_node(0, ["-txindex", "-blockfilterindex", "-coinstatsindex", "-txospenderindex"])
+        self.restart_node(0, ["-txindex", "-blockfilterindex", "-coinstatsindex", "-txospenderindex", "-scriptindex"])
         self.wait_until(lambda: all(i["synced"] for i in node.getindexinfo().values()))
 
         # Returns a list of all running indices by default
@@ -112,10 +130,11 @@ class RpcMiscTest(BitcoinTestFramework):
                 "basic block filter index": values,
                 "coinstatsindex": values,
                 "txospenderindex": values,
+                "scriptindex": values,
             }
         )
         # Specifying an index by name returns only the status of that index
-        for i in {"txindex", "basic block filter index", "coinstatsindex", "txospenderindex"}:
+        for i in {"txindex", "basic block filter index", "coinstatsindex", "txospenderindex", "scriptindex"}:
             assert_equal(node.getindexinfo(i), {i: values})
 
         # Specifying an unknown index name returns an empty result
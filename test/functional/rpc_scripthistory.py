@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the getscripthistory RPC and the /rest/scripthistory endpoint."""
+
+from decimal import Decimal
+import http.client
+import json
+import urllib.parse
+
+from test_framework.messages import COIN
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import (
+    MiniWallet,
+    getnewdestination,
+)
+
+
+class ScriptHistoryTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.setup_clean_chain = True
+        self.extra_args = [["-scriptindex", "-rest"]]
+
+    def rest_script_history(self, script_hex, query=""):
+        url = urllib.parse.urlparse(self.nodes[0].url)
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request("GET", f"/rest/scripthistory/{script_hex}.json{query}")
+        response = conn.getresponse()
+        return response.status, response.read().decode()
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.wallet = MiniWallet(node)
+        self.generate(self.wallet, 110)
+        self.wait_until(lambda: node.getindexinfo("scriptindex")["scriptindex"]["synced"])
+
+        self.test_funding_and_spending()
+        self.test_pagination()
+        self.test_rest()
+        self.test_reorg()
+        self.test_errors()
+
+    def test_funding_and_spending(self):
+        self.log.info("Test that outputs paying to a script and their spends are returned")
+        node = self.nodes[0]
+        _, spk, _ = getnewdestination()
+        self.send = self.wallet.send_to(from_node=node, scriptPubKey=spk, amount=COIN)
+        self.generate(self.wallet, 1)
+        self.spk_hex = spk.hex()
+
+        assert_equal(node.getscripthistory(self.spk_hex), {"history": [{
+            "type": "funding",
+            "height": 111,
+            "txid": self.send["txid"],
+            "vout": self.send["sent_vout"],
+            "value": Decimal("1.00000000"),
+        }]})
+
+        # The sending transaction spent one of the wallet outputs
+        history = node.getscripthistory(self.wallet.get_output_script().hex(), 1000)["history"]
+        spends = [entry for entry in history if entry["type"] == "spending"]
+        assert_equal(len(spends), 1)
+        assert_equal(spends[0]["height"], 111)
+        assert_equal(spends[0]["spending_txid"], self.send["txid"])
+        assert_equal(spends[0]["spending_vin"], 0)
+        assert_equal(spends[0]["txid"], f"{self.send['tx'].vin[0].prevout.hash:064x}")
+
+    def test_pagination(self):
+        self.log.info("Test paging through a script history with cursors")
+        node = self.nodes[0]
+        script_hex = self.wallet.get_output_script().hex()
+        full = node.getscripthistory(script_hex, 1000)
+        assert "cursor" not in full
+        # 111 coinbase outputs, plus the spend and the change output of the sending transaction
+        assert_equal(len(full["history"]), 113)
+        heights = [entry["height"] for entry in full["history"]]
+        assert_equal(heights, sorted(heights))
+
+        paged = []
+        page = node.getscripthistory(script_hex, 25)
+        while True:
+            paged += page["history"]
+            if "cursor" not in page:
+                break
+            assert_equal(len(page["history"]), 25)
+            page = node.getscripthistory(script_hex, 25, page["cursor"])
+        assert_equal(paged, full["history"])
+
+    def test_rest(self):
+        self.log.info("Test the REST endpoint")
+        node = self.nodes[0]
+        script_hex = self.wallet.get_output_script().hex()
+        status, body = self.rest_script_history(script_hex, "?count=10")
+        assert_equal(status, 200)
+        rest_page = json.loads(body, parse_float=Decimal)
+        assert_equal(rest_page, node.getscripthistory(script_hex, 10))
+
+        status, body = self.rest_script_history(script_hex, f"?count=10&cursor={rest_page['cursor']}")
+        assert_equal(status, 200)
+        assert_equal(json.loads(body, parse_float=Decimal), node.getscripthistory(script_hex, 10, rest_page["cursor"]))
+
+        status, body = self.rest_script_history(self.spk_hex)
+        assert_equal(status, 200)
+        assert_equal(len(json.loads(body)["history"]), 1)
+
+        for query, error in [
+            ("?count=0", "Entry count is invalid or out of acceptable range (1-1000): 0"),
+            ("?count=1001", "Entry count is invalid or out of acceptable range (1-1000): 1001"),
+            ("?cursor=00", "Invalid cursor: 00"),
+        ]:
+            assert_equal(self.rest_script_history(script_hex, query), (400, error + "\r\n"))
+        assert_equal(self.rest_script_history("zz"), (400, "Invalid script: zz\r\n"))
+
+    def test_reorg(self):
+        self.log.info("Test that entries of disconnected blocks are removed")
+        node = self.nodes[0]
+        node.invalidateblock(node.getblockhash(111))
+        # Mine a replacement block without the sending transaction, which is back in the mempool
+        self.generateblock(node, output=self.wallet.get_descriptor(), transactions=[])
+        assert_equal(node.getscripthistory(self.spk_hex), {"history": []})
+
+    def test_errors(self):
+        self.log.info("Test invalid arguments and a missing index")
+        node = self.nodes[0]
+        script_hex = self.wallet.get_output_script().hex()
+        assert_raises_rpc_error(-8, "scriptPubKey must be hexadecimal string", node.getscripthistory, "zz")
+        assert_raises_rpc_error(-8, "count must be between 1 and 1000", node.getscripthistory, script_hex, 0)
+        assert_raises_rpc_error(-8, "count must be between 1 and 1000", node.getscripthistory, script_hex, 1001)
+        assert_raises_rpc_error(-8, "Invalid cursor", node.getscripthistory, script_hex, 10, "00")
+
+        self.restart_node(0, extra_args=["-rest"])
+        assert_raises_rpc_error(-1, "Requires scriptindex. Start bitcoind with -scriptindex.", node.getscripthistory, script_hex)
+        assert_equal(self.rest_script_history(script_hex), (400, "Index is not enabled, start with -scriptindex\r\n"))
+
+
+if __name__ == '__main__':
+    ScriptHistoryTest(__file__).main()
@@ -200,6 +200,7 @@ BASE_SCRIPTS = [
     'wallet_createwallet.py',
     'wallet_reindex.py',
     'wallet_reorgsrestore.py',
+    'wallet_groupcommit.py',
     'interface_http.py',
     'interface_rpc.py',
     'interface_usdt_coinselection.py',
@@ -259,6 +260,7 @@ BASE_SCRIPTS = [
     'wallet_txn_clone.py --mineblock',
     'feature_notifications.py',
     'rpc_getblockfilter.py',
+    'rpc_scripthistory.py',
     'rpc_getblockfrompeer.py',
     'rpc_invalidateblock.py',
     'feature_utxo_set_hash.py',
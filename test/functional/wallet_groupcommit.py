@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test recovery of wallet writes lost to a crash with -walletgroupcommit.
+
+Writes made within the group commit window are acknowledged before they are
+durable. If the node is killed inside the window, the wallet loses them, and
+recovers the confirmed ones by rescanning the blocks after the best block it
+last saved.
+"""
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+
+
+class WalletGroupCommitTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        # Long enough for the node to be killed inside the window
+        self.extra_args = [["-walletgroupcommit=600000"]]
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_no_wallet()
+
+    def run_test(self):
+        node = self.nodes[0]
+        node.createwallet(wallet_name="group_commit", load_on_startup=True)
+        wallet = node.get_wallet_rpc("group_commit")
+        address = wallet.getnewaddress()
+
+        # Restart to ensure the node and the wallet are flushed
+        self.restart_node(0)
+        wallet = node.get_wallet_rpc("group_commit")
+        start_height = node.getblockcount()
+
+        self.log.info("Receive coins within the group commit window")
+        block_hashes = self.generatetoaddress(node, 2, address, sync_fun=self.no_op)
+        coinbase_txids = [node.getblock(block_hash)["tx"][0] for block_hash in block_hashes]
+        assert_equal(wallet.getwalletinfo()["txcount"], 2)
+        # Write the chainstate, so the blocks are still connected after the crash
+        node.gettxoutsetinfo()
+        node.syncwithvalidationinterfacequeue()
+
+        self.log.info("Kill the node inside the window, and check the wallet rescans the blocks it lost")
+        node.kill_process()
+        with node.assert_debug_log(expected_msgs=[f"Rescanning last 2 blocks (from block {start_height})..."]):
+            self.start_node(0)
+        assert_equal(node.getblockcount(), start_height + 2)
+        wallet = node.get_wallet_rpc("group_commit")
+        assert_equal(wallet.getwalletinfo()["txcount"], 2)
+        for txid, block_hash in zip(coinbase_txids, block_hashes):
+            assert_equal(wallet.gettransaction(txid)["blockhash"], block_hash)
+
+
+if __name__ == '__main__':
+    WalletGroupCommitTest(__file__).main()